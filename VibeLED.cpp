@@ -6,6 +6,11 @@
 */
 
 #include "VibeLED.h"
+#include "VibeLEDProfile.h"
+
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
 
 // Constructor for single color LEDs
 VibeLED::VibeLED(uint8_t pin, uint16_t numLeds) {
@@ -13,18 +18,59 @@ VibeLED::VibeLED(uint8_t pin, uint16_t numLeds) {
   _numLeds = numLeds;
   _numPins = 1;
   _pins = new uint8_t[1];
+  VIBELED_PROFILE_ALLOCATION(1);
   _pins[0] = pin;
 
   _ledStates = new bool[numLeds];
+  VIBELED_PROFILE_ALLOCATION(sizeof(bool) * numLeds);
   _ledColors = nullptr;
 
   _currentEffect = EFFECT_NONE;
+  _customEffect = nullptr;
+  _heat = nullptr;
   _updateInterval = 100;
   _lastUpdate = 0;
   _step = 0;
+  _pushes = 0;
+  _lastPush = 0;
 
   _groupStart = 0;
   _groupEnd = numLeds - 1;
+
+  _output = nullptr;
+
+  _powerLimit = 0;
+  _powerPerChannel = 20;
+  _powerLevel = 0;
+  _outputBrightness = 255;
+  _powerStats = PowerStats();
+
+  _ledColors16 = nullptr;
+  _ditherError = nullptr;
+  _ditherColors = nullptr;
+
+  _timebase = false;
+  _timebaseEpoch = 0;
+  _timebaseSeed = 0;
+  _timebaseStep = 0xFFFFFFFF;
+
+  _frameStats = FrameStats();
+  _governor = false;
+  _minInterval = 0;
+  _maxInterval = 0;
+  _cpuShare = 50;
+  _frameInterval = 0;
+  _stepClock = 0;
+  _pushPending = false;
+  _redraw = true;
+
+  _idleStats = IdleStats();
+  _wakeRequested = false;
+  _idleWindow = 0;
+  _idleWindowSleep = 0;
+  _idleRemainder = 0;
+
+  setOutputFormat(ORDER_RGB);
 }
 
 // Constructor for RGB LEDs
@@ -33,27 +79,80 @@ VibeLED::VibeLED(uint8_t rPin, uint8_t gPin, uint8_t bPin, uint16_t numLeds) {
   _numLeds = numLeds;
   _numPins = 3;
   _pins = new uint8_t[3];
+  VIBELED_PROFILE_ALLOCATION(3);
   _pins[0] = rPin;
   _pins[1] = gPin;
   _pins[2] = bPin;
 
   _ledStates = nullptr;
   _ledColors = new Color[numLeds];
+  VIBELED_PROFILE_ALLOCATION(sizeof(Color) * numLeds);
 
   _currentEffect = EFFECT_NONE;
+  _customEffect = nullptr;
+  _heat = nullptr;
   _updateInterval = 100;
   _lastUpdate = 0;
   _step = 0;
+  _pushes = 0;
+  _lastPush = 0;
 
   _groupStart = 0;
   _groupEnd = numLeds - 1;
+
+  _output = nullptr;
+
+  _powerLimit = 0;
+  _powerPerChannel = 20;
+  _powerLevel = 0;
+  _outputBrightness = 255;
+  _powerStats = PowerStats();
+
+  _ledColors16 = nullptr;
+  _ditherError = nullptr;
+  _ditherColors = nullptr;
+
+  _timebase = false;
+  _timebaseEpoch = 0;
+  _timebaseSeed = 0;
+  _timebaseStep = 0xFFFFFFFF;
+
+  _frameStats = FrameStats();
+  _governor = false;
+  _minInterval = 0;
+  _maxInterval = 0;
+  _cpuShare = 50;
+  _frameInterval = 0;
+  _stepClock = 0;
+  _pushPending = false;
+  _redraw = true;
+
+  _idleStats = IdleStats();
+  _wakeRequested = false;
+  _idleWindow = 0;
+  _idleWindowSleep = 0;
+  _idleRemainder = 0;
+
+  setOutputFormat(ORDER_RGB);
 }
 
 // Initialize the library
 void VibeLED::begin() {
-  // Initialize pins
-  for (uint8_t i = 0; i < _numPins; i++) {
-    pinMode(_pins[i], OUTPUT);
+  begin(nullptr, 0);
+}
+
+// Initialize the library and resume from a snapshot (see saveSnapshot()),
+// showing the restored frame instead of a dark strip. Returns false, and
+// starts dark as begin() does, if the snapshot is missing, invalid or from
+// another strip.
+bool VibeLED::begin(const uint8_t* snapshot, uint32_t size) {
+  // Initialize pins (an attached output driver manages its own pins)
+  if (_output != nullptr) {
+    _output->begin(*this);
+  } else {
+    for (uint8_t i = 0; i < _numPins; i++) {
+      pinMode(_pins[i], OUTPUT);
+    }
   }
 
   // Initialize LED states
@@ -64,22 +163,312 @@ void VibeLED::begin() {
   } else {
     for (uint16_t i = 0; i < _numLeds; i++) {
       _ledColors[i] = Color(0, 0, 0);
+      if (_ledColors16 != nullptr) {
+        _ledColors16[i] = Color16();
+      }
     }
   }
+  _powerLevel = 0;
+  _redraw = true;
+
+  bool restored = (snapshot != nullptr) && restoreSnapshot(snapshot, size);
 
   // Apply initial states
   _applyStates();
+  return restored;
+}
+
+// Snapshot layout (version 1, little endian):
+//   "VLS", version, LED type, LEDs (2), flags (bit 0 timebase, bit 1 fire heat),
+//   effect, params (speed 2, brightness, colors 9, options 2), delay (2),
+//   step (2), group start (2), group end (2), timebase epoch (4), seed (4),
+//   LEDs (3 bytes each, or 1 bit each for single color LEDs),
+//   fire heat (1 byte per LED, if present), Fletcher-16 of everything before
+#define VIBELED_SNAPSHOT_VERSION 1
+#define VIBELED_SNAPSHOT_HEADER 39
+
+// Bytes needed by saveSnapshot() for the current state
+uint32_t VibeLED::getSnapshotSize() {
+  uint32_t size = VIBELED_SNAPSHOT_HEADER + 2;
+  size += (_ledType == LED_TYPE_RGB) ? (uint32_t)_numLeds * 3 : (_numLeds + 7) / 8;
+  if (_heat != nullptr) size += _numLeds;
+  return size;
+}
+
+// Write the effect state to a buffer of getSnapshotSize() bytes, e.g. to
+// store it in EEPROM or flash; returns the bytes written (0 if too small).
+// Only effect state is saved: effect, parameters, step and timebase, group,
+// the LEDs and the fire heat map. Settings such as the power limit, the
+// frame rate and the output format are left to the sketch.
+uint32_t VibeLED::saveSnapshot(uint8_t* out, uint32_t size) {
+  uint32_t length = getSnapshotSize();
+  if (out == nullptr || size < length) return 0;
+
+  uint8_t* start = out;
+  *out++ = 'V';
+  *out++ = 'L';
+  *out++ = 'S';
+  _writeValue(out, VIBELED_SNAPSHOT_VERSION, 1);
+  _writeValue(out, _ledType, 1);
+  _writeValue(out, _numLeds, 2);
+  _writeValue(out, (_timebase ? 0x01 : 0) | (_heat != nullptr ? 0x02 : 0), 1);
+  _writeValue(out, _currentEffect, 1);
+
+  _writeValue(out, _effectParams.speed, 2);
+  _writeValue(out, _effectParams.brightness, 1);
+  const Color* colors[3] = { &_effectParams.color1, &_effectParams.color2, &_effectParams.color3 };
+  for (uint8_t c = 0; c < 3; c++) {
+    *out++ = colors[c]->r;
+    *out++ = colors[c]->g;
+    *out++ = colors[c]->b;
+  }
+  _writeValue(out, _effectParams.option1, 1);
+  _writeValue(out, _effectParams.option2, 1);
+
+  _writeValue(out, _updateInterval, 2);
+  _writeValue(out, _step, 2);
+  _writeValue(out, _groupStart, 2);
+  _writeValue(out, _groupEnd, 2);
+  _writeValue(out, _timebaseEpoch, 4);
+  _writeValue(out, _timebaseSeed, 4);
+
+  if (_ledType == LED_TYPE_RGB) {
+    memcpy(out, _ledColors, (uint32_t)_numLeds * 3);
+    out += (uint32_t)_numLeds * 3;
+  } else {
+    memset(out, 0, (_numLeds + 7) / 8);
+    for (uint16_t i = 0; i < _numLeds; i++) {
+      out[i >> 3] |= (uint8_t)_ledStates[i] << (i & 7);
+    }
+    out += (_numLeds + 7) / 8;
+  }
+  if (_heat != nullptr) {
+    memcpy(out, _heat, _numLeds);
+    out += _numLeds;
+  }
+
+  _writeValue(out, _fletcher16(start, out - start), 2);
+  return length;
+}
+
+// Restore the effect state written by saveSnapshot(). The snapshot must
+// come from a strip of the same type and length and pass its checksum;
+// otherwise nothing changes and false is returned. Effects continue from
+// the saved step; the next frame is due one effect delay from now.
+bool VibeLED::restoreSnapshot(const uint8_t* snapshot, uint32_t size) {
+  if (snapshot == nullptr || size < VIBELED_SNAPSHOT_HEADER + 2) return false;
+
+  const uint8_t* in = snapshot;
+  if (in[0] != 'V' || in[1] != 'L' || in[2] != 'S') return false;
+  in += 3;
+  if (_readValue(in, 1) != VIBELED_SNAPSHOT_VERSION) return false;
+  if (_readValue(in, 1) != _ledType || _readValue(in, 2) != _numLeds) return false;
+  uint8_t flags = _readValue(in, 1);
+
+  uint32_t length = VIBELED_SNAPSHOT_HEADER + 2;
+  length += (_ledType == LED_TYPE_RGB) ? (uint32_t)_numLeds * 3 : (_numLeds + 7) / 8;
+  if (flags & 0x02) length += _numLeds;
+  if (size < length) return false;
+  const uint8_t* check = snapshot + length - 2;
+  if (_fletcher16(snapshot, length - 2) != (uint16_t)_readValue(check, 2)) return false;
+
+  EffectType effect = (EffectType)_readValue(in, 1);
+  if (effect == EFFECT_CUSTOM && _customEffect == nullptr) {
+    effect = EFFECT_NONE;
+  }
+  _currentEffect = effect;
+
+  _effectParams.speed = _readValue(in, 2);
+  _effectParams.brightness = _readValue(in, 1);
+  Color* colors[3] = { &_effectParams.color1, &_effectParams.color2, &_effectParams.color3 };
+  for (uint8_t c = 0; c < 3; c++) {
+    colors[c]->r = *in++;
+    colors[c]->g = *in++;
+    colors[c]->b = *in++;
+  }
+  _effectParams.option1 = _readValue(in, 1);
+  _effectParams.option2 = _readValue(in, 1);
+
+  _updateInterval = _readValue(in, 2);
+  _step = _readValue(in, 2);
+  uint16_t groupStart = _readValue(in, 2);
+  uint16_t groupEnd = _readValue(in, 2);
+  setGroup(groupStart, groupEnd);
+  unsigned long epoch = _readValue(in, 4);
+  uint32_t seed = _readValue(in, 4);
+  if (flags & 0x01) {
+    setTimebase(epoch, seed);
+  } else {
+    _timebase = false;
+    _timebaseEpoch = epoch;
+    _timebaseSeed = seed;
+  }
+
+  if (_ledType == LED_TYPE_RGB) {
+    memcpy(_ledColors, in, (uint32_t)_numLeds * 3);
+    in += (uint32_t)_numLeds * 3;
+    if (_ledColors16 != nullptr) {
+      // Dithering starts over from the 8-bit colors
+      for (uint16_t i = 0; i < _numLeds; i++) {
+        _ledColors16[i] = Color16(_ledColors[i]);
+      }
+      memset(_ditherError, 0, (uint32_t)_numLeds * 3);
+      _ditherFrame();
+    }
+  } else {
+    for (uint16_t i = 0; i < _numLeds; i++) {
+      _ledStates[i] = (in[i >> 3] >> (i & 7)) & 1;
+    }
+    in += (_numLeds + 7) / 8;
+  }
+
+  if (flags & 0x02) {
+    if (_heat == nullptr) {
+      _heat = new uint8_t[_numLeds];
+      VIBELED_PROFILE_ALLOCATION(_numLeds);
+    }
+    memcpy(_heat, in, _numLeds);
+  }
+
+  _powerLevel = (_powerLimit > 0) ? _powerSum(0, _numLeds - 1) : 0;
+  _lastUpdate = millis();
+  _stepClock = _lastUpdate;
+  _pushPending = false;
+  _redraw = true;
+  return true;
 }
 
 // Update the effect (should be called in loop())
 void VibeLED::update() {
-  if (millis() - _lastUpdate >= _updateInterval) {
-    _lastUpdate = millis();
+  update(millis());
+}
+
+// Update the effect at an explicit time in milliseconds (e.g. a shared clock)
+void VibeLED::update(unsigned long now) {
+  if (_frameDue(now)) {
+    unsigned long start = micros();
     _updateEffect();
+    _recordRender(start);
+    _applyStates();
+  } else if (_pushPending) {
+    _pushPending = false;
     _applyStates();
   }
 }
 
+// Render the next frame if it is due, without pushing it to the outputs.
+// Used by pipelined output (VibeLEDPipeline); returns true if a frame was rendered.
+bool VibeLED::render(unsigned long now) {
+  if (!_frameDue(now)) return false;
+
+  unsigned long start = micros();
+  _updateEffect();
+  _recordRender(start);
+  _limitPower();
+  _ditherFrame();
+
+  // The frame is pushed elsewhere, so only the render time counts
+  _recordOutput(micros());
+  _recordPush();
+  return true;
+}
+
+// Channel order and white extraction of encoded frames. Effects keep
+// drawing RGB; the conversion happens in the same pass as the brightness
+// scaling, so RGBW and reordered strips cost no extra pass over the frame.
+// whiteColor is the color of the white LED as seen through the RGB LEDs,
+// e.g. Color(255, 190, 120) for a warm white; WHITE_MIN assumes pure white.
+void VibeLED::setOutputFormat(ColorOrder order, WhiteMode white, Color whiteColor) {
+  // Byte of R, G and B for each order
+  static const uint8_t offsets[] PROGMEM = {
+    0, 1, 2,   // RGB
+    0, 2, 1,   // RBG
+    1, 0, 2,   // GRB
+    2, 0, 1,   // GBR
+    1, 2, 0,   // BRG
+    2, 1, 0    // BGR
+  };
+
+  uint8_t index = (order <= ORDER_BGR) ? order * 3 : 0;
+  for (uint8_t c = 0; c < 3; c++) {
+    _channelOffset[c] = pgm_read_byte(offsets + index + c);
+  }
+  _channelOffset[3] = 3;  // White always comes last
+
+  _whiteMode = (white <= WHITE_CALIBRATED) ? white : WHITE_NONE;
+  _bytesPerLed = (_whiteMode == WHITE_NONE) ? 3 : 4;
+
+  // The most white a channel allows is value * 255 / channel, rounded
+  // down so the white part never exceeds the color. The scale is rounded
+  // up, which makes (value * scale) >> 16 exact for all 8-bit values.
+  // Channels the white LED does not light allow any amount.
+  uint8_t channels[3] = { whiteColor.r, whiteColor.g, whiteColor.b };
+  for (uint8_t c = 0; c < 3; c++) {
+    uint8_t channel = channels[c] ? channels[c] : 1;
+    _whiteColor[c] = channels[c];
+    _whiteScale[c] = ((255UL << 16) + channel - 1) / channel;
+    _whiteMask[c] = channels[c] ? 0 : 0xFF;
+  }
+}
+
+// Bytes per LED written by encode()
+uint8_t VibeLED::getBytesPerLed() {
+  return _bytesPerLed;
+}
+
+// Write the output colors of all LEDs into a frame buffer of
+// getBytesPerLed() bytes per LED (single color LEDs as 0 or full white)
+void VibeLED::encode(uint8_t* out) {
+  encode(out, 0, _numLeds);
+}
+
+// Write the output colors of count LEDs starting at first
+void VibeLED::encode(uint8_t* out, uint16_t first, uint16_t count) {
+  if (first >= _numLeds) return;
+  if (count > _numLeds - first) count = _numLeds - first;
+
+  uint8_t r = _channelOffset[0];
+  uint8_t g = _channelOffset[1];
+  uint8_t b = _channelOffset[2];
+  uint8_t w = _channelOffset[3];
+
+  for (uint16_t i = first; i < first + count; i++) {
+    Color color;
+    if (_ledType == LED_TYPE_RGB) {
+      color = getOutputColor(i);
+    } else {
+      color = _ledStates[i] ? Color(255, 255, 255) : Color(0, 0, 0);
+    }
+
+    if (_whiteMode == WHITE_MIN) {
+      // The part common to all three channels
+      uint8_t white = _lower(_lower(color.r, color.g), color.b);
+      color.r -= white;
+      color.g -= white;
+      color.b -= white;
+      out[w] = white;
+    } else if (_whiteMode == WHITE_CALIBRATED) {
+      // As much white as every channel allows, then take away what the
+      // white LED adds to each channel (x / 255 as (x + 1 + (x >> 8)) >> 8)
+      uint16_t white = _lower(_lower(255, ((color.r | _whiteMask[0]) * _whiteScale[0]) >> 16),
+                              _lower(((color.g | _whiteMask[1]) * _whiteScale[1]) >> 16,
+                                     ((color.b | _whiteMask[2]) * _whiteScale[2]) >> 16));
+      uint16_t red = white * _whiteColor[0];
+      uint16_t green = white * _whiteColor[1];
+      uint16_t blue = white * _whiteColor[2];
+      color.r -= (red + 1 + (red >> 8)) >> 8;
+      color.g -= (green + 1 + (green >> 8)) >> 8;
+      color.b -= (blue + 1 + (blue >> 8)) >> 8;
+      out[w] = white;
+    }
+
+    out[r] = color.r;
+    out[g] = color.g;
+    out[b] = color.b;
+    out += _bytesPerLed;
+  }
+}
+
 // Clear all LEDs
 void VibeLED::clear() {
   if (_ledType == LED_TYPE_SINGLE) {
@@ -89,14 +478,195 @@ void VibeLED::clear() {
   } else {
     for (uint16_t i = 0; i < _numLeds; i++) {
       _ledColors[i] = Color(0, 0, 0);
+      if (_ledColors16 != nullptr) {
+        _ledColors16[i] = Color16();
+      }
     }
   }
+  _powerLevel = 0;
+  _redraw = true;
   _applyStates();
 }
 
 // Set brightness (only affects RGB LEDs)
 void VibeLED::setBrightness(uint8_t brightness) {
   _effectParams.brightness = brightness;
+  _redraw = true;
+}
+
+// Enable the 16-bit working buffer with temporal dithering (RGB only)
+void VibeLED::setHighPrecision(bool enable) {
+  if (_ledType != LED_TYPE_RGB) return;
+  _redraw = true;
+
+  if (enable && _ledColors16 == nullptr) {
+    _ledColors16 = new Color16[_numLeds];
+    _ditherError = new uint8_t[(uint32_t)_numLeds * 3];
+    _ditherColors = new Color[_numLeds];
+    VIBELED_PROFILE_ALLOCATION(sizeof(Color16) * _numLeds);
+    VIBELED_PROFILE_ALLOCATION((uint32_t)_numLeds * 3);
+    VIBELED_PROFILE_ALLOCATION(sizeof(Color) * _numLeds);
+    for (uint16_t i = 0; i < _numLeds; i++) {
+      _ledColors16[i] = Color16(_ledColors[i]);
+    }
+    for (uint32_t i = 0; i < (uint32_t)_numLeds * 3; i++) {
+      _ditherError[i] = 0;
+    }
+    _ditherFrame();
+  } else if (!enable && _ledColors16 != nullptr) {
+    delete[] _ledColors16;
+    delete[] _ditherError;
+    delete[] _ditherColors;
+    _ledColors16 = nullptr;
+    _ditherError = nullptr;
+    _ditherColors = nullptr;
+  }
+}
+
+// Limit the estimated supply current (0 disables the limiter)
+void VibeLED::setPowerLimit(uint16_t milliamps, uint8_t milliampsPerChannel) {
+  _powerLimit = milliamps;
+  _powerPerChannel = milliampsPerChannel;
+  _redraw = true;
+
+  // The running total is only maintained while the limiter is on,
+  // so take one full sum when it is switched on
+  _powerLevel = (_powerLimit > 0) ? _powerSum(0, _numLeds - 1) : 0;
+}
+
+// Get power limiter statistics
+PowerStats VibeLED::getPowerStats() {
+  return _powerStats;
+}
+
+// Let the frame rate follow the measured render and output cost: the
+// governor picks the highest rate in [minFps, maxFps] that keeps rendering
+// and pushing at or below cpuShare percent of the time. The effect step
+// follows the clock, so effects keep their speed at any frame rate; frames
+// faster than the effect delay show nothing new unless high precision is on.
+void VibeLED::setFrameRate(uint16_t minFps, uint16_t maxFps, uint8_t cpuShare) {
+  minFps = constrain(minFps, 1, 1000);
+  maxFps = constrain(maxFps, minFps, 1000);
+  _minInterval = 1000 / maxFps;
+  _maxInterval = 1000 / minFps;
+  _cpuShare = constrain(cpuShare, 1, 100);
+
+  if (!_governor) {
+    _frameInterval = constrain(_updateInterval, _minInterval, _maxInterval);
+    _stepClock = _lastUpdate;
+  }
+  _governor = true;
+}
+
+// Return to one frame per effect step
+void VibeLED::resetFrameRate() {
+  _governor = false;
+  _pushPending = false;
+}
+
+// Get frame timing statistics
+FrameStats VibeLED::getFrameStats() {
+  return _frameStats;
+}
+
+// Time in ms until update() renders the next frame (0 when one is due)
+unsigned long VibeLED::getTimeToNextFrame() {
+  return getTimeToNextFrame(millis());
+}
+
+// Time until the next frame at an explicit time in milliseconds
+unsigned long VibeLED::getTimeToNextFrame(unsigned long now) {
+  if (_pushPending) return 0;
+
+  if (_timebase) {
+    long elapsed = (long)(now - _timebaseEpoch);
+    if (elapsed < 0) return -elapsed;
+
+    uint16_t interval = max(_updateInterval, 1);
+    if ((uint32_t)elapsed / interval != _timebaseStep) return 0;
+    return interval - (uint32_t)elapsed % interval;
+  }
+
+  unsigned long due = _lastUpdate + (_governor ? _frameInterval : _updateInterval);
+  if (_governor && _ledColors16 == nullptr) {
+    // Frames without a new effect step are not rendered
+    unsigned long stepDue = _stepClock + max(_updateInterval, 1);
+    if ((long)(stepDue - due) > 0) due = stepDue;
+  }
+
+  long remaining = (long)(due - now);
+  return (remaining > 0) ? remaining : 0;
+}
+
+// Whether the next frame would be the same as the last one: a still effect
+// (none, static, gradient, or a completed fade) whose frame has been shown
+// with the current settings. Temporal dithering changes every frame, so
+// frames are never static in high precision mode.
+bool VibeLED::isStatic() {
+  if (_redraw || _pushPending || _ledColors16 != nullptr) return false;
+
+  switch (_currentEffect) {
+    case EFFECT_NONE:
+    case EFFECT_STATIC:
+    case EFFECT_GRADIENT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Sleep until the next frame is due, wake() is called or maxMs have passed,
+// whichever comes first. Static frames do not need a next frame, so they
+// sleep until wake() or maxMs. The MCU is put in its idle sleep mode, which
+// the timer interrupt behind millis() ends about once per millisecond.
+// Returns the time slept in ms.
+unsigned long VibeLED::sleepUntilNextFrame(unsigned long maxMs) {
+  unsigned long start = millis();
+  unsigned long wait = isStatic() ? maxMs : min(getTimeToNextFrame(start), maxMs);
+  unsigned long sleepStart = micros();
+
+  bool woken = false;
+  while (millis() - start < wait) {
+    if (_wakeRequested) {
+      woken = true;
+      break;
+    }
+    _idle();
+  }
+  _wakeRequested = false;
+
+  // Awake time is everything between the sleeps, counted per window of at
+  // least one second
+  unsigned long end = micros();
+  uint32_t slept = end - sleepStart;
+  if (slept > 0) {
+    _idleStats.sleeps++;
+    if (woken) _idleStats.wakes++;
+    uint32_t total = slept + _idleRemainder;
+    _idleStats.sleepTime += total / 1000;
+    _idleRemainder = total % 1000;
+  }
+
+  _idleWindowSleep += slept;
+  uint32_t window = end - _idleWindow;
+  if (window >= 1000000UL) {
+    uint32_t awake = (_idleWindowSleep < window) ? window - _idleWindowSleep : 0;
+    _idleStats.awakeTime = ((uint64_t)awake * 1000000) / window;
+    _idleWindow = end;
+    _idleWindowSleep = 0;
+  }
+
+  return millis() - start;
+}
+
+// End sleepUntilNextFrame() early; safe to call from an interrupt
+void VibeLED::wake() {
+  _wakeRequested = true;
+}
+
+// Get idle statistics
+IdleStats VibeLED::getIdleStats() {
+  return _idleStats;
 }
 
 // Set delay between effect updates
@@ -107,17 +677,20 @@ void VibeLED::setDelay(uint16_t ms) {
 // Set color (RGB)
 void VibeLED::setColor(uint8_t r, uint8_t g, uint8_t b) {
   _effectParams.color1 = Color(r, g, b);
+  _redraw = true;
 }
 
 // Set color (Color struct)
 void VibeLED::setColor(Color color) {
   _effectParams.color1 = color;
+  _redraw = true;
 }
 
 // Set effect by type
 void VibeLED::setEffect(EffectType effect) {
   _currentEffect = effect;
   _step = 0;
+  _redraw = true;
 }
 
 // Set effect with parameters
@@ -126,6 +699,7 @@ void VibeLED::setEffect(EffectType effect, EffectParams params) {
   _effectParams = params;
   _updateInterval = params.speed;
   _step = 0;
+  _redraw = true;
 }
 
 // Set effect with speed
@@ -134,6 +708,7 @@ void VibeLED::setEffect(EffectType effect, uint16_t speed) {
   _effectParams.speed = speed;
   _updateInterval = speed;
   _step = 0;
+  _redraw = true;
 }
 
 // Set effect with speed and color
@@ -143,6 +718,7 @@ void VibeLED::setEffect(EffectType effect, uint16_t speed, Color color) {
   _effectParams.color1 = color;
   _updateInterval = speed;
   _step = 0;
+  _redraw = true;
 }
 
 // Set effect with speed and RGB color
@@ -152,154 +728,703 @@ void VibeLED::setEffect(EffectType effect, uint16_t speed, uint8_t r, uint8_t g,
   _effectParams.color1 = Color(r, g, b);
   _updateInterval = speed;
   _step = 0;
+  _redraw = true;
+}
+
+// Effect names for setEffect(name), kept in flash: each entry is the
+// effect ID, the name and a terminating zero. Only compiled effects are
+// listed; 0xFF ends the table.
+static const char _effectNames[] PROGMEM =
+  "\x00" "none\0"
+#ifdef VIBELED_USE_STATIC
+  "\x01" "static\0"
+#endif
+#ifdef VIBELED_USE_BLINK
+  "\x02" "blink\0"
+#endif
+#ifdef VIBELED_USE_BREATHE
+  "\x03" "breathe\0"
+#endif
+#ifdef VIBELED_USE_PULSE
+  "\x04" "pulse\0"
+#endif
+#ifdef VIBELED_USE_FADE_IN
+  "\x05" "fade_in\0"
+#endif
+#ifdef VIBELED_USE_FADE_OUT
+  "\x06" "fade_out\0"
+#endif
+#ifdef VIBELED_USE_KNIGHT_RIDER
+  "\x07" "knight_rider\0"
+#endif
+#ifdef VIBELED_USE_CYLON
+  "\x08" "cylon\0"
+#endif
+#ifdef VIBELED_USE_METEOR
+  "\x09" "meteor\0"
+#endif
+#ifdef VIBELED_USE_FIRE
+  "\x0A" "fire\0"
+#endif
+#ifdef VIBELED_USE_WATERFALL
+  "\x0B" "waterfall\0"
+#endif
+#ifdef VIBELED_USE_CHASE
+  "\x0C" "chase\0"
+#endif
+#ifdef VIBELED_USE_STACK
+  "\x0D" "stack\0"
+#endif
+#ifdef VIBELED_USE_RAINBOW
+  "\x0E" "rainbow\0"
+#endif
+#ifdef VIBELED_USE_SPARKLE
+  "\x0F" "sparkle\0"
+#endif
+#ifdef VIBELED_USE_MARQUEE
+  "\x10" "marquee\0"
+#endif
+#ifdef VIBELED_USE_BOUNCE
+  "\x11" "bounce\0"
+#endif
+#ifdef VIBELED_USE_COLOR_WIPE
+  "\x12" "color_wipe\0"
+#endif
+#ifdef VIBELED_USE_RANDOM_BLINK
+  "\x13" "random_blink\0"
+#endif
+#ifdef VIBELED_USE_SNAKE
+  "\x14" "snake\0"
+#endif
+#ifdef VIBELED_USE_WAVE
+  "\x15" "wave\0"
+#endif
+#ifdef VIBELED_USE_TWINKLE
+  "\x16" "twinkle\0"
+#endif
+#ifdef VIBELED_USE_FIRE_FLICKER_SOFT
+  "\x32" "fire_flicker_soft\0"
+#endif
+#ifdef VIBELED_USE_GRADIENT
+  "\x1A" "gradient\0"
+#endif
+  "\xFF";
+
+// Set effect by name (case insensitive; unknown names select EFFECT_NONE)
+void VibeLED::setEffect(const char* effectName) {
+  const char* entry = _effectNames;
+  uint8_t effect;
+
+  while ((effect = pgm_read_byte(entry++)) != 0xFF) {
+    const char* name = effectName;
+    char c = pgm_read_byte(entry);
+    while (c != 0 && ((*name >= 'A' && *name <= 'Z') ? *name + ('a' - 'A') : *name) == c) {
+      name++;
+      c = pgm_read_byte(++entry);
+    }
+    if (c == 0 && *name == 0) {
+      setEffect((EffectType)effect);
+      return;
+    }
+
+    // Skip to the next entry
+    while (pgm_read_byte(entry++) != 0) {}
+  }
+
+  setEffect(EFFECT_NONE);
 }
 
 // Set effect by name
 void VibeLED::setEffect(String effectName) {
-  // Convert string to effect type
-  if (effectName.equalsIgnoreCase("static")) setEffect(EFFECT_STATIC);
-  else if (effectName.equalsIgnoreCase("blink")) setEffect(EFFECT_BLINK);
-  else if (effectName.equalsIgnoreCase("breathe")) setEffect(EFFECT_BREATHE);
-  else if (effectName.equalsIgnoreCase("pulse")) setEffect(EFFECT_PULSE);
-  else if (effectName.equalsIgnoreCase("fade_in")) setEffect(EFFECT_FADE_IN);
-  else if (effectName.equalsIgnoreCase("fade_out")) setEffect(EFFECT_FADE_OUT);
-  else if (effectName.equalsIgnoreCase("knight_rider")) setEffect(EFFECT_KNIGHT_RIDER);
-  else if (effectName.equalsIgnoreCase("cylon")) setEffect(EFFECT_CYLON);
-  else if (effectName.equalsIgnoreCase("meteor")) setEffect(EFFECT_METEOR);
-  else if (effectName.equalsIgnoreCase("fire")) setEffect(EFFECT_FIRE);
-  else if (effectName.equalsIgnoreCase("waterfall")) setEffect(EFFECT_WATERFALL);
-  else if (effectName.equalsIgnoreCase("chase")) setEffect(EFFECT_CHASE);
-  else if (effectName.equalsIgnoreCase("stack")) setEffect(EFFECT_STACK);
-  else if (effectName.equalsIgnoreCase("rainbow")) setEffect(EFFECT_RAINBOW);
-  else if (effectName.equalsIgnoreCase("sparkle")) setEffect(EFFECT_SPARKLE);
-  else if (effectName.equalsIgnoreCase("marquee")) setEffect(EFFECT_MARQUEE);
-  else if (effectName.equalsIgnoreCase("bounce")) setEffect(EFFECT_BOUNCE);
-  else if (effectName.equalsIgnoreCase("color_wipe")) setEffect(EFFECT_COLOR_WIPE);
-  else if (effectName.equalsIgnoreCase("random_blink")) setEffect(EFFECT_RANDOM_BLINK);
-  else if (effectName.equalsIgnoreCase("snake")) setEffect(EFFECT_SNAKE);
-  else if (effectName.equalsIgnoreCase("wave")) setEffect(EFFECT_WAVE);
-  else setEffect(EFFECT_NONE);
+  setEffect(effectName.c_str());
+}
+
+// Run an external effect (EFFECT_CUSTOM) with the current parameters
+void VibeLED::setCustomEffect(VibeLEDEffect* effect) {
+  _customEffect = effect;
+  _currentEffect = (effect != nullptr) ? EFFECT_CUSTOM : EFFECT_NONE;
+  _step = 0;
+  _redraw = true;
+}
+
+// Set effect parameters without restarting the current effect
+void VibeLED::setParams(EffectParams params) {
+  _effectParams = params;
+  _updateInterval = params.speed;
+  _redraw = true;
+}
+
+// Get the current effect parameters
+EffectParams VibeLED::getParams() {
+  return _effectParams;
+}
+
+// Derive the effect step from a shared clock: step = (time - epoch) / delay.
+// Random effects are reseeded from the seed and step on every frame.
+void VibeLED::setTimebase(unsigned long epoch, uint32_t seed) {
+  _timebase = true;
+  _timebaseEpoch = epoch;
+  _timebaseSeed = seed;
+  _timebaseStep = 0xFFFFFFFF;
+  _redraw = true;
+#ifdef VIBELED_USE_NOISE
+  _noise.setSeed(seed);
+#endif
+}
+
+// Return to free-running updates
+void VibeLED::resetTimebase() {
+  _timebase = false;
+  _redraw = true;
 }
 
 // Set group of LEDs to control
 void VibeLED::setGroup(uint16_t startLed, uint16_t endLed) {
   _groupStart = constrain(startLed, 0, _numLeds - 1);
   _groupEnd = constrain(endLed, _groupStart, _numLeds - 1);
+  _redraw = true;
 }
 
 // Reset group to all LEDs
 void VibeLED::resetGroup() {
   _groupStart = 0;
   _groupEnd = _numLeds - 1;
+  _redraw = true;
 }
 
 // Set single LED state (for single color LEDs)
 void VibeLED::setLED(uint16_t led, bool state) {
   if (_ledType == LED_TYPE_SINGLE && led < _numLeds) {
-    _ledStates[led] = state;
+    _setState(led, state);
   }
 }
 
 // Set single LED color (for RGB LEDs)
 void VibeLED::setLED(uint16_t led, uint8_t r, uint8_t g, uint8_t b) {
   if (_ledType == LED_TYPE_RGB && led < _numLeds) {
-    _ledColors[led] = Color(r, g, b);
+    _setColor(led, Color(r, g, b));
   }
 }
 
 // Set single LED color (for RGB LEDs)
 void VibeLED::setLED(uint16_t led, Color color) {
   if (_ledType == LED_TYPE_RGB && led < _numLeds) {
-    _ledColors[led] = color;
+    _setColor(led, color);
+  }
+}
+
+// Set a range of LEDs on or off (for single color LEDs)
+void VibeLED::fillLEDs(uint16_t first, uint16_t last, bool state) {
+  if (_ledType != LED_TYPE_SINGLE || first >= _numLeds || last < first) return;
+  _fillStates(first, min(last, (uint16_t)(_numLeds - 1)), state);
+}
+
+// Set a range of LEDs to one color (for RGB LEDs)
+void VibeLED::fillLEDs(uint16_t first, uint16_t last, Color color) {
+  if (_ledType != LED_TYPE_RGB || first >= _numLeds || last < first) return;
+  _fillColors(first, min(last, (uint16_t)(_numLeds - 1)), color);
+}
+
+// Copy count LEDs from one position to another; the ranges may overlap
+void VibeLED::copyLEDs(uint16_t to, uint16_t from, uint16_t count) {
+  if (to >= _numLeds || from >= _numLeds) return;
+  count = min(count, (uint16_t)(_numLeds - max(to, from)));
+  if (count == 0 || to == from) return;
+  _moveLEDs(to, from, count);
+}
+
+// Set count LEDs from packed RGB bytes (3 per LED, as written by encode()).
+// Single color LEDs are turned on for any non-black color.
+void VibeLED::writeLEDs(uint16_t first, const uint8_t* rgb, uint16_t count) {
+  if (first >= _numLeds) return;
+  count = min(count, (uint16_t)(_numLeds - first));
+  if (count == 0) return;
+  uint16_t last = first + count - 1;
+
+  uint32_t before = (_powerLimit > 0) ? _powerSum(first, last) : 0;
+
+  if (_ledType == LED_TYPE_SINGLE) {
+    for (uint16_t i = first; i <= last; i++) {
+      _ledStates[i] = (rgb[0] | rgb[1] | rgb[2]) != 0;
+      rgb += 3;
+    }
+  } else {
+    for (uint16_t i = first; i <= last; i++) {
+      _ledColors[i] = Color(rgb[0], rgb[1], rgb[2]);
+      rgb += 3;
+    }
+    if (_ledColors16 != nullptr) {
+      for (uint16_t i = first; i <= last; i++) {
+        _ledColors16[i] = Color16(_ledColors[i]);
+      }
+    }
+  }
+
+  if (_powerLimit > 0) {
+    _powerLevel += _powerSum(first, last) - before;
+  }
+}
+
+// Fill a range with a linear gradient (for RGB LEDs)
+void VibeLED::fillGradient(uint16_t first, uint16_t last, Color from, Color to) {
+  if (_ledType != LED_TYPE_RGB || first >= _numLeds || last < first) return;
+  _gradient(first, last, from, to, first, min(last, (uint16_t)(_numLeds - 1)));
+}
+
+// Fill a range with a gradient through evenly spaced color stops (for RGB LEDs)
+void VibeLED::fillGradient(uint16_t first, uint16_t last, const Color* stops, uint8_t numStops) {
+  if (_ledType != LED_TYPE_RGB || numStops == 0 || first >= _numLeds || last < first) return;
+  uint16_t end = min(last, (uint16_t)(_numLeds - 1));
+
+  if (numStops == 1) {
+    _fillColors(first, end, stops[0]);
+    return;
+  }
+
+  // Neighbouring segments share their end LED; the later one writes it
+  uint16_t span = last - first;
+  for (uint8_t s = 0; s + 1 < numStops; s++) {
+    uint16_t start = first + (uint32_t)span * s / (numStops - 1);
+    uint16_t stop = first + (uint32_t)span * (s + 1) / (numStops - 1);
+    if (start > end) break;
+    _gradient(start, stop, stops[s], stops[s + 1], start, min(stop, end));
+  }
+}
+
+// Attach an output driver (nullptr restores the built-in pin output)
+void VibeLED::setOutput(VibeLEDOutput* output) {
+  _output = output;
+  _redraw = true;
+}
+
+// Push the current LED states to the outputs without advancing the effect
+void VibeLED::show() {
+  _applyStates();
+}
+
+// Render and push a frame immediately, restarting the update interval
+void VibeLED::refresh() {
+  refresh(millis());
+}
+
+// Render and push a frame immediately at an explicit time in milliseconds
+void VibeLED::refresh(unsigned long now) {
+  if (_timebase) {
+    // Render the frame for the current timebase step
+    _timebaseStep = 0xFFFFFFFF;
+    update(now);
+    return;
+  }
+
+  _lastUpdate = now;
+  _updateEffect();
+  _applyStates();
+}
+
+// Get the LED type (LED_TYPE_SINGLE or LED_TYPE_RGB)
+uint8_t VibeLED::getLEDType() {
+  return _ledType;
+}
+
+// Get the number of LEDs
+uint16_t VibeLED::getNumLeds() {
+  return _numLeds;
+}
+
+// Get the current effect
+EffectType VibeLED::getEffect() {
+  return _currentEffect;
+}
+
+// Number of frames pushed to the outputs so far (frames rendered for a
+// pipeline count when they are rendered)
+uint32_t VibeLED::getPushCount() {
+  return _pushes;
+}
+
+// micros() when the last frame was pushed to the outputs (or rendered)
+unsigned long VibeLED::getLastPushTime() {
+  return _lastPush;
+}
+
+// Get the brightness level
+uint8_t VibeLED::getBrightness() {
+  return _effectParams.brightness;
+}
+
+// Get the brightness actually sent to the outputs (after power limiting)
+uint8_t VibeLED::getOutputBrightness() {
+  return _outputBrightness;
+}
+
+// Get the final color for one LED as it should be sent to the hardware:
+// brightness and power limiting applied. In high precision mode this is
+// the temporally dithered color of the last frame pushed or rendered, so
+// it can be read any number of times per frame.
+Color VibeLED::getOutputColor(uint16_t led) {
+  if (_ledType != LED_TYPE_RGB || led >= _numLeds) {
+    return Color(0, 0, 0);
+  }
+
+  if (_ditherColors != nullptr) {
+    return _ditherColors[led];
+  }
+
+  uint16_t scale = _outputBrightness + 1;
+  Color color = _ledColors[led];
+  return Color((color.r * scale) >> 8, (color.g * scale) >> 8, (color.b * scale) >> 8);
+}
+
+// Convert a hue (0-255) to a fully saturated RGB color (simplified HSV)
+Color VibeLED::hueToColor(uint8_t hue) {
+  uint8_t region = hue / 43;
+  uint8_t remainder = (hue - (region * 43)) * 6;
+
+  uint8_t p = 0;
+  uint8_t q = 255 - remainder;
+  uint8_t t = remainder;
+
+  switch (region) {
+    case 0: return Color(255, t, p);
+    case 1: return Color(q, 255, p);
+    case 2: return Color(p, 255, t);
+    case 3: return Color(p, q, 255);
+    case 4: return Color(t, p, 255);
+    default: return Color(255, p, q);
+  }
+}
+
+// Get single LED state (for single color LEDs)
+bool VibeLED::getLEDState(uint16_t led) {
+  if (_ledType == LED_TYPE_SINGLE && led < _numLeds) {
+    return _ledStates[led];
+  }
+  return false;
+}
+
+// Get single LED color (for RGB LEDs)
+Color VibeLED::getLEDColor(uint16_t led) {
+  if (_ledType == LED_TYPE_RGB && led < _numLeds) {
+    return _ledColors[led];
+  }
+  return Color(0, 0, 0);
+}
+
+// Check whether the next frame is due and advance the frame timing
+bool VibeLED::_frameDue(unsigned long now) {
+  if (_timebase) {
+    // The step is derived from the time since the epoch, so every controller
+    // with the same clock, epoch and seed renders the same frame
+    long elapsed = (long)(now - _timebaseEpoch);
+    if (elapsed < 0) return false;
+
+    uint32_t step = (uint32_t)elapsed / max(_updateInterval, 1);
+    if (step == _timebaseStep) return false;
+
+    // Effects that keep state from step to step run the skipped steps (the
+    // last VIBELED_MAX_CATCH_UP of them) unshown, so they render what the
+    // other controllers show. Per-pixel effects are a function of the step,
+    // and the first frame and a clock set back (a step below the last one)
+    // jump to the step directly.
+    if (_timebaseStep != 0xFFFFFFFF && step > _timebaseStep) {
+      uint32_t skipped = step - _timebaseStep - 1;
+      if (skipped > 0) {
+        // Skipped steps mean the previous frame ran too long
+        _frameStats.lateFrames++;
+        VIBELED_PROFILE_LATE_FRAME();
+      }
+      if (!_isPixelEffect()) {
+        for (uint32_t s = step - min(skipped, (uint32_t)VIBELED_MAX_CATCH_UP); s < step; s++) {
+          _seedStep(s);
+          _updateEffect();
+        }
+      }
+    }
+    _timebaseStep = step;
+    _seedStep(step);
+    _lastUpdate = now;
+    return true;
+  }
+
+  uint16_t interval = _governor ? _frameInterval : _updateInterval;
+  if (now - _lastUpdate < interval) return false;
+
+  if (_frameStats.frames > 0 && interval > 0 && now - _lastUpdate >= 2UL * interval) {
+    _frameStats.lateFrames++;
+    VIBELED_PROFILE_LATE_FRAME();
   }
+  _lastUpdate = now;
+
+  if (_governor) {
+    // The step follows the clock rather than the frame count, skipping
+    // steps when frames are slow and holding when they are fast
+    uint16_t stepTime = max(_updateInterval, 1);
+    uint32_t steps = (now - _stepClock) / stepTime;
+    if (steps == 0) {
+      // Nothing new to render; another push only helps temporal dithering
+      _pushPending = (_ledColors16 != nullptr);
+      if (!_pushPending) {
+        VIBELED_PROFILE_SKIPPED_PUSH();
+      }
+      return false;
+    }
+    _stepClock += steps * stepTime;
+
+    // Per-pixel effects are a function of the step and jump straight to it;
+    // the others keep state from step to step, so the skipped steps are run
+    // without being shown (_endFrame() adds the last one)
+    uint32_t skipped = steps - 1;
+    if (!_isPixelEffect()) {
+      uint32_t run = min(skipped, (uint32_t)VIBELED_MAX_CATCH_UP);
+      _step += skipped - run;
+      for (uint32_t i = 0; i < run; i++) _updateEffect();
+    } else {
+      _step += skipped;
+    }
+  }
+  return true;
 }
 
 // Update the current effect
 void VibeLED::_updateEffect() {
+  VIBELED_PROFILE_START(start);
+
+  if (_isPixelEffect()) {
+    _renderPixels(_groupStart, _groupEnd);
+  } else {
+    switch (_currentEffect) {
+#ifdef VIBELED_USE_KNIGHT_RIDER
+      case EFFECT_KNIGHT_RIDER:
+        _effectKnightRider();
+        break;
+#endif
+#ifdef VIBELED_USE_CYLON
+      case EFFECT_CYLON:
+        _effectCylon();
+        break;
+#endif
+#ifdef VIBELED_USE_METEOR
+      case EFFECT_METEOR:
+        _effectMeteor();
+        break;
+#endif
+#ifdef VIBELED_USE_FIRE
+      case EFFECT_FIRE:
+        _effectFire();
+        break;
+#endif
+#ifdef VIBELED_USE_WATERFALL
+      case EFFECT_WATERFALL:
+        _effectWaterfall();
+        break;
+#endif
+#ifdef VIBELED_USE_STACK
+      case EFFECT_STACK:
+        _effectStack();
+        break;
+#endif
+#ifdef VIBELED_USE_SPARKLE
+      case EFFECT_SPARKLE:
+        _effectSparkle();
+        break;
+#endif
+#ifdef VIBELED_USE_BOUNCE
+      case EFFECT_BOUNCE:
+        _effectBounce();
+        break;
+#endif
+#ifdef VIBELED_USE_COLOR_WIPE
+      case EFFECT_COLOR_WIPE:
+        _effectColorWipe();
+        break;
+#endif
+#ifdef VIBELED_USE_RANDOM_BLINK
+      case EFFECT_RANDOM_BLINK:
+        _effectRandomBlink();
+        break;
+#endif
+#ifdef VIBELED_USE_SNAKE
+      case EFFECT_SNAKE:
+        _effectSnake();
+        break;
+#endif
+      case EFFECT_CUSTOM:
+        if (_customEffect != nullptr) {
+          _customEffect->render(*this, _groupStart, _groupEnd, _step, _lastUpdate);
+        } else {
+          _effectNone(_groupStart, _groupEnd);
+        }
+        break;
+      default:
+        _effectNone(_groupStart, _groupEnd);
+        break;
+    }
+  }
+
+  VIBELED_PROFILE_RENDER(_currentEffect, start);
+  _endFrame();
+}
+
+// Effects where every LED depends only on its position, the step and the
+// parameters, so any range of LEDs can be rendered on its own
+bool VibeLED::_isPixelEffect() {
   switch (_currentEffect) {
     case EFFECT_NONE:
-      _effectNone();
+#ifdef VIBELED_USE_STATIC
+    case EFFECT_STATIC:
+#endif
+#ifdef VIBELED_USE_BLINK
+    case EFFECT_BLINK:
+#endif
+#ifdef VIBELED_USE_BREATHE
+    case EFFECT_BREATHE:
+#endif
+#ifdef VIBELED_USE_PULSE
+    case EFFECT_PULSE:
+#endif
+#ifdef VIBELED_USE_FADE_IN
+    case EFFECT_FADE_IN:
+#endif
+#ifdef VIBELED_USE_FADE_OUT
+    case EFFECT_FADE_OUT:
+#endif
+#ifdef VIBELED_USE_CHASE
+    case EFFECT_CHASE:
+#endif
+#ifdef VIBELED_USE_MARQUEE
+    case EFFECT_MARQUEE:
+#endif
+#ifdef VIBELED_USE_RAINBOW
+    case EFFECT_RAINBOW:
+#endif
+#ifdef VIBELED_USE_WAVE
+    case EFFECT_WAVE:
+#endif
+#ifdef VIBELED_USE_TWINKLE
+    case EFFECT_TWINKLE:
+#endif
+#ifdef VIBELED_USE_FIRE_FLICKER_SOFT
+    case EFFECT_FIRE_FLICKER_SOFT:
+#endif
+#ifdef VIBELED_USE_GRADIENT
+    case EFFECT_GRADIENT:
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Render LEDs first..last of the current frame of a per-pixel effect
+void VibeLED::_renderPixels(uint16_t first, uint16_t last) {
+  switch (_currentEffect) {
+    case EFFECT_NONE:
+      _effectNone(first, last);
       break;
+#ifdef VIBELED_USE_STATIC
     case EFFECT_STATIC:
-      _effectStatic();
+      _effectStatic(first, last);
       break;
+#endif
+#ifdef VIBELED_USE_BLINK
     case EFFECT_BLINK:
-      _effectBlink();
+      _effectBlink(first, last);
       break;
+#endif
+#ifdef VIBELED_USE_BREATHE
     case EFFECT_BREATHE:
-      _effectBreathe();
+      _effectBreathe(first, last);
       break;
+#endif
+#ifdef VIBELED_USE_PULSE
     case EFFECT_PULSE:
-      _effectPulse();
+      _effectPulse(first, last);
       break;
+#endif
+#ifdef VIBELED_USE_FADE_IN
     case EFFECT_FADE_IN:
-      _effectFadeIn();
+      _effectFadeIn(first, last);
       break;
+#endif
+#ifdef VIBELED_USE_FADE_OUT
     case EFFECT_FADE_OUT:
-      _effectFadeOut();
-      break;
-    case EFFECT_KNIGHT_RIDER:
-      _effectKnightRider();
-      break;
-    case EFFECT_CYLON:
-      _effectCylon();
-      break;
-    case EFFECT_METEOR:
-      _effectMeteor();
-      break;
-    case EFFECT_FIRE:
-      _effectFire();
-      break;
-    case EFFECT_WATERFALL:
-      _effectWaterfall();
+      _effectFadeOut(first, last);
       break;
+#endif
+#ifdef VIBELED_USE_CHASE
     case EFFECT_CHASE:
-      _effectChase();
-      break;
-    case EFFECT_STACK:
-      _effectStack();
-      break;
-    case EFFECT_RAINBOW:
-      _effectRainbow();
-      break;
-    case EFFECT_SPARKLE:
-      _effectSparkle();
+      _effectChase(first, last);
       break;
+#endif
+#ifdef VIBELED_USE_MARQUEE
     case EFFECT_MARQUEE:
-      _effectMarquee();
+      _effectMarquee(first, last);
       break;
-    case EFFECT_BOUNCE:
-      _effectBounce();
+#endif
+#ifdef VIBELED_USE_RAINBOW
+    case EFFECT_RAINBOW:
+      _effectRainbow(first, last);
       break;
-    case EFFECT_COLOR_WIPE:
-      _effectColorWipe();
+#endif
+#ifdef VIBELED_USE_WAVE
+    case EFFECT_WAVE:
+      _effectWave(first, last);
       break;
-    case EFFECT_RANDOM_BLINK:
-      _effectRandomBlink();
+#endif
+#ifdef VIBELED_USE_TWINKLE
+    case EFFECT_TWINKLE:
+      _effectTwinkle(first, last);
       break;
-    case EFFECT_SNAKE:
-      _effectSnake();
+#endif
+#ifdef VIBELED_USE_FIRE_FLICKER_SOFT
+    case EFFECT_FIRE_FLICKER_SOFT:
+      _effectFireFlickerSoft(first, last);
       break;
-    case EFFECT_WAVE:
-      _effectWave();
+#endif
+#ifdef VIBELED_USE_GRADIENT
+    case EFFECT_GRADIENT:
+      _effectGradient(first, last);
       break;
+#endif
     default:
-      _effectNone();
       break;
   }
+}
+
+// Frame-level effect state, advanced once all LEDs are rendered
+void VibeLED::_endFrame() {
+  // Fades switch to a steady effect once complete
+  if (_currentEffect == EFFECT_FADE_IN && _step >= 100) {
+    _currentEffect = EFFECT_STATIC;
+  } else if (_currentEffect == EFFECT_FADE_OUT && _step >= 100) {
+    _currentEffect = EFFECT_NONE;
+  }
 
   _step++;
+  _redraw = false;
+}
+
+// Set the step of a timebase frame and reseed the random generator from it
+void VibeLED::_seedStep(uint32_t step) {
+  _step = step;
+  randomSeed((_timebaseSeed ^ (step * 2654435761UL)) | 1);
 }
 
 // Apply LED states to physical pins
 void VibeLED::_applyStates() {
-  if (_ledType == LED_TYPE_SINGLE) {
+  VIBELED_PROFILE_START(ticks);
+  unsigned long start = micros();
+  _limitPower();
+  _ditherFrame();
+
+  if (_output != nullptr) {
+    _output->show(*this);
+  } else if (_ledType == LED_TYPE_SINGLE) {
     // For single color LEDs, we directly set the pin state for each LED
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
       digitalWrite(_pins[0], _ledStates[i] ? HIGH : LOW);
-      // Note: This is a simplified implementation. In a real-world scenario,
-      // you would need to use shift registers or other methods to control multiple LEDs
-      // with a single pin.
+      // Note: This is a simplified implementation. To control multiple LEDs,
+      // attach an output driver such as VibeLEDShiftOutput with setOutput().
     }
   } else {
     // For RGB LEDs, we need to set the RGB values for each LED
@@ -307,152 +1432,394 @@ void VibeLED::_applyStates() {
     // you would need to use a library like FastLED or Adafruit NeoPixel
     // to control RGB LEDs.
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      analogWrite(_pins[0], map(_ledColors[i].r, 0, 255, 0, _effectParams.brightness));
-      analogWrite(_pins[1], map(_ledColors[i].g, 0, 255, 0, _effectParams.brightness));
-      analogWrite(_pins[2], map(_ledColors[i].b, 0, 255, 0, _effectParams.brightness));
+      Color color = getOutputColor(i);
+      analogWrite(_pins[0], color.r);
+      analogWrite(_pins[1], color.g);
+      analogWrite(_pins[2], color.b);
     }
   }
+
+  VIBELED_PROFILE_OUTPUT(_currentEffect, ticks);
+  _recordOutput(start);
+  _recordPush();
 }
 
-// Effect implementations
+// Count a frame handed to the outputs
+void VibeLED::_recordPush() {
+  _pushes++;
+  _lastPush = micros();
+}
 
-// No effect (all LEDs off)
-void VibeLED::_effectNone() {
-  if (_ledType == LED_TYPE_SINGLE) {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = false;
+// Record the render time of a frame
+void VibeLED::_recordRender(unsigned long start) {
+  _frameStats.renderTime = micros() - start;
+  _frameStats.frames++;
+}
+
+// Record the output time of a frame and let the governor pick the next frame interval
+void VibeLED::_recordOutput(unsigned long start) {
+  _frameStats.outputTime = micros() - start;
+  uint32_t cost = _frameStats.renderTime + _frameStats.outputTime;
+  _frameStats.averageTime = (_frameStats.averageTime * 7 + cost) / 8;
+
+  bool governed = _governor && !_timebase;
+  if (governed) {
+    // Shortest interval at which the average cost stays within the CPU share
+    uint32_t interval = (_frameStats.averageTime * 100 / _cpuShare + 999) / 1000;
+    _frameInterval = constrain(interval, (uint32_t)_minInterval, (uint32_t)_maxInterval);
+  }
+
+  uint16_t interval = governed ? _frameInterval : _updateInterval;
+  uint32_t budget = (uint32_t)interval * 1000;
+  _frameStats.frameInterval = interval;
+  _frameStats.headroom = (_frameStats.averageTime >= budget) ? 0 :
+                         100 - (_frameStats.averageTime * 100) / budget;
+}
+
+// Scale the output brightness down if the frame would exceed the power limit
+void VibeLED::_limitPower() {
+  uint8_t brightness = _effectParams.brightness;
+
+  if (_powerLimit == 0) {
+    _outputBrightness = brightness;
+    return;
+  }
+
+  // Estimated draw at full brightness, then at the requested brightness
+  uint32_t full = (_powerLevel * _powerPerChannel) / 255;
+  uint32_t requested = (full * (brightness + 1)) >> 8;
+
+  if (requested > _powerLimit) {
+    uint32_t limited = (((uint32_t)_powerLimit << 8) / full);
+    brightness = (limited > 0) ? limited - 1 : 0;
+    _powerStats.limitedFrames++;
+  }
+
+  _outputBrightness = brightness;
+  _powerStats.requested = requested;
+  _powerStats.delivered = (full * (brightness + 1)) >> 8;
+  _powerStats.brightness = brightness;
+}
+
+// Dither the 16-bit buffer down to this frame's output colors, once per
+// frame, carrying each remainder over to the next frame
+void VibeLED::_ditherFrame() {
+  if (_ditherColors == nullptr) return;
+
+  uint16_t scale = _outputBrightness + 1;
+  uint8_t* error = _ditherError;
+  for (uint16_t i = 0; i < _numLeds; i++, error += 3) {
+    Color16 color = _ledColors16[i];
+    _ditherColors[i] = Color(_dither(color.r, scale, error[0]),
+                             _dither(color.g, scale, error[1]),
+                             _dither(color.b, scale, error[2]));
+  }
+}
+
+// Sum of all channel values of LEDs first..last (the power estimate's unit)
+uint32_t VibeLED::_powerSum(uint16_t first, uint16_t last) {
+  uint32_t sum = 0;
+  for (uint16_t i = first; i <= last; i++) {
+    if (_ledType == LED_TYPE_SINGLE) {
+      sum += _ledStates[i] ? 255 : 0;
+    } else {
+      sum += (uint16_t)_ledColors[i].r + _ledColors[i].g + _ledColors[i].b;
+    }
+  }
+  return sum;
+}
+
+// Fill LEDs first..last with a color scaled by a 16-bit level (0-65535)
+void VibeLED::_fillScaled(Color color, uint16_t level, uint16_t first, uint16_t last) {
+  uint32_t scale = (uint32_t)level + 1;
+  Color16 wide(((uint32_t)color.r * 257 * scale) >> 16,
+               ((uint32_t)color.g * 257 * scale) >> 16,
+               ((uint32_t)color.b * 257 * scale) >> 16);
+  _fillColors(first, last, Color(wide.r >> 8, wide.g >> 8, wide.b >> 8), wide);
+}
+
+// Set LEDs first..last on or off (single color LEDs)
+void VibeLED::_fillStates(uint16_t first, uint16_t last, bool state) {
+  uint16_t wasOn = 0;
+  for (uint16_t i = first; i <= last; i++) {
+    wasOn += _ledStates[i];
+    _ledStates[i] = state;
+  }
+  if (_powerLimit > 0) {
+    _powerLevel += ((uint32_t)(state ? last - first + 1 : 0) - wasOn) * 255;
+  }
+}
+
+// Set LEDs first..last to one color (RGB LEDs)
+void VibeLED::_fillColors(uint16_t first, uint16_t last, Color color) {
+  _fillColors(first, last, color, Color16(color));
+}
+
+// Set LEDs first..last to one color with its 16-bit value, writing both
+// buffers in one pass and the power estimate once
+void VibeLED::_fillColors(uint16_t first, uint16_t last, Color color, Color16 wide) {
+  // Buffers in locals, as in _gradient()
+  Color* colors = _ledColors;
+  Color16* colors16 = _ledColors16;
+  uint32_t before = 0;
+  if (colors16 != nullptr) {
+    for (uint16_t i = first; i <= last; i++) {
+      before += (uint16_t)colors[i].r + colors[i].g + colors[i].b;
+      colors[i] = color;
+      colors16[i] = wide;
     }
   } else {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledColors[i] = Color(0, 0, 0);
+    for (uint16_t i = first; i <= last; i++) {
+      before += (uint16_t)colors[i].r + colors[i].g + colors[i].b;
+      colors[i] = color;
     }
   }
+  if (_powerLimit > 0) {
+    _powerLevel += (uint32_t)(last - first + 1) * ((uint16_t)color.r + color.g + color.b) - before;
+  }
 }
 
-// Static effect (all LEDs on with the current color)
-void VibeLED::_effectStatic() {
+// Turn LEDs first..last on (primary color) or off, for either LED type
+void VibeLED::_fillLit(uint16_t first, uint16_t last, bool lit) {
   if (_ledType == LED_TYPE_SINGLE) {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = true;
-    }
+    _fillStates(first, last, lit);
   } else {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledColors[i] = _effectParams.color1;
+    _fillColors(first, last, lit ? _effectParams.color1 : Color(0, 0, 0));
+  }
+}
+
+// Move count LEDs (memmove, so the ranges may overlap)
+void VibeLED::_moveLEDs(uint16_t to, uint16_t from, uint16_t count) {
+  if (_powerLimit > 0) {
+    _powerLevel += _powerSum(from, from + count - 1) - _powerSum(to, to + count - 1);
+  }
+
+  if (_ledType == LED_TYPE_SINGLE) {
+    memmove(_ledStates + to, _ledStates + from, count * sizeof(bool));
+  } else {
+    memmove(_ledColors + to, _ledColors + from, count * sizeof(Color));
+    if (_ledColors16 != nullptr) {
+      memmove(_ledColors16 + to, _ledColors16 + from, count * sizeof(Color16));
+    }
+  }
+}
+
+// Write LEDs first..last of a linear gradient that runs from start to end.
+// Levels are 16-bit values in 16.16 fixed point, so a long gradient has no
+// rounding drift; the steps may wrap as unsigned numbers, the levels never do.
+void VibeLED::_gradient(uint16_t start, uint16_t end, Color from, Color to, uint16_t first, uint16_t last) {
+  uint16_t span = end - start;
+  uint32_t r = ((uint32_t)from.r * 257 << 16) + 0x8000;
+  uint32_t g = ((uint32_t)from.g * 257 << 16) + 0x8000;
+  uint32_t b = ((uint32_t)from.b * 257 << 16) + 0x8000;
+  uint32_t dr = 0;
+  uint32_t dg = 0;
+  uint32_t db = 0;
+  if (span > 0) {
+    dr = (uint32_t)((int64_t)((int16_t)to.r - from.r) * 257 * 65536 / span);
+    dg = (uint32_t)((int64_t)((int16_t)to.g - from.g) * 257 * 65536 / span);
+    db = (uint32_t)((int64_t)((int16_t)to.b - from.b) * 257 * 65536 / span);
+  }
+
+  uint16_t offset = first - start;
+  r += dr * offset;
+  g += dg * offset;
+  b += db * offset;
+
+  // Both buffers are written in one pass and the power estimate once. The
+  // buffers are held in locals: byte stores could alias the members, which
+  // would reload them for every LED.
+  Color* colors = _ledColors;
+  Color16* colors16 = _ledColors16;
+  uint32_t before = 0;
+  uint32_t after = 0;
+  for (uint16_t i = first; i <= last; i++) {
+    Color color(r >> 24, g >> 24, b >> 24);
+    before += (uint16_t)colors[i].r + colors[i].g + colors[i].b;
+    after += (uint16_t)color.r + color.g + color.b;
+    colors[i] = color;
+    if (colors16 != nullptr) {
+      colors16[i] = Color16(r >> 16, g >> 16, b >> 16);
     }
+    r += dr;
+    g += dg;
+    b += db;
+  }
+  if (_powerLimit > 0) {
+    _powerLevel += after - before;
+  }
+}
+
+// Scale a 16-bit channel by the output brightness and dither it down to 8 bits,
+// carrying the remainder over to the next frame
+uint8_t VibeLED::_dither(uint16_t value, uint16_t scale, uint8_t& error) {
+  uint32_t level = (((uint32_t)value * scale) >> 8) + error;
+  if (level > 65535) level = 65535;
+  error = level & 0xFF;
+  return level >> 8;
+}
+
+// Idle the MCU until the next interrupt (the millis() tick at the latest)
+void VibeLED::_idle() {
+#if defined(__AVR__)
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_mode();
+#elif defined(__arm__)
+  __asm__ __volatile__("wfi");
+#else
+  // ESP32 and ESP8266 idle in delay(); the host advances its clock
+  delay(1);
+#endif
+}
+
+// Smaller of two values without a branch
+uint16_t VibeLED::_lower(uint16_t a, uint16_t b) {
+  int32_t difference = (int32_t)a - b;
+  return b + (difference & (difference >> 31));
+}
+
+// Write a value of 1 to 4 bytes, least significant first
+void VibeLED::_writeValue(uint8_t*& out, uint32_t value, uint8_t size) {
+  for (uint8_t i = 0; i < size; i++) {
+    *out++ = value >> (i * 8);
+  }
+}
+
+// Read a value of 1 to 4 bytes, least significant first
+uint32_t VibeLED::_readValue(const uint8_t*& in, uint8_t size) {
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < size; i++) {
+    value |= (uint32_t)*in++ << (i * 8);
+  }
+  return value;
+}
+
+// Fletcher-16 checksum, reducing the sums only every 20 bytes
+uint16_t VibeLED::_fletcher16(const uint8_t* data, uint32_t length) {
+  uint16_t sum1 = 0xFF;
+  uint16_t sum2 = 0xFF;
+  while (length > 0) {
+    uint8_t block = (length > 20) ? 20 : length;
+    length -= block;
+    do {
+      sum1 += *data++;
+      sum2 += sum1;
+    } while (--block);
+    sum1 = (sum1 & 0xFF) + (sum1 >> 8);
+    sum2 = (sum2 & 0xFF) + (sum2 >> 8);
   }
+  sum1 = (sum1 & 0xFF) + (sum1 >> 8);
+  sum2 = (sum2 & 0xFF) + (sum2 >> 8);
+  return (sum2 << 8) | sum1;
+}
+
+// Effect implementations
+
+// No effect (all LEDs off)
+void VibeLED::_effectNone(uint16_t first, uint16_t last) {
+  _fillLit(first, last, false);
+}
+
+#ifdef VIBELED_USE_STATIC
+// Static effect (all LEDs on with the current color)
+void VibeLED::_effectStatic(uint16_t first, uint16_t last) {
+  _fillLit(first, last, true);
 }
+#endif
 
+#ifdef VIBELED_USE_BLINK
 // Blink effect (all LEDs blink together)
-void VibeLED::_effectBlink() {
+void VibeLED::_effectBlink(uint16_t first, uint16_t last) {
   bool state = (_step % 2 == 0);
 
   if (_ledType == LED_TYPE_SINGLE) {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = state;
+    for (uint16_t i = first; i <= last; i++) {
+      _setState(i, state);
     }
   } else {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledColors[i] = state ? _effectParams.color1 : Color(0, 0, 0);
+    for (uint16_t i = first; i <= last; i++) {
+      _setColor(i, state ? _effectParams.color1 : Color(0, 0, 0));
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_BREATHE
 // Breathe effect (fade in and out)
-void VibeLED::_effectBreathe() {
-  // Use sine wave for smooth breathing effect
+void VibeLED::_effectBreathe(uint16_t first, uint16_t last) {
+  // Use sine wave for smooth breathing effect (evaluated once per frame)
   float breath = (sin((_step % 100) / 15.0) + 1.0) / 2.0;
+  uint16_t level = breath * 65535.0;
 
   if (_ledType == LED_TYPE_SINGLE) {
-    bool state = breath > 0.5;
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = state;
+    bool state = level > 32767;
+    for (uint16_t i = first; i <= last; i++) {
+      _setState(i, state);
     }
   } else {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      uint8_t r = _effectParams.color1.r * breath;
-      uint8_t g = _effectParams.color1.g * breath;
-      uint8_t b = _effectParams.color1.b * breath;
-      _ledColors[i] = Color(r, g, b);
-    }
+    _fillScaled(_effectParams.color1, level, first, last);
   }
 }
+#endif
 
+#ifdef VIBELED_USE_PULSE
 // Pulse effect (quick fade in, slow fade out)
-void VibeLED::_effectPulse() {
+void VibeLED::_effectPulse(uint16_t first, uint16_t last) {
   uint8_t pulseStep = _step % 100;
-  float intensity;
+  uint16_t level;
 
   if (pulseStep < 20) {
     // Quick fade in (20% of the cycle)
-    intensity = pulseStep / 20.0;
+    level = ((uint32_t)pulseStep * 65535) / 20;
   } else {
     // Slow fade out (80% of the cycle)
-    intensity = 1.0 - ((pulseStep - 20) / 80.0);
+    level = 65535 - ((uint32_t)(pulseStep - 20) * 65535) / 80;
   }
 
   if (_ledType == LED_TYPE_SINGLE) {
-    bool state = intensity > 0.5;
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = state;
+    bool state = level > 32767;
+    for (uint16_t i = first; i <= last; i++) {
+      _setState(i, state);
     }
   } else {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      uint8_t r = _effectParams.color1.r * intensity;
-      uint8_t g = _effectParams.color1.g * intensity;
-      uint8_t b = _effectParams.color1.b * intensity;
-      _ledColors[i] = Color(r, g, b);
-    }
+    _fillScaled(_effectParams.color1, level, first, last);
   }
 }
+#endif
 
-// Fade in effect
-void VibeLED::_effectFadeIn() {
-  float intensity = min(1.0, _step / 100.0);
+#ifdef VIBELED_USE_FADE_IN
+// Fade in effect (switches to EFFECT_STATIC in _endFrame() when complete)
+void VibeLED::_effectFadeIn(uint16_t first, uint16_t last) {
+  uint16_t level = (_step >= 100) ? 65535 : ((uint32_t)_step * 65535) / 100;
 
   if (_ledType == LED_TYPE_SINGLE) {
-    bool state = intensity > 0.5;
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = state;
+    bool state = level > 32767;
+    for (uint16_t i = first; i <= last; i++) {
+      _setState(i, state);
     }
   } else {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      uint8_t r = _effectParams.color1.r * intensity;
-      uint8_t g = _effectParams.color1.g * intensity;
-      uint8_t b = _effectParams.color1.b * intensity;
-      _ledColors[i] = Color(r, g, b);
-    }
-  }
-
-  // Reset effect when fully faded in
-  if (intensity >= 1.0) {
-    _currentEffect = EFFECT_STATIC;
+    _fillScaled(_effectParams.color1, level, first, last);
   }
 }
+#endif
 
-// Fade out effect
-void VibeLED::_effectFadeOut() {
-  float intensity = max(0.0, 1.0 - (_step / 100.0));
+#ifdef VIBELED_USE_FADE_OUT
+// Fade out effect (switches to EFFECT_NONE in _endFrame() when complete)
+void VibeLED::_effectFadeOut(uint16_t first, uint16_t last) {
+  uint16_t level = (_step >= 100) ? 0 : 65535 - ((uint32_t)_step * 65535) / 100;
 
   if (_ledType == LED_TYPE_SINGLE) {
-    bool state = intensity > 0.5;
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = state;
+    bool state = level > 32767;
+    for (uint16_t i = first; i <= last; i++) {
+      _setState(i, state);
     }
   } else {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      uint8_t r = _effectParams.color1.r * intensity;
-      uint8_t g = _effectParams.color1.g * intensity;
-      uint8_t b = _effectParams.color1.b * intensity;
-      _ledColors[i] = Color(r, g, b);
-    }
-  }
-
-  // Reset effect when fully faded out
-  if (intensity <= 0.0) {
-    _currentEffect = EFFECT_NONE;
+    _fillScaled(_effectParams.color1, level, first, last);
   }
 }
+#endif
 
+#ifdef VIBELED_USE_KNIGHT_RIDER
 // Knight Rider effect (back and forth)
 void VibeLED::_effectKnightRider() {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
@@ -471,12 +1838,12 @@ void VibeLED::_effectKnightRider() {
 
   if (_ledType == LED_TYPE_SINGLE) {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = (i == _groupStart + position);
+      _setState(i, (i == _groupStart + position));
     }
   } else {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
       if (i == _groupStart + position) {
-        _ledColors[i] = _effectParams.color1;
+        _setColor(i, _effectParams.color1);
       } else {
         // Create a trail effect
         uint16_t distance = abs((int)(i - (_groupStart + position)));
@@ -485,15 +1852,17 @@ void VibeLED::_effectKnightRider() {
           uint8_t r = _effectParams.color1.r * intensity;
           uint8_t g = _effectParams.color1.g * intensity;
           uint8_t b = _effectParams.color1.b * intensity;
-          _ledColors[i] = Color(r, g, b);
+          _setColor(i, Color(r, g, b));
         } else {
-          _ledColors[i] = Color(0, 0, 0);
+          _setColor(i, Color(0, 0, 0));
         }
       }
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_CYLON
 // Cylon effect (similar to Knight Rider but with different trail)
 void VibeLED::_effectCylon() {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
@@ -512,7 +1881,7 @@ void VibeLED::_effectCylon() {
 
   if (_ledType == LED_TYPE_SINGLE) {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = (i == _groupStart + position);
+      _setState(i, (i == _groupStart + position));
     }
   } else {
     // First, dim all LEDs
@@ -520,14 +1889,16 @@ void VibeLED::_effectCylon() {
       uint8_t r = _ledColors[i].r * 0.8;
       uint8_t g = _ledColors[i].g * 0.8;
       uint8_t b = _ledColors[i].b * 0.8;
-      _ledColors[i] = Color(r, g, b);
+      _setColor(i, Color(r, g, b));
     }
 
     // Set the current position to full brightness
-    _ledColors[_groupStart + position] = _effectParams.color1;
+    _setColor(_groupStart + position, _effectParams.color1);
   }
 }
+#endif
 
+#ifdef VIBELED_USE_METEOR
 // Meteor effect
 void VibeLED::_effectMeteor() {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
@@ -537,14 +1908,14 @@ void VibeLED::_effectMeteor() {
   // First, dim all LEDs
   if (_ledType == LED_TYPE_SINGLE) {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = false;
+      _setState(i, false);
     }
   } else {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
       uint8_t r = _ledColors[i].r * 0.7;
       uint8_t g = _ledColors[i].g * 0.7;
       uint8_t b = _ledColors[i].b * 0.7;
-      _ledColors[i] = Color(r, g, b);
+      _setColor(i, Color(r, g, b));
     }
   }
 
@@ -553,31 +1924,35 @@ void VibeLED::_effectMeteor() {
     uint16_t index = position + i;
     if (index >= 0 && index < numLeds) {
       if (_ledType == LED_TYPE_SINGLE) {
-        _ledStates[_groupStart + index] = true;
+        _setState(_groupStart + index, true);
       } else {
         float intensity = (meteorSize - i) / (float)meteorSize;
         uint8_t r = _effectParams.color1.r * intensity;
         uint8_t g = _effectParams.color1.g * intensity;
         uint8_t b = _effectParams.color1.b * intensity;
-        _ledColors[_groupStart + index] = Color(r, g, b);
+        _setColor(_groupStart + index, Color(r, g, b));
       }
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_FIRE
 // Fire effect
 void VibeLED::_effectFire() {
   if (_ledType == LED_TYPE_RGB) {
     uint16_t numLeds = _groupEnd - _groupStart + 1;
 
-    // Heat array (0-255) for each LED
-    static uint8_t* heat = nullptr;
-    if (heat == nullptr) {
-      heat = new uint8_t[numLeds];
-      for (uint16_t i = 0; i < numLeds; i++) {
-        heat[i] = 0;
+    // Heat (0-255) for each LED, kept per instance so several strips
+    // (or render jobs on different threads) do not share one fire
+    if (_heat == nullptr) {
+      _heat = new uint8_t[_numLeds];
+      VIBELED_PROFILE_ALLOCATION(_numLeds);
+      for (uint16_t i = 0; i < _numLeds; i++) {
+        _heat[i] = 0;
       }
     }
+    uint8_t* heat = _heat;
 
     // Step 1: Cool down every LED a little
     for (uint16_t i = 0; i < numLeds; i++) {
@@ -596,7 +1971,7 @@ void VibeLED::_effectFire() {
 
     // Step 3: Randomly ignite new sparks at the bottom
     if (random(255) < 120) {
-      uint8_t y = random(7);
+      uint8_t y = random(min(numLeds, 7));
       heat[y] = min(heat[y] + random(160, 255), 255);
     }
 
@@ -621,62 +1996,55 @@ void VibeLED::_effectFire() {
         b = (temperature - 170) * 3;
       }
 
-      _ledColors[_groupStart + i] = Color(r, g, b);
+      _setColor(_groupStart + i, Color(r, g, b));
     }
   } else {
     // For single color LEDs, just do a random flicker
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = random(100) < 50;
+      _setState(i, random(100) < 50);
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_WATERFALL
 // Waterfall effect
 void VibeLED::_effectWaterfall() {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
 
   // Shift all LEDs down by one
-  if (_ledType == LED_TYPE_SINGLE) {
-    for (uint16_t i = _groupEnd; i > _groupStart; i--) {
-      _ledStates[i] = _ledStates[i - 1];
-    }
-
-    // Randomly add new drops at the top
-    _ledStates[_groupStart] = random(100) < 20;
-  } else {
-    for (uint16_t i = _groupEnd; i > _groupStart; i--) {
-      _ledColors[i] = _ledColors[i - 1];
-    }
-
-    // Randomly add new drops at the top
-    if (random(100) < 20) {
-      _ledColors[_groupStart] = _effectParams.color1;
-    } else {
-      _ledColors[_groupStart] = Color(0, 0, 0);
-    }
+  if (numLeds > 1) {
+    _moveLEDs(_groupStart + 1, _groupStart, numLeds - 1);
   }
+
+  // Randomly add new drops at the top
+  _fillLit(_groupStart, _groupStart, random(100) < 20);
 }
+#endif
 
+#ifdef VIBELED_USE_CHASE
 // Chase effect
-void VibeLED::_effectChase() {
+void VibeLED::_effectChase(uint16_t first, uint16_t last) {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
   uint16_t position = _step % numLeds;
 
   if (_ledType == LED_TYPE_SINGLE) {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = (i == _groupStart + position);
+    for (uint16_t i = first; i <= last; i++) {
+      _setState(i, (i == _groupStart + position));
     }
   } else {
-    for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
+    for (uint16_t i = first; i <= last; i++) {
       if (i == _groupStart + position) {
-        _ledColors[i] = _effectParams.color1;
+        _setColor(i, _effectParams.color1);
       } else {
-        _ledColors[i] = Color(0, 0, 0);
+        _setColor(i, Color(0, 0, 0));
       }
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_STACK
 // Stack effect
 void VibeLED::_effectStack() {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
@@ -689,14 +2057,14 @@ void VibeLED::_effectStack() {
 
     if (_ledType == LED_TYPE_SINGLE) {
       for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-        _ledStates[i] = (i <= _groupStart + position);
+        _setState(i, (i <= _groupStart + position));
       }
     } else {
       for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
         if (i <= _groupStart + position) {
-          _ledColors[i] = _effectParams.color1;
+          _setColor(i, _effectParams.color1);
         } else {
-          _ledColors[i] = Color(0, 0, 0);
+          _setColor(i, Color(0, 0, 0));
         }
       }
     }
@@ -706,73 +2074,57 @@ void VibeLED::_effectStack() {
 
     if (_ledType == LED_TYPE_SINGLE) {
       for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-        _ledStates[i] = (i <= _groupStart + position);
+        _setState(i, (i <= _groupStart + position));
       }
     } else {
       for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
         if (i <= _groupStart + position) {
-          _ledColors[i] = _effectParams.color1;
+          _setColor(i, _effectParams.color1);
         } else {
-          _ledColors[i] = Color(0, 0, 0);
+          _setColor(i, Color(0, 0, 0));
         }
       }
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_RAINBOW
 // Rainbow effect (RGB only)
-void VibeLED::_effectRainbow() {
-  if (_ledType == LED_TYPE_RGB) {
-    uint16_t numLeds = _groupEnd - _groupStart + 1;
+void VibeLED::_effectRainbow(uint16_t first, uint16_t last) {
+  uint16_t numLeds = _groupEnd - _groupStart + 1;
 
-    for (uint16_t i = 0; i < numLeds; i++) {
+  if (_ledType == LED_TYPE_RGB) {
+    for (uint16_t i = first - _groupStart; i <= last - _groupStart; i++) {
       // Calculate hue based on position and time
       uint8_t hue = (i * 255 / numLeds + _step) % 256;
 
-      // Convert HSV to RGB (simplified)
-      uint8_t region = hue / 43;
-      uint8_t remainder = (hue - (region * 43)) * 6;
-
-      uint8_t p = 0;
-      uint8_t q = 255 - remainder;
-      uint8_t t = remainder;
-
-      uint8_t r, g, b;
-
-      switch (region) {
-        case 0: r = 255; g = t; b = p; break;
-        case 1: r = q; g = 255; b = p; break;
-        case 2: r = p; g = 255; b = t; break;
-        case 3: r = p; g = q; b = 255; break;
-        case 4: r = t; g = p; b = 255; break;
-        default: r = 255; g = p; b = q; break;
-      }
-
-      _ledColors[_groupStart + i] = Color(r, g, b);
+      _setColor(_groupStart + i, hueToColor(hue));
     }
   } else {
     // For single color LEDs, just do a wave pattern
-    uint16_t numLeds = _groupEnd - _groupStart + 1;
-    for (uint16_t i = 0; i < numLeds; i++) {
+    for (uint16_t i = first - _groupStart; i <= last - _groupStart; i++) {
       float sinVal = sin((_step / 10.0) + (i / 2.0));
-      _ledStates[_groupStart + i] = sinVal > 0;
+      _setState(_groupStart + i, sinVal > 0);
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_SPARKLE
 // Sparkle effect
 void VibeLED::_effectSparkle() {
   // First, dim all LEDs
   if (_ledType == LED_TYPE_SINGLE) {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = false;
+      _setState(i, false);
     }
   } else {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
       uint8_t r = _ledColors[i].r * 0.8;
       uint8_t g = _ledColors[i].g * 0.8;
       uint8_t b = _ledColors[i].b * 0.8;
-      _ledColors[i] = Color(r, g, b);
+      _setColor(i, Color(r, g, b));
     }
   }
 
@@ -784,28 +2136,30 @@ void VibeLED::_effectSparkle() {
     uint16_t pos = random(numLeds);
 
     if (_ledType == LED_TYPE_SINGLE) {
-      _ledStates[_groupStart + pos] = true;
+      _setState(_groupStart + pos, true);
     } else {
-      _ledColors[_groupStart + pos] = _effectParams.color1;
+      _setColor(_groupStart + pos, _effectParams.color1);
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_MARQUEE
 // Marquee effect
-void VibeLED::_effectMarquee() {
-  uint16_t numLeds = _groupEnd - _groupStart + 1;
-
-  for (uint16_t i = 0; i < numLeds; i++) {
+void VibeLED::_effectMarquee(uint16_t first, uint16_t last) {
+  for (uint16_t i = first - _groupStart; i <= last - _groupStart; i++) {
     bool isOn = ((i + _step) % 3 == 0);
 
     if (_ledType == LED_TYPE_SINGLE) {
-      _ledStates[_groupStart + i] = isOn;
+      _setState(_groupStart + i, isOn);
     } else {
-      _ledColors[_groupStart + i] = isOn ? _effectParams.color1 : Color(0, 0, 0);
+      _setColor(_groupStart + i, isOn ? _effectParams.color1 : Color(0, 0, 0));
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_BOUNCE
 // Bounce effect
 void VibeLED::_effectBounce() {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
@@ -817,58 +2171,38 @@ void VibeLED::_effectBounce() {
 
   if (_ledType == LED_TYPE_SINGLE) {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = (i == _groupStart + pos);
+      _setState(i, (i == _groupStart + pos));
     }
   } else {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
       if (i == _groupStart + pos) {
-        _ledColors[i] = _effectParams.color1;
+        _setColor(i, _effectParams.color1);
       } else {
-        _ledColors[i] = Color(0, 0, 0);
+        _setColor(i, Color(0, 0, 0));
       }
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_COLOR_WIPE
 // Color wipe effect
 void VibeLED::_effectColorWipe() {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
   uint16_t position = _step % (numLeds * 2);
 
-  if (position < numLeds) {
-    // Wipe in
-    if (_ledType == LED_TYPE_SINGLE) {
-      for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-        _ledStates[i] = (i <= _groupStart + position);
-      }
-    } else {
-      for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-        if (i <= _groupStart + position) {
-          _ledColors[i] = _effectParams.color1;
-        } else {
-          _ledColors[i] = Color(0, 0, 0);
-        }
-      }
-    }
-  } else {
-    // Wipe out
-    position = position - numLeds;
-    if (_ledType == LED_TYPE_SINGLE) {
-      for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-        _ledStates[i] = (i > _groupStart + position);
-      }
-    } else {
-      for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-        if (i > _groupStart + position) {
-          _ledColors[i] = _effectParams.color1;
-        } else {
-          _ledColors[i] = Color(0, 0, 0);
-        }
-      }
-    }
+  // Wipe in lights the LEDs up to the edge, wipe out turns them off again
+  bool wipeIn = (position < numLeds);
+  uint16_t edge = _groupStart + (wipeIn ? position : position - numLeds);
+
+  _fillLit(_groupStart, edge, wipeIn);
+  if (edge < _groupEnd) {
+    _fillLit(edge + 1, _groupEnd, !wipeIn);
   }
 }
+#endif
 
+#ifdef VIBELED_USE_RANDOM_BLINK
 // Random blink effect
 void VibeLED::_effectRandomBlink() {
   if (_step % 5 == 0) {  // Update every 5 steps
@@ -878,22 +2212,24 @@ void VibeLED::_effectRandomBlink() {
       bool isOn = random(100) < 30;  // 30% chance to be on
 
       if (_ledType == LED_TYPE_SINGLE) {
-        _ledStates[_groupStart + i] = isOn;
+        _setState(_groupStart + i, isOn);
       } else {
         if (isOn) {
           // Random color for RGB LEDs
           uint8_t r = random(256);
           uint8_t g = random(256);
           uint8_t b = random(256);
-          _ledColors[_groupStart + i] = Color(r, g, b);
+          _setColor(_groupStart + i, Color(r, g, b));
         } else {
-          _ledColors[_groupStart + i] = Color(0, 0, 0);
+          _setColor(_groupStart + i, Color(0, 0, 0));
         }
       }
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_SNAKE
 // Snake effect
 void VibeLED::_effectSnake() {
   uint16_t numLeds = _groupEnd - _groupStart + 1;
@@ -902,11 +2238,11 @@ void VibeLED::_effectSnake() {
   // Clear all LEDs
   if (_ledType == LED_TYPE_SINGLE) {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledStates[i] = false;
+      _setState(i, false);
     }
   } else {
     for (uint16_t i = _groupStart; i <= _groupEnd; i++) {
-      _ledColors[i] = Color(0, 0, 0);
+      _setColor(i, Color(0, 0, 0));
     }
   }
 
@@ -915,33 +2251,115 @@ void VibeLED::_effectSnake() {
     uint16_t pos = (_step + i) % numLeds;
 
     if (_ledType == LED_TYPE_SINGLE) {
-      _ledStates[_groupStart + pos] = true;
+      _setState(_groupStart + pos, true);
     } else {
       // Gradient color for the snake
       float intensity = 1.0 - (i / (float)snakeLength);
       uint8_t r = _effectParams.color1.r * intensity;
       uint8_t g = _effectParams.color1.g * intensity;
       uint8_t b = _effectParams.color1.b * intensity;
-      _ledColors[_groupStart + pos] = Color(r, g, b);
+      _setColor(_groupStart + pos, Color(r, g, b));
     }
   }
 }
+#endif
 
+#ifdef VIBELED_USE_WAVE
 // Wave effect
-void VibeLED::_effectWave() {
-  uint16_t numLeds = _groupEnd - _groupStart + 1;
-
-  for (uint16_t i = 0; i < numLeds; i++) {
+void VibeLED::_effectWave(uint16_t first, uint16_t last) {
+  for (uint16_t i = first - _groupStart; i <= last - _groupStart; i++) {
     float sinVal = sin((_step / 10.0) + (i / 2.0));
     float intensity = (sinVal + 1.0) / 2.0;  // Convert from -1..1 to 0..1
 
     if (_ledType == LED_TYPE_SINGLE) {
-      _ledStates[_groupStart + i] = intensity > 0.5;
+      _setState(_groupStart + i, intensity > 0.5);
     } else {
       uint8_t r = _effectParams.color1.r * intensity;
       uint8_t g = _effectParams.color1.g * intensity;
       uint8_t b = _effectParams.color1.b * intensity;
-      _ledColors[_groupStart + i] = Color(r, g, b);
+      _setColor(_groupStart + i, Color(r, g, b));
+    }
+  }
+}
+#endif
+
+#ifdef VIBELED_USE_TWINKLE
+// Twinkle effect (LEDs glow up and fade out smoothly at random)
+void VibeLED::_effectTwinkle(uint16_t first, uint16_t last) {
+  // Each LED follows its own line through a noise field that moves with the
+  // step, and only the peaks light up. Option 1 sets the density (0 = 128).
+  uint8_t density = _effectParams.option1 ? _effectParams.option1 : 128;
+  uint8_t threshold = 128 + (255 - density) / 4;
+  uint16_t time = _step * 8;
+
+  for (uint16_t i = first; i <= last; i++) {
+    // 2.7 cells apart, so neighbouring LEDs twinkle independently
+    uint8_t value = _noise.noise8((uint16_t)(i * 691U), time);
+    uint8_t level = 0;
+    if (value > threshold) {
+      // Full brightness 32 above the threshold, with a soft start
+      level = min((uint16_t)(value - threshold) * 8, 255);
+      level = ((uint16_t)level * level) >> 8;
+    }
+
+    if (_ledType == LED_TYPE_SINGLE) {
+      _setState(i, level > 127);
+    } else {
+      Color color = _effectParams.color1;
+      _setColor(i, Color(((uint16_t)color.r * level) >> 8,
+                         ((uint16_t)color.g * level) >> 8,
+                         ((uint16_t)color.b * level) >> 8));
+    }
+  }
+}
+#endif
+
+#ifdef VIBELED_USE_FIRE_FLICKER_SOFT
+// Soft fire flicker (gentle, smooth flame brightness changes)
+void VibeLED::_effectFireFlickerSoft(uint16_t first, uint16_t last) {
+  uint16_t time = _step * 40;
+
+  for (uint16_t i = first; i <= last; i++) {
+    // Two octaves: slow swells with a little fast flicker on top
+    uint8_t value = _noise.fractal8((uint16_t)(i * 384U), time, 0, 2);
+
+    // Dims by up to a third; green and blue fall faster, so the flame
+    // turns redder as it dims
+    uint8_t level = 255 - value / 3;
+    uint8_t warm = ((uint16_t)level * level) >> 8;
+
+    if (_ledType == LED_TYPE_SINGLE) {
+      _setState(i, true);
+    } else {
+      Color color = _effectParams.color1;
+      _setColor(i, Color(((uint16_t)color.r * level) >> 8,
+                         ((uint16_t)color.g * warm) >> 8,
+                         ((uint16_t)color.b * warm) >> 8));
     }
   }
-}
\ No newline at end of file
+}
+#endif
+
+#ifdef VIBELED_USE_GRADIENT
+// Gradient effect: color1 to color2 across the group (option1 = 1 continues
+// to color3 in the second half)
+void VibeLED::_effectGradient(uint16_t first, uint16_t last) {
+  if (_ledType == LED_TYPE_SINGLE) {
+    _fillStates(first, last, true);
+    return;
+  }
+
+  if (_effectParams.option1 == 0) {
+    _gradient(_groupStart, _groupEnd, _effectParams.color1, _effectParams.color2, first, last);
+    return;
+  }
+
+  uint16_t middle = _groupStart + (_groupEnd - _groupStart) / 2;
+  if (first <= middle) {
+    _gradient(_groupStart, middle, _effectParams.color1, _effectParams.color2, first, min(last, middle));
+  }
+  if (last > middle) {
+    _gradient(middle, _groupEnd, _effectParams.color2, _effectParams.color3, max(first, (uint16_t)(middle + 1)), last);
+  }
+}
+#endif
\ No newline at end of file
@@ -9,11 +9,38 @@
 #define VibeLED_h
 
 #include "Arduino.h"
+#include "VibeLEDConfig.h"
+#include "VibeLEDNoise.h"
 
 // LED Types
 #define LED_TYPE_SINGLE 0
 #define LED_TYPE_RGB 1
 
+// Most skipped steps run per frame, unshown, in timebase mode and under the
+// frame-rate governor, so effects that evolve step by step (fire, meteor,
+// sparkle...) cover the same ground after a stall or at a low frame rate;
+// further steps are jumped
+#ifndef VIBELED_MAX_CATCH_UP
+#define VIBELED_MAX_CATCH_UP 16
+#endif
+
+// Channel order of encoded frames (encode() and VibeLEDPipeline)
+enum ColorOrder {
+  ORDER_RGB = 0,
+  ORDER_RBG = 1,
+  ORDER_GRB = 2,
+  ORDER_GBR = 3,
+  ORDER_BRG = 4,
+  ORDER_BGR = 5
+};
+
+// White channel of encoded frames (RGBW strips such as the SK6812)
+enum WhiteMode {
+  WHITE_NONE = 0,        // 3 bytes per LED
+  WHITE_MIN = 1,         // 4 bytes: the part common to R, G and B moves to white
+  WHITE_CALIBRATED = 2   // 4 bytes: as much white as the white LED's own color allows
+};
+
 // Effect IDs
 enum EffectType {
   EFFECT_NONE = 0,
@@ -86,6 +113,85 @@ struct Color {
   Color(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b) {}
 };
 
+// 16-bit per channel color, used by the high precision pipeline
+struct Color16 {
+  uint16_t r;
+  uint16_t g;
+  uint16_t b;
+
+  Color16() : r(0), g(0), b(0) {}
+  Color16(uint16_t r, uint16_t g, uint16_t b) : r(r), g(g), b(b) {}
+  Color16(Color color) : r(color.r * 257), g(color.g * 257), b(color.b * 257) {}
+};
+
+// Power limiter statistics (estimated supply current in mA)
+struct PowerStats {
+  uint32_t requested;      // Draw of the last frame at the requested brightness
+  uint32_t delivered;      // Draw of the last frame after limiting
+  uint8_t brightness;      // Brightness sent to the outputs for the last frame
+  uint32_t limitedFrames;  // Frames that had to be dimmed to stay in budget
+
+  PowerStats() :
+    requested(0),
+    delivered(0),
+    brightness(255),
+    limitedFrames(0) {}
+};
+
+// Frame timing statistics (times in microseconds)
+struct FrameStats {
+  uint32_t renderTime;     // Rendering the effect, last frame
+  uint32_t outputTime;     // Pushing to the outputs, last frame
+  uint32_t averageTime;    // Render plus output, smoothed over about 8 frames
+  uint32_t frames;         // Frames rendered
+  uint32_t lateFrames;     // Frames that started a whole frame interval late
+  uint16_t frameInterval;  // Current time between frames in ms
+  uint8_t headroom;        // Share of the frame interval left idle (percent)
+
+  FrameStats() :
+    renderTime(0),
+    outputTime(0),
+    averageTime(0),
+    frames(0),
+    lateFrames(0),
+    frameInterval(0),
+    headroom(100) {}
+};
+
+// Idle statistics of sleepUntilNextFrame()
+struct IdleStats {
+  uint32_t sleeps;          // Calls that slept
+  uint32_t wakes;           // Sleeps ended early by wake()
+  uint32_t sleepTime;       // Total time asleep in ms
+  uint32_t awakeTime;       // Time awake per second in us, over the last full second
+
+  IdleStats() :
+    sleeps(0),
+    wakes(0),
+    sleepTime(0),
+    awakeTime(1000000) {}
+};
+
+class VibeLED;
+
+// Output driver interface (shift registers, multiplexed matrices, ...)
+// Attach with VibeLED::setOutput() to replace the built-in pin output.
+class VibeLEDOutput {
+  public:
+    virtual ~VibeLEDOutput() {}
+    virtual void begin(VibeLED& leds) = 0;  // Called from VibeLED::begin()
+    virtual void show(VibeLED& leds) = 0;   // Called with every new frame
+};
+
+// Effect interface for effects implemented outside the library (e.g. VibeLEDVM).
+// Attach with VibeLED::setCustomEffect(); render() is called for every frame
+// while EFFECT_CUSTOM is active and writes LEDs first..last with setLED().
+class VibeLEDEffect {
+  public:
+    virtual ~VibeLEDEffect() {}
+    virtual void render(VibeLED& leds, uint16_t first, uint16_t last, uint16_t step, unsigned long now) = 0;
+};
+
 // Effect parameters structure
 struct EffectParams {
   uint16_t speed;      // Effect speed (lower = faster)
@@ -114,12 +220,23 @@ class VibeLED {
 
     // Basic methods
     void begin();
+    bool begin(const uint8_t* snapshot, uint32_t size);
     void update();
+    void update(unsigned long now);
     void clear();
 
     // Configuration methods
     void setBrightness(uint8_t brightness);
     void setDelay(uint16_t ms);
+    void setHighPrecision(bool enable);
+    void setPowerLimit(uint16_t milliamps, uint8_t milliampsPerChannel = 20);
+    PowerStats getPowerStats();
+    void setFrameRate(uint16_t minFps, uint16_t maxFps, uint8_t cpuShare = 50);
+    void resetFrameRate();
+    FrameStats getFrameStats();
+    unsigned long getTimeToNextFrame();
+    unsigned long getTimeToNextFrame(unsigned long now);
+    bool isStatic();
     void setColor(uint8_t r, uint8_t g, uint8_t b);
     void setColor(Color color);
 
@@ -129,7 +246,25 @@ class VibeLED {
     void setEffect(EffectType effect, uint16_t speed);
     void setEffect(EffectType effect, uint16_t speed, Color color);
     void setEffect(EffectType effect, uint16_t speed, uint8_t r, uint8_t g, uint8_t b);
+    void setEffect(const char* effectName);
     void setEffect(String effectName);
+    void setCustomEffect(VibeLEDEffect* effect);
+    void setParams(EffectParams params);
+    EffectParams getParams();
+
+    // Shared timebase (synchronized playback across controllers)
+    void setTimebase(unsigned long epoch, uint32_t seed = 0);
+    void resetTimebase();
+
+    // Low-power idle (between frames, or until wake() for static frames)
+    unsigned long sleepUntilNextFrame(unsigned long maxMs = 1000);
+    void wake();
+    IdleStats getIdleStats();
+
+    // Effect state snapshots (resume after a reset without a warm-up)
+    uint32_t getSnapshotSize();
+    uint32_t saveSnapshot(uint8_t* out, uint32_t size);
+    bool restoreSnapshot(const uint8_t* snapshot, uint32_t size);
 
     // Group control
     void setGroup(uint16_t startLed, uint16_t endLed);
@@ -140,52 +275,191 @@ class VibeLED {
     void setLED(uint16_t led, uint8_t r, uint8_t g, uint8_t b);
     void setLED(uint16_t led, Color color);
 
+    // Span control (LED ranges are inclusive and clipped to the strip)
+    void fillLEDs(uint16_t first, uint16_t last, bool state);
+    void fillLEDs(uint16_t first, uint16_t last, Color color);
+    void copyLEDs(uint16_t to, uint16_t from, uint16_t count);
+    void writeLEDs(uint16_t first, const uint8_t* rgb, uint16_t count);
+    void fillGradient(uint16_t first, uint16_t last, Color from, Color to);
+    void fillGradient(uint16_t first, uint16_t last, const Color* stops, uint8_t numStops);
+
+    // Output control
+    void setOutput(VibeLEDOutput* output);
+    void show();
+    void refresh();
+    void refresh(unsigned long now);
+
+    // Pipelined output: render without pushing, then copy out the frame
+    bool render(unsigned long now);
+    void setOutputFormat(ColorOrder order, WhiteMode white = WHITE_NONE,
+                         Color whiteColor = Color(255, 255, 255));
+    uint8_t getBytesPerLed();
+    void encode(uint8_t* out);
+    void encode(uint8_t* out, uint16_t first, uint16_t count);
+
+    // State queries
+    uint8_t getLEDType();
+    uint16_t getNumLeds();
+    EffectType getEffect();
+    uint8_t getBrightness();
+    uint8_t getOutputBrightness();
+    bool getLEDState(uint16_t led);
+    Color getLEDColor(uint16_t led);
+    Color getOutputColor(uint16_t led);
+
+    // Frames pushed to the outputs (or rendered) and micros() of the last one
+    uint32_t getPushCount();
+    unsigned long getLastPushTime();
+
+    // Color helpers
+    static Color hueToColor(uint8_t hue);
+
   private:
+    // Renders per-pixel effects in parallel tiles (VibeLEDTiles.h)
+    friend class VibeLEDTileRenderer;
+
     uint8_t _ledType;
     uint16_t _numLeds;
     uint16_t _groupStart;
     uint16_t _groupEnd;
     uint8_t* _pins;
     uint8_t _numPins;
+    VibeLEDOutput* _output;
 
     EffectType _currentEffect;
+    VibeLEDEffect* _customEffect;
     EffectParams _effectParams;
 
     unsigned long _lastUpdate;
     uint16_t _updateInterval;
     uint16_t _step;
+    uint32_t _pushes;
+    unsigned long _lastPush;
+
+    // Shared timebase
+    bool _timebase;
+    unsigned long _timebaseEpoch;
+    uint32_t _timebaseSeed;
+    uint32_t _timebaseStep;   // Last step rendered from the timebase
 
     // Internal state
     bool* _ledStates;       // For single color LEDs
     Color* _ledColors;      // For RGB LEDs
+    Color16* _ledColors16;  // Optional 16-bit working buffer (RGB only)
+    uint8_t* _ditherError;  // Temporal dithering remainders (3 per LED)
+    Color* _ditherColors;   // Dithered output colors of the last frame
+    uint8_t* _heat;         // Fire effect state (allocated on first use)
+#ifdef VIBELED_USE_NOISE
+    VibeLEDNoise _noise;    // Noise field for organic effects (seeded by setTimebase())
+#endif
+
+    // Power limiter
+    uint16_t _powerLimit;        // Supply budget in mA (0 = off)
+    uint8_t _powerPerChannel;    // mA drawn by one channel at full brightness
+    uint32_t _powerLevel;        // Running sum of all channel values
+    uint8_t _outputBrightness;   // Brightness after limiting
+    PowerStats _powerStats;
+
+    // Frame timing and rate governor
+    FrameStats _frameStats;
+    bool _governor;             // Frame rate follows the measured cost
+    uint16_t _minInterval;      // Frame interval at the highest frame rate (ms)
+    uint16_t _maxInterval;      // Frame interval at the lowest frame rate (ms)
+    uint8_t _cpuShare;          // Target share of time spent rendering and pushing (percent)
+    uint16_t _frameInterval;    // Frame interval chosen by the governor (ms)
+    unsigned long _stepClock;   // Start of the current effect step (governor only)
+    bool _pushPending;          // Push again without a new step (dithering)
+    bool _redraw;               // Settings changed since the last frame
+
+    // Low-power idle
+    IdleStats _idleStats;
+    volatile bool _wakeRequested;  // Set by wake(), possibly from an interrupt
+    unsigned long _idleWindow;     // Start of the current awake time window (us)
+    uint32_t _idleWindowSleep;     // Time asleep in the current window (us)
+    uint16_t _idleRemainder;       // Sleep time not yet added to sleepTime (us)
+
+    // Encoded frame format
+    uint8_t _whiteMode;          // WhiteMode
+    uint8_t _bytesPerLed;        // 3, or 4 with a white channel
+    uint8_t _channelOffset[4];   // Byte of R, G, B and W within an encoded LED
+    uint8_t _whiteColor[3];      // Color of the white LED (calibrated white)
+    uint32_t _whiteScale[3];     // 255 / white LED channel in 16.16 (calibrated white)
+    uint8_t _whiteMask[3];       // 0xFF for channels the white LED does not light
+
+    // Single LED writes go through these and spans through _fill*() and
+    // _moveLEDs(), so the power estimate stays current
+    void _setState(uint16_t led, bool state) {
+      if (_powerLimit > 0) {
+        _powerLevel += (state ? 255 : 0) - (_ledStates[led] ? 255 : 0);
+      }
+      _ledStates[led] = state;
+    }
+
+    void _setColor(uint16_t led, Color color) {
+      if (_powerLimit > 0) {
+        _powerLevel += ((uint16_t)color.r + color.g + color.b) -
+                       ((uint16_t)_ledColors[led].r + _ledColors[led].g + _ledColors[led].b);
+      }
+      _ledColors[led] = color;
+      if (_ledColors16 != nullptr) {
+        _ledColors16[led] = Color16(color);
+      }
+    }
 
     // Effect implementation methods
+    bool _frameDue(unsigned long now);
     void _updateEffect();
+    void _seedStep(uint32_t step);
+    bool _isPixelEffect();
+    void _renderPixels(uint16_t first, uint16_t last);
+    void _endFrame();
     void _applyStates();
+    void _recordPush();
+    void _recordRender(unsigned long start);
+    void _recordOutput(unsigned long start);
+    void _limitPower();
+    void _ditherFrame();
+    uint32_t _powerSum(uint16_t first, uint16_t last);
+    void _fillScaled(Color color, uint16_t level, uint16_t first, uint16_t last);
+    void _fillStates(uint16_t first, uint16_t last, bool state);
+    void _fillColors(uint16_t first, uint16_t last, Color color);
+    void _fillColors(uint16_t first, uint16_t last, Color color, Color16 wide);
+    void _fillLit(uint16_t first, uint16_t last, bool lit);
+    void _moveLEDs(uint16_t to, uint16_t from, uint16_t count);
+    void _gradient(uint16_t start, uint16_t end, Color from, Color to, uint16_t first, uint16_t last);
+    static uint8_t _dither(uint16_t value, uint16_t scale, uint8_t& error);
+    static uint16_t _lower(uint16_t a, uint16_t b);
+    static void _idle();
+    static void _writeValue(uint8_t*& out, uint32_t value, uint8_t size);
+    static uint32_t _readValue(const uint8_t*& in, uint8_t size);
+    static uint16_t _fletcher16(const uint8_t* data, uint32_t length);
 
     // Effect implementations
-    void _effectNone();
-    void _effectStatic();
-    void _effectBlink();
-    void _effectBreathe();
-    void _effectPulse();
-    void _effectFadeIn();
-    void _effectFadeOut();
+    void _effectNone(uint16_t first, uint16_t last);
+    void _effectStatic(uint16_t first, uint16_t last);
+    void _effectBlink(uint16_t first, uint16_t last);
+    void _effectBreathe(uint16_t first, uint16_t last);
+    void _effectPulse(uint16_t first, uint16_t last);
+    void _effectFadeIn(uint16_t first, uint16_t last);
+    void _effectFadeOut(uint16_t first, uint16_t last);
     void _effectKnightRider();
     void _effectCylon();
     void _effectMeteor();
     void _effectFire();
     void _effectWaterfall();
-    void _effectChase();
+    void _effectChase(uint16_t first, uint16_t last);
     void _effectStack();
-    void _effectRainbow();
+    void _effectRainbow(uint16_t first, uint16_t last);
     void _effectSparkle();
-    void _effectMarquee();
+    void _effectMarquee(uint16_t first, uint16_t last);
     void _effectBounce();
     void _effectColorWipe();
     void _effectRandomBlink();
     void _effectSnake();
-    void _effectWave();
+    void _effectWave(uint16_t first, uint16_t last);
+    void _effectTwinkle(uint16_t first, uint16_t last);
+    void _effectFireFlickerSoft(uint16_t first, uint16_t last);
+    void _effectGradient(uint16_t first, uint16_t last);
     // Additional effect methods will be implemented as needed
 };
 
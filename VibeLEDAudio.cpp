@@ -0,0 +1,280 @@
+/*
+  VibeLEDAudio.cpp - Audio-reactive band analyzer and modulation for VibeLED.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDAudio.h"
+
+// Constructor
+VibeLEDAudio::VibeLEDAudio(uint16_t sampleRate) {
+  _sampleRate = max(sampleRate, 1);
+  _numBands = 0;
+  _numBindings = 0;
+
+  _attack = 160;
+  _release = 24;
+
+  _beatBand = 0;
+  _beatThreshold = 24;  // 1.5x the running average
+  _beatHold = 150;
+  _beatAverage = 0;
+  _sinceBeat = 0;
+  _beat = false;
+  _beatPulse = 0;
+
+  resetStats();
+}
+
+// Add a band centered on the given frequency (Hz); returns false when full
+// or when the frequency is not between 0 Hz and half the sample rate
+bool VibeLEDAudio::addBand(uint16_t frequency) {
+  if (_numBands >= VIBELED_AUDIO_MAX_BANDS || frequency >= _sampleRate / 2) {
+    return false;
+  }
+
+  // The coefficient is computed once here; process() is integer only.
+  // 2 * cos(w) must stay below 2.0 to fit in Q14, which rules out
+  // frequencies at or very close to 0 Hz
+  double coeff = 2.0 * cos(2.0 * PI * frequency / _sampleRate) * 16384.0;
+  if (coeff >= 32768.0) {
+    return false;
+  }
+
+  _coeff[_numBands] = (int16_t)coeff;
+  _magnitude[_numBands] = 0;
+  _peak[_numBands] = 16;
+  _envelope[_numBands] = 0;
+  _numBands++;
+  return true;
+}
+
+// Remove all bands
+void VibeLEDAudio::clearBands() {
+  _numBands = 0;
+}
+
+// Set how fast the band levels follow the signal (0-255, higher = faster)
+void VibeLEDAudio::setResponse(uint8_t attack, uint8_t release) {
+  _attack = attack;
+  _release = release;
+}
+
+// Select the band used for beat detection (usually the lowest)
+void VibeLEDAudio::setBeatBand(uint8_t band) {
+  _beatBand = band;
+}
+
+// A beat is detected when the beat band exceeds its running average by
+// threshold/16 (24 = 1.5x), at most once every holdMs milliseconds
+void VibeLEDAudio::setBeatSensitivity(uint8_t threshold, uint16_t holdMs) {
+  _beatThreshold = max(threshold, 17);
+  _beatHold = holdMs;
+}
+
+// Analyze one block of signed samples
+void VibeLEDAudio::process(const int16_t* samples, uint16_t count) {
+  unsigned long start = micros();
+
+  if (count > VIBELED_AUDIO_MAX_BLOCK) count = VIBELED_AUDIO_MAX_BLOCK;
+  if (count == 0) return;
+
+  uint16_t magnitudes[VIBELED_AUDIO_MAX_BANDS];
+
+  for (uint8_t b = 0; b < _numBands; b++) {
+    int16_t coeff = _coeff[b];
+    int32_t s1 = 0;
+    int32_t s2 = 0;
+
+    // Goertzel recurrence; input is pre-scaled so the state stays well inside 32 bits
+    for (uint16_t n = 0; n < count; n++) {
+      int32_t s0 = (samples[n] >> 2) + _mulQ14(coeff, s1) - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+
+    // Bring the state into 15 bits so the power fits in 32 bits
+    uint8_t shift = 0;
+    while (s1 > 16383 || s1 < -16383 || s2 > 16383 || s2 < -16383) {
+      s1 >>= 1;
+      s2 >>= 1;
+      shift++;
+    }
+
+    int32_t power = s1 * s1 + s2 * s2 - _mulQ14(coeff, s1) * s2;
+    uint32_t magnitude = (uint32_t)_sqrt32(power > 0 ? power : 0) << shift;
+
+    // Normalize to an amplitude independent of the block length
+    magnitude = (magnitude * 2) / count;
+    magnitudes[b] = (magnitude > 65535) ? 65535 : magnitude;
+    _magnitude[b] = magnitudes[b];
+  }
+
+  // Auto gain and envelope per band
+  for (uint8_t b = 0; b < _numBands; b++) {
+    uint16_t magnitude = magnitudes[b];
+
+    _peak[b] -= _peak[b] >> 6;
+    if (magnitude > _peak[b]) _peak[b] = magnitude;
+    if (_peak[b] < 16) _peak[b] = 16;
+
+    uint8_t level = ((uint32_t)magnitude * 255) / _peak[b];
+    if (level > _envelope[b]) {
+      _envelope[b] += ((uint16_t)(level - _envelope[b]) * _attack + 255) >> 8;
+    } else {
+      _envelope[b] -= ((uint16_t)(_envelope[b] - level) * _release + 255) >> 8;
+    }
+  }
+
+  // Beat detection on the selected band
+  _beat = false;
+  // Counted in samples so no fraction of a millisecond is lost per block;
+  // saturates where sinceBeat * 1000 would overflow
+  _sinceBeat += count;
+  if (_sinceBeat > 0xFFFFFFFFUL / 1000) _sinceBeat = 0xFFFFFFFFUL / 1000;
+  _beatPulse -= ((uint16_t)_beatPulse * _release + 255) >> 8;
+
+  if (_beatBand < _numBands) {
+    uint16_t magnitude = magnitudes[_beatBand];
+
+    if ((uint32_t)magnitude * 16 > (uint32_t)_beatAverage * _beatThreshold &&
+        magnitude > 16 && _sinceBeat * 1000 >= (uint32_t)_beatHold * _sampleRate) {
+      _beat = true;
+      _beatPulse = 255;
+      _sinceBeat = 0;
+      _stats.beats++;
+    }
+
+    _beatAverage += ((int32_t)magnitude - (int32_t)_beatAverage) / 8;
+  }
+
+  _stats.blocks++;
+  _stats.lastMicros = micros() - start;
+  if (_stats.lastMicros > _stats.maxMicros) {
+    _stats.maxMicros = _stats.lastMicros;
+  }
+}
+
+// Get the smoothed level of one band (0-255)
+uint8_t VibeLEDAudio::getBand(uint8_t band) {
+  return (band < _numBands) ? _envelope[band] : 0;
+}
+
+// Get the amplitude of one band in the last block, before auto gain
+// (about a quarter of a sine's sample amplitude at the band frequency)
+uint16_t VibeLEDAudio::getMagnitude(uint8_t band) {
+  return (band < _numBands) ? _magnitude[band] : 0;
+}
+
+// Get the average level of all bands (0-255)
+uint8_t VibeLEDAudio::getLevel() {
+  if (_numBands == 0) return 0;
+
+  uint16_t sum = 0;
+  for (uint8_t b = 0; b < _numBands; b++) {
+    sum += _envelope[b];
+  }
+  return sum / _numBands;
+}
+
+// Get any modulation source (band index, AUDIO_SOURCE_BEAT or AUDIO_SOURCE_LEVEL)
+uint8_t VibeLEDAudio::getSource(uint8_t source) {
+  if (source == AUDIO_SOURCE_BEAT) return _beatPulse;
+  if (source == AUDIO_SOURCE_LEVEL) return getLevel();
+  return getBand(source);
+}
+
+// True if the last processed block contained a beat
+bool VibeLEDAudio::isBeat() {
+  return _beat;
+}
+
+// Map a source onto an effect parameter; returns false when all bindings are used
+bool VibeLEDAudio::bind(uint8_t source, ModulationTarget target, uint16_t minValue, uint16_t maxValue) {
+  if (_numBindings >= VIBELED_AUDIO_MAX_BINDINGS) return false;
+
+  _bindings[_numBindings].source = source;
+  _bindings[_numBindings].target = target;
+  _bindings[_numBindings].minValue = minValue;
+  _bindings[_numBindings].maxValue = maxValue;
+  _numBindings++;
+  return true;
+}
+
+// Remove all bindings
+void VibeLEDAudio::clearBindings() {
+  _numBindings = 0;
+}
+
+// Apply all bindings to the effect parameters (keeps the effect running)
+void VibeLEDAudio::apply(VibeLED& leds) {
+  if (_numBindings == 0) return;
+
+  EffectParams params = leds.getParams();
+
+  for (uint8_t i = 0; i < _numBindings; i++) {
+    Binding& binding = _bindings[i];
+    uint8_t value = getSource(binding.source);
+    int32_t range = (int32_t)binding.maxValue - binding.minValue;
+    uint16_t mapped = binding.minValue + (range * value) / 255;
+
+    switch (binding.target) {
+      case MOD_SPEED:
+        params.speed = max(mapped, 1);
+        break;
+      case MOD_BRIGHTNESS:
+        params.brightness = min(mapped, 255);
+        break;
+      case MOD_OPTION1:
+        params.option1 = min(mapped, 255);
+        break;
+      case MOD_OPTION2:
+        params.option2 = min(mapped, 255);
+        break;
+      case MOD_HUE:
+        params.color1 = VibeLED::hueToColor(mapped);
+        break;
+    }
+  }
+
+  leds.setParams(params);
+}
+
+// Get analyzer statistics
+AudioStats VibeLEDAudio::getStats() {
+  return _stats;
+}
+
+// Reset analyzer statistics
+void VibeLEDAudio::resetStats() {
+  _stats.blocks = 0;
+  _stats.beats = 0;
+  _stats.lastMicros = 0;
+  _stats.maxMicros = 0;
+}
+
+// (coeff * value) >> 14 without overflowing 32 bits for |value| < 2^27
+int32_t VibeLEDAudio::_mulQ14(int16_t coeff, int32_t value) {
+  int32_t high = value >> 14;
+  int32_t low = value & 0x3FFF;
+  return (int32_t)coeff * high + (((int32_t)coeff * low) >> 14);
+}
+
+// Integer square root
+uint16_t VibeLEDAudio::_sqrt32(uint32_t value) {
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
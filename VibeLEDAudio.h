@@ -0,0 +1,115 @@
+/*
+  VibeLEDAudio.h - Audio-reactive band analyzer and modulation for VibeLED.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDAudio_h
+#define VibeLEDAudio_h
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+// Limits that bound the cost of process() and the RAM used
+#ifndef VIBELED_AUDIO_MAX_BANDS
+#define VIBELED_AUDIO_MAX_BANDS 8
+#endif
+#ifndef VIBELED_AUDIO_MAX_BLOCK
+#define VIBELED_AUDIO_MAX_BLOCK 256
+#endif
+#ifndef VIBELED_AUDIO_MAX_BINDINGS
+#define VIBELED_AUDIO_MAX_BINDINGS 4
+#endif
+
+// Modulation sources besides the band indexes 0..VIBELED_AUDIO_MAX_BANDS-1
+#define AUDIO_SOURCE_BEAT 0x80   // 255 on every beat, decaying with the release rate
+#define AUDIO_SOURCE_LEVEL 0x81  // Average of all band levels
+
+// Effect parameters a modulation source can drive
+enum ModulationTarget {
+  MOD_SPEED = 0,
+  MOD_BRIGHTNESS = 1,
+  MOD_OPTION1 = 2,
+  MOD_OPTION2 = 3,
+  MOD_HUE = 4          // Sets color1 to a fully saturated hue
+};
+
+// Analyzer statistics
+struct AudioStats {
+  uint32_t blocks;      // Sample blocks processed
+  uint32_t beats;       // Beats detected
+  uint32_t lastMicros;  // Time spent in the last process() call
+  uint32_t maxMicros;   // Worst process() time since resetStats()
+};
+
+// Band energy analyzer built on fixed-point Goertzel filters. Each block costs
+// at most VIBELED_AUDIO_MAX_BLOCK * bands filter steps (two 32-bit multiplies
+// each) plus one square root per band, so its run time is bounded up front.
+//
+// Feed blocks of signed samples (subtract the ADC midpoint first); band levels
+// are auto-gained to 0-255 and smoothed with an attack/release envelope.
+class VibeLEDAudio {
+  public:
+    VibeLEDAudio(uint16_t sampleRate);
+
+    // Configuration
+    bool addBand(uint16_t frequency);
+    void clearBands();
+    void setResponse(uint8_t attack, uint8_t release);
+    void setBeatBand(uint8_t band);
+    void setBeatSensitivity(uint8_t threshold, uint16_t holdMs = 150);
+
+    // Analysis
+    void process(const int16_t* samples, uint16_t count);
+    uint8_t getBand(uint8_t band);
+    uint16_t getMagnitude(uint8_t band);
+    uint8_t getLevel();
+    uint8_t getSource(uint8_t source);
+    bool isBeat();
+
+    // Modulation
+    bool bind(uint8_t source, ModulationTarget target, uint16_t minValue, uint16_t maxValue);
+    void clearBindings();
+    void apply(VibeLED& leds);
+
+    // Statistics
+    AudioStats getStats();
+    void resetStats();
+
+  private:
+    struct Binding {
+      uint8_t source;
+      ModulationTarget target;
+      uint16_t minValue;
+      uint16_t maxValue;
+    };
+
+    uint16_t _sampleRate;
+    uint8_t _numBands;
+    int16_t _coeff[VIBELED_AUDIO_MAX_BANDS];   // 2 * cos(w), Q14
+    uint16_t _magnitude[VIBELED_AUDIO_MAX_BANDS];  // Last block, before auto gain
+    uint16_t _peak[VIBELED_AUDIO_MAX_BANDS];   // Auto-gain reference
+    uint8_t _envelope[VIBELED_AUDIO_MAX_BANDS];
+
+    uint8_t _attack;
+    uint8_t _release;
+
+    uint8_t _beatBand;
+    uint8_t _beatThreshold;     // Ratio over the running average, in 1/16ths
+    uint16_t _beatHold;         // Minimum time between beats (ms)
+    uint16_t _beatAverage;
+    uint32_t _sinceBeat;        // Samples since the last beat (saturating)
+    bool _beat;
+    uint8_t _beatPulse;
+
+    Binding _bindings[VIBELED_AUDIO_MAX_BINDINGS];
+    uint8_t _numBindings;
+
+    AudioStats _stats;
+
+    static int32_t _mulQ14(int16_t coeff, int32_t value);
+    static uint16_t _sqrt32(uint32_t value);
+};
+
+#endif
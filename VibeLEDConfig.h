@@ -0,0 +1,63 @@
+/*
+  VibeLEDConfig.h - Compile-time selection of the built-in effects.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDConfig_h
+#define VibeLEDConfig_h
+
+// Every built-in effect is compiled by default. To save flash and RAM on
+// small boards, define VIBELED_SELECT_EFFECTS and enable only the effects
+// you use, below or as build flags for the whole project (the library
+// sources must see the same settings as your sketch):
+//
+//   -DVIBELED_SELECT_EFFECTS -DVIBELED_USE_BREATHE -DVIBELED_USE_STATIC
+//
+// Effects that are left out behave like EFFECT_NONE, and their names are
+// not compiled into setEffect(name). EFFECT_NONE and EFFECT_CUSTOM are
+// always available. extras/sizes reports the cost of each effect.
+
+// #define VIBELED_SELECT_EFFECTS
+// #define VIBELED_USE_STATIC 1
+// #define VIBELED_USE_BREATHE 1
+
+#ifndef VIBELED_SELECT_EFFECTS
+#define VIBELED_USE_STATIC 1
+#define VIBELED_USE_BLINK 1
+#define VIBELED_USE_BREATHE 1
+#define VIBELED_USE_PULSE 1
+#define VIBELED_USE_FADE_IN 1
+#define VIBELED_USE_FADE_OUT 1
+#define VIBELED_USE_KNIGHT_RIDER 1
+#define VIBELED_USE_CYLON 1
+#define VIBELED_USE_METEOR 1
+#define VIBELED_USE_FIRE 1
+#define VIBELED_USE_WATERFALL 1
+#define VIBELED_USE_CHASE 1
+#define VIBELED_USE_STACK 1
+#define VIBELED_USE_RAINBOW 1
+#define VIBELED_USE_SPARKLE 1
+#define VIBELED_USE_MARQUEE 1
+#define VIBELED_USE_BOUNCE 1
+#define VIBELED_USE_COLOR_WIPE 1
+#define VIBELED_USE_RANDOM_BLINK 1
+#define VIBELED_USE_SNAKE 1
+#define VIBELED_USE_WAVE 1
+#define VIBELED_USE_TWINKLE 1
+#define VIBELED_USE_FIRE_FLICKER_SOFT 1
+#define VIBELED_USE_GRADIENT 1
+#endif
+
+// Fade in ends on EFFECT_STATIC
+#if defined(VIBELED_USE_FADE_IN) && !defined(VIBELED_USE_STATIC)
+#define VIBELED_USE_STATIC 1
+#endif
+
+// Effects built on VibeLEDNoise
+#if defined(VIBELED_USE_TWINKLE) || defined(VIBELED_USE_FIRE_FLICKER_SOFT)
+#define VIBELED_USE_NOISE 1
+#endif
+
+#endif
@@ -0,0 +1,481 @@
+/*
+  VibeLEDMatrixOutput.cpp - Multiplexed (row/column or charlieplexed) output for VibeLED.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDMatrixOutput.h"
+#include "VibeLEDProfile.h"
+
+// Constructor for a row/column matrix (up to 32 columns)
+VibeLEDMatrixOutput::VibeLEDMatrixOutput(const uint8_t* rowPins, uint8_t numRows, const uint8_t* colPins, uint8_t numCols) {
+  _charlieplex = false;
+  _numSlots = numRows;
+  _numMaskPins = min(numCols, 32);
+  _slotPins = new uint8_t[_numSlots];
+  _maskPins = new uint8_t[_numMaskPins];
+  VIBELED_PROFILE_ALLOCATION(_numSlots);
+  VIBELED_PROFILE_ALLOCATION(_numMaskPins);
+  for (uint8_t i = 0; i < _numSlots; i++) {
+    _slotPins[i] = rowPins[i];
+  }
+  for (uint8_t i = 0; i < _numMaskPins; i++) {
+    _maskPins[i] = colPins[i];
+  }
+
+  _tables = nullptr;
+  _front = nullptr;
+  _back = nullptr;
+  _pending = false;
+
+#if defined(__AVR__)
+  _numPorts = 0;
+  _outputRegs = nullptr;
+  _modeRegs = nullptr;
+  _slotPorts = nullptr;
+  _maskPorts = nullptr;
+  _columnMasks = nullptr;
+  _portTables = nullptr;
+  _frontPorts = nullptr;
+  _backPorts = nullptr;
+#else
+  _driven = 0;
+#endif
+
+  _slot = 0;
+  _lit = false;
+  _brightness = 255;
+  _scanRate = 100;
+  _dutyCycle = 100;
+  _updateTiming();
+
+  resetStats();
+}
+
+// Constructor for charlieplexed LEDs (up to 32 pins)
+VibeLEDMatrixOutput::VibeLEDMatrixOutput(const uint8_t* pins, uint8_t numPins) {
+  _charlieplex = true;
+  _numSlots = min(numPins, 32);
+  _numMaskPins = _numSlots;
+  _slotPins = new uint8_t[_numSlots];
+  VIBELED_PROFILE_ALLOCATION(_numSlots);
+  _maskPins = _slotPins;
+  for (uint8_t i = 0; i < _numSlots; i++) {
+    _slotPins[i] = pins[i];
+  }
+
+  _tables = nullptr;
+  _front = nullptr;
+  _back = nullptr;
+  _pending = false;
+
+#if defined(__AVR__)
+  _numPorts = 0;
+  _outputRegs = nullptr;
+  _modeRegs = nullptr;
+  _slotPorts = nullptr;
+  _maskPorts = nullptr;
+  _columnMasks = nullptr;
+  _portTables = nullptr;
+  _frontPorts = nullptr;
+  _backPorts = nullptr;
+#else
+  _driven = 0;
+#endif
+
+  _slot = 0;
+  _lit = false;
+  _brightness = 255;
+  _scanRate = 100;
+  _dutyCycle = 100;
+  _updateTiming();
+
+  resetStats();
+}
+
+// Destructor
+VibeLEDMatrixOutput::~VibeLEDMatrixOutput() {
+  if (_maskPins != _slotPins) {
+    delete[] _maskPins;
+  }
+  delete[] _slotPins;
+  delete[] _tables;
+
+#if defined(__AVR__)
+  if (_maskPorts != _slotPorts) {
+    delete[] _maskPorts;
+  }
+  delete[] _slotPorts;
+  delete[] _outputRegs;
+  delete[] _modeRegs;
+  delete[] _columnMasks;
+  delete[] _portTables;
+#endif
+}
+
+// Initialize pins and allocate the scan tables
+void VibeLEDMatrixOutput::begin(VibeLED& leds) {
+  if (_charlieplex) {
+    for (uint8_t i = 0; i < _numSlots; i++) {
+      pinMode(_slotPins[i], INPUT);
+    }
+  } else {
+    for (uint8_t i = 0; i < _numSlots; i++) {
+      pinMode(_slotPins[i], OUTPUT);
+      digitalWrite(_slotPins[i], LOW);
+    }
+    for (uint8_t i = 0; i < _numMaskPins; i++) {
+      pinMode(_maskPins[i], OUTPUT);
+      digitalWrite(_maskPins[i], HIGH);
+    }
+  }
+
+  delete[] _tables;
+  _tables = new uint32_t[(uint16_t)_numSlots * 2];
+  VIBELED_PROFILE_ALLOCATION(sizeof(uint32_t) * _numSlots * 2);
+  for (uint16_t i = 0; i < (uint16_t)_numSlots * 2; i++) {
+    _tables[i] = 0;
+  }
+  _front = _tables;
+  _back = _tables + _numSlots;
+
+#if defined(__AVR__)
+  // Resolve every pin to its port registers once
+  if (_maskPorts != _slotPorts) {
+    delete[] _maskPorts;
+  }
+  delete[] _slotPorts;
+  delete[] _outputRegs;
+  delete[] _modeRegs;
+  delete[] _columnMasks;
+  delete[] _portTables;
+
+  uint8_t numPins = _charlieplex ? _numSlots : _numSlots + _numMaskPins;
+  _outputRegs = new volatile uint8_t*[numPins];
+  _modeRegs = new volatile uint8_t*[numPins];
+  _numPorts = 0;
+
+  _slotPorts = new PortPin[_numSlots];
+  for (uint8_t i = 0; i < _numSlots; i++) {
+    _slotPorts[i].port = _portIndex(_slotPins[i]);
+    _slotPorts[i].mask = digitalPinToBitMask(_slotPins[i]);
+  }
+  if (_charlieplex) {
+    _maskPorts = _slotPorts;
+  } else {
+    _maskPorts = new PortPin[_numMaskPins];
+    for (uint8_t i = 0; i < _numMaskPins; i++) {
+      _maskPorts[i].port = _portIndex(_maskPins[i]);
+      _maskPorts[i].mask = digitalPinToBitMask(_maskPins[i]);
+    }
+  }
+
+  _columnMasks = new uint8_t[_numPorts];
+  for (uint8_t p = 0; p < _numPorts; p++) {
+    _columnMasks[p] = 0;
+  }
+  if (!_charlieplex) {
+    for (uint8_t i = 0; i < _numMaskPins; i++) {
+      _columnMasks[_maskPorts[i].port] |= _maskPorts[i].mask;
+    }
+  }
+
+  uint16_t portTableSize = (uint16_t)_numSlots * _numPorts;
+  _portTables = new uint8_t[portTableSize * 2];
+  VIBELED_PROFILE_ALLOCATION(numPins * 2 * sizeof(volatile uint8_t*) + portTableSize * 2 + _numPorts);
+  _frontPorts = _portTables;
+  _backPorts = _portTables + portTableSize;
+  _buildPorts(_front, _frontPorts);
+#else
+  _driven = 0;
+#endif
+
+  _brightness = leds.getOutputBrightness();
+  _updateTiming();
+  _slot = 0;
+  _lit = false;
+  _slotStart = micros();
+}
+
+// Convert a frame into per-slot pin masks
+void VibeLEDMatrixOutput::show(VibeLED& leds) {
+  if (_tables == nullptr) return;
+
+  // Keep refresh() from swapping in half-built tables
+  _pending = false;
+
+  // Brightness is applied as on-time within each slot
+  if (leds.getOutputBrightness() != _brightness) {
+    _brightness = leds.getOutputBrightness();
+    _updateTiming();
+  }
+
+  uint8_t perSlot = _charlieplex ? _numSlots - 1 : _numMaskPins;
+  uint16_t numLeds = min(leds.getNumLeds(), (uint16_t)_numSlots * perSlot);
+  bool rgb = leds.getLEDType() == LED_TYPE_RGB;
+
+  for (uint8_t s = 0; s < _numSlots; s++) {
+    _back[s] = 0;
+  }
+
+  uint8_t slot = 0;
+  uint8_t index = 0;
+  for (uint16_t i = 0; i < numLeds; i++) {
+    bool on;
+    if (rgb) {
+      Color color = leds.getLEDColor(i);
+      on = (color.r | color.g | color.b) != 0;
+    } else {
+      on = leds.getLEDState(i);
+    }
+
+    if (on) {
+      // Charlieplexed cathodes skip the anode pin
+      uint8_t pin = (_charlieplex && index >= slot) ? index + 1 : index;
+      _back[slot] |= (uint32_t)1 << pin;
+    }
+
+    if (++index >= perSlot) {
+      index = 0;
+      slot++;
+    }
+  }
+
+  // Only hand the new tables to refresh() if the frame changed
+  bool changed = false;
+  for (uint8_t s = 0; s < _numSlots; s++) {
+    if (_back[s] != _front[s]) {
+      changed = true;
+      break;
+    }
+  }
+
+  if (changed) {
+#if defined(__AVR__)
+    _buildPorts(_back, _backPorts);
+#endif
+    _tableBuilds++;
+    _pending = true;
+  }
+}
+
+// Set the scan rate (complete scans of all slots per second)
+void VibeLEDMatrixOutput::setScanRate(uint16_t hz) {
+  _scanRate = max(hz, 1);
+  _updateTiming();
+}
+
+// Set the on-time within each slot (1-100 percent)
+void VibeLEDMatrixOutput::setDutyCycle(uint8_t percent) {
+  _dutyCycle = constrain(percent, 1, 100);
+  _updateTiming();
+}
+
+// Advance the scan; constant time per call
+void VibeLEDMatrixOutput::refresh() {
+  if (_tables == nullptr) return;
+
+  unsigned long now = micros();
+  unsigned long elapsed = now - _slotStart;
+
+  // Blank the current slot once its on-time is over
+  if (_lit && elapsed >= _onMicros) {
+    _blank(_slot);
+    _lit = false;
+  }
+
+  if (elapsed < _slotMicros) return;
+
+  _slot++;
+  if (_slot >= _numSlots) {
+    _slot = 0;
+    _scans++;
+
+    // Only swap tables between scans so every scan is consistent
+    if (_pending) {
+      uint32_t* swap = _front;
+      _front = _back;
+      _back = swap;
+#if defined(__AVR__)
+      uint8_t* swapPorts = _frontPorts;
+      _frontPorts = _backPorts;
+      _backPorts = swapPorts;
+#endif
+      _pending = false;
+    }
+  }
+
+  _slotStart += _slotMicros;
+  if (now - _slotStart >= _slotMicros) {
+    _slotStart = now;
+  }
+
+  if (_onMicros > 0) {
+    _light(_slot);
+    _lit = true;
+  }
+}
+
+// Get output statistics
+MatrixOutputStats VibeLEDMatrixOutput::getStats() {
+  MatrixOutputStats stats;
+
+  // refresh() may update these from a timer interrupt
+  noInterrupts();
+  uint32_t scans = _scans;
+  unsigned long statsStart = _statsStart;
+  unsigned long slotMicros = _slotMicros;
+  unsigned long onMicros = _onMicros;
+  interrupts();
+
+  unsigned long elapsed = micros() - statsStart;
+  stats.scans = scans;
+  stats.tableBuilds = _tableBuilds;
+  stats.scanRate = (elapsed > 0) ? (uint16_t)(((uint64_t)scans * 1000000UL) / elapsed) : 0;
+  stats.slots = _numSlots;
+  stats.dutyCycle = _dutyCycle;
+  stats.ledDuty = (slotMicros > 0) ? (uint16_t)((onMicros * 1000UL) / (slotMicros * _numSlots)) : 0;
+
+  return stats;
+}
+
+// Reset output statistics
+void VibeLEDMatrixOutput::resetStats() {
+  _statsStart = micros();
+  _scans = 0;
+  _tableBuilds = 0;
+}
+
+// Recalculate slot and on-time lengths
+void VibeLEDMatrixOutput::_updateTiming() {
+  unsigned long slotMicros = 1000000UL / ((uint32_t)_scanRate * max(_numSlots, 1));
+  if (slotMicros == 0) slotMicros = 1;
+  unsigned long onMicros = (((slotMicros * _dutyCycle) / 100) * _brightness) / 255;
+
+  // refresh() may run from a timer interrupt; on 8-bit boards it could
+  // otherwise read a half-written value
+  noInterrupts();
+  _slotMicros = slotMicros;
+  _onMicros = onMicros;
+  interrupts();
+}
+
+#if defined(__AVR__)
+// Index of the pin's port in _outputRegs/_modeRegs, adding it if new
+uint8_t VibeLEDMatrixOutput::_portIndex(uint8_t pin) {
+  uint8_t port = digitalPinToPort(pin);
+  volatile uint8_t* output = portOutputRegister(port);
+  for (uint8_t p = 0; p < _numPorts; p++) {
+    if (_outputRegs[p] == output) return p;
+  }
+  _outputRegs[_numPorts] = output;
+  _modeRegs[_numPorts] = portModeRegister(port);
+  return _numPorts++;
+}
+
+// Split each slot's pin mask into port masks: the lit cathodes when
+// charlieplexing, the unlit (HIGH) columns of a row/column matrix
+void VibeLEDMatrixOutput::_buildPorts(const uint32_t* masks, uint8_t* ports) {
+  for (uint8_t s = 0; s < _numSlots; s++) {
+    uint8_t* slotPorts = ports + (uint16_t)s * _numPorts;
+    for (uint8_t p = 0; p < _numPorts; p++) {
+      slotPorts[p] = 0;
+    }
+    for (uint8_t i = 0; i < _numMaskPins; i++) {
+      bool lit = (masks[s] & ((uint32_t)1 << i)) != 0;
+      if (lit == _charlieplex) {
+        slotPorts[_maskPorts[i].port] |= _maskPorts[i].mask;
+      }
+    }
+  }
+}
+
+// Drive one slot
+void VibeLEDMatrixOutput::_light(uint8_t slot) {
+  const uint8_t* masks = _frontPorts + (uint16_t)slot * _numPorts;
+  const PortPin& anode = _slotPorts[slot];
+  uint8_t sreg = SREG;
+  cli();
+
+  if (_charlieplex) {
+    // Lit cathodes become LOW outputs, then the anode a HIGH output
+    for (uint8_t p = 0; p < _numPorts; p++) {
+      *_outputRegs[p] &= ~masks[p];
+      *_modeRegs[p] |= masks[p];
+    }
+    *_outputRegs[anode.port] |= anode.mask;
+    *_modeRegs[anode.port] |= anode.mask;
+  } else {
+    for (uint8_t p = 0; p < _numPorts; p++) {
+      *_outputRegs[p] = (*_outputRegs[p] & ~_columnMasks[p]) | masks[p];
+    }
+    *_outputRegs[anode.port] |= anode.mask;
+  }
+
+  SREG = sreg;
+}
+
+// Turn one slot off
+void VibeLEDMatrixOutput::_blank(uint8_t slot) {
+  const PortPin& anode = _slotPorts[slot];
+  uint8_t sreg = SREG;
+  cli();
+
+  if (_charlieplex) {
+    // Back to inputs without pull-ups (the cathode bits are already LOW)
+    const uint8_t* masks = _frontPorts + (uint16_t)slot * _numPorts;
+    *_modeRegs[anode.port] &= ~anode.mask;
+    *_outputRegs[anode.port] &= ~anode.mask;
+    for (uint8_t p = 0; p < _numPorts; p++) {
+      *_modeRegs[p] &= ~masks[p];
+    }
+  } else {
+    *_outputRegs[anode.port] &= ~anode.mask;
+  }
+
+  SREG = sreg;
+}
+#else
+// Drive one slot
+void VibeLEDMatrixOutput::_light(uint8_t slot) {
+  uint32_t mask = _front[slot];
+
+  if (_charlieplex) {
+    // Only the lit cathodes change
+    for (uint8_t i = 0; mask != 0; i++, mask >>= 1) {
+      if (mask & 1) {
+        pinMode(_maskPins[i], OUTPUT);
+        digitalWrite(_maskPins[i], LOW);
+      }
+    }
+    pinMode(_slotPins[slot], OUTPUT);
+    digitalWrite(_slotPins[slot], HIGH);
+  } else {
+    // Columns keep their level between slots; write only the ones that change
+    uint32_t changed = mask ^ _driven;
+    for (uint8_t i = 0; changed != 0; i++, changed >>= 1) {
+      if (changed & 1) {
+        digitalWrite(_maskPins[i], (mask & ((uint32_t)1 << i)) ? LOW : HIGH);
+      }
+    }
+    _driven = mask;
+    digitalWrite(_slotPins[slot], HIGH);
+  }
+}
+
+// Turn one slot off
+void VibeLEDMatrixOutput::_blank(uint8_t slot) {
+  if (_charlieplex) {
+    uint32_t mask = _front[slot];
+    pinMode(_slotPins[slot], INPUT);
+    for (uint8_t i = 0; mask != 0; i++, mask >>= 1) {
+      if (mask & 1) {
+        pinMode(_maskPins[i], INPUT);
+      }
+    }
+  } else {
+    digitalWrite(_slotPins[slot], LOW);
+  }
+}
+#endif
@@ -0,0 +1,107 @@
+/*
+  VibeLEDMatrixOutput.h - Multiplexed (row/column or charlieplexed) output for VibeLED.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDMatrixOutput_h
+#define VibeLEDMatrixOutput_h
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+// Multiplexed output statistics
+struct MatrixOutputStats {
+  uint32_t scans;        // Complete scans (all slots) since resetStats()
+  uint32_t tableBuilds;  // Frames that changed the scan tables
+  uint16_t scanRate;     // Measured scan rate (Hz)
+  uint8_t slots;         // Scan slots per frame
+  uint8_t dutyCycle;     // Configured on-time within each slot (percent)
+  uint16_t ledDuty;      // Effective on-time of a lit LED (per mille)
+};
+
+// Drives single color LEDs multiplexed over a few pins, one scan slot at a time.
+//
+// Row/column matrix: LED (row, col) is index row * numCols + col. A slot drives
+// one row HIGH and pulls the columns of lit LEDs LOW.
+//
+// Charlieplexing: n pins drive n * (n - 1) LEDs. A slot drives one anode pin
+// HIGH and pulls the cathodes of lit LEDs LOW; all other pins float. LED index
+// is anode * (n - 1) + cathode, where cathode skips the anode pin.
+//
+// show() turns a frame into one pin mask per slot, and only swaps the tables
+// in when the frame actually changed. refresh() then just lights the next slot,
+// so call it as often as possible (from loop() or a timer interrupt).
+class VibeLEDMatrixOutput : public VibeLEDOutput {
+  public:
+    VibeLEDMatrixOutput(const uint8_t* rowPins, uint8_t numRows, const uint8_t* colPins, uint8_t numCols);
+    VibeLEDMatrixOutput(const uint8_t* pins, uint8_t numPins);
+    ~VibeLEDMatrixOutput();
+
+    // VibeLEDOutput interface
+    void begin(VibeLED& leds);
+    void show(VibeLED& leds);
+
+    // Scan scheduling
+    void setScanRate(uint16_t hz);
+    void setDutyCycle(uint8_t percent);
+    void refresh();
+
+    // Statistics
+    MatrixOutputStats getStats();
+    void resetStats();
+
+  private:
+    bool _charlieplex;
+    uint8_t* _slotPins;    // Row pins, or all pins when charlieplexing
+    uint8_t* _maskPins;    // Column pins, or all pins when charlieplexing
+    uint8_t _numSlots;
+    uint8_t _numMaskPins;
+
+    uint32_t* _tables;     // Two sets of per-slot masks (front and back)
+    uint32_t* _front;
+    uint32_t* _back;
+    volatile bool _pending;
+
+    uint8_t _slot;
+    bool _lit;
+    uint16_t _scanRate;
+    uint8_t _dutyCycle;
+    uint8_t _brightness;
+    unsigned long _slotStart;
+    unsigned long _slotMicros;
+    unsigned long _onMicros;
+
+    unsigned long _statsStart;
+    uint32_t _scans;
+    uint32_t _tableBuilds;
+
+#if defined(__AVR__)
+    // Direct port access: each slot's masks are kept per I/O port
+    struct PortPin {
+      uint8_t port;            // Index into _outputRegs and _modeRegs
+      uint8_t mask;
+    };
+    uint8_t _numPorts;
+    volatile uint8_t** _outputRegs;
+    volatile uint8_t** _modeRegs;
+    PortPin* _slotPorts;
+    PortPin* _maskPorts;       // Same as _slotPorts when charlieplexing
+    uint8_t* _columnMasks;     // Column pins on each port (row/column matrix)
+    uint8_t* _portTables;      // Two sets of per-slot, per-port masks
+    uint8_t* _frontPorts;
+    uint8_t* _backPorts;
+
+    uint8_t _portIndex(uint8_t pin);
+    void _buildPorts(const uint32_t* masks, uint8_t* ports);
+#else
+    uint32_t _driven;          // Column pins currently pulled LOW
+#endif
+
+    void _updateTiming();
+    void _light(uint8_t slot);
+    void _blank(uint8_t slot);
+};
+
+#endif
@@ -0,0 +1,326 @@
+/*
+  VibeLEDNoise.cpp - Integer gradient noise for organic effects.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDNoise.h"
+
+// Ken Perlin's reference permutation
+static const uint8_t _perm[256] PROGMEM = {
+  151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+  140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+  247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+  57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+  74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+  60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+  65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+  200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+  52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+  207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+  119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+  129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+  218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+  81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+  184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+  222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180
+};
+
+// Smoothstep fade curve (3t^2 - 2t^3), 8-bit in and out
+static inline uint8_t _ease8(uint8_t t) {
+  uint16_t t2 = ((uint16_t)t * t) >> 8;
+  uint16_t result = 3 * t2 - ((t2 * t) >> 7);
+  return (result > 255) ? 255 : result;
+}
+
+// Smoothstep fade curve, 16-bit in, 15-bit out (0-32767)
+static inline uint16_t _ease15(uint16_t t) {
+  uint32_t t2 = ((uint32_t)t * t) >> 16;
+  uint32_t result = (3 * t2 - ((t2 * t) >> 15)) >> 1;
+  return (result > 32767) ? 32767 : result;
+}
+
+// Dot product of the distance with one of 12 cube edge gradients
+static inline int16_t _grad8(uint8_t hash, int16_t x, int16_t y, int16_t z) {
+  uint8_t h = hash & 15;
+  int16_t u = (h < 8) ? x : y;
+  int16_t v = (h < 4) ? y : ((h == 12 || h == 14) ? x : z);
+  return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+static inline int32_t _grad16(uint8_t hash, int32_t x, int32_t y, int32_t z) {
+  uint8_t h = hash & 15;
+  int32_t u = (h < 8) ? x : y;
+  int32_t v = (h < 4) ? y : ((h == 12 || h == 14) ? x : z);
+  return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+// Interpolate a..b by an 8-bit weight
+static inline int16_t _lerp8(int16_t a, int16_t b, uint8_t weight) {
+  return a + (int16_t)(((int32_t)(b - a) * weight) >> 8);
+}
+
+// Interpolate a..b by a 15-bit weight (differences up to 65536 fit in 32 bits)
+static inline int32_t _lerp15(int32_t a, int32_t b, uint16_t weight) {
+  return a + (((b - a) * (int32_t)weight) >> 15);
+}
+
+static inline uint8_t _clamp8(int16_t value) {
+  return (value < 0) ? 0 : ((value > 255) ? 255 : value);
+}
+
+static inline uint16_t _clamp16(int32_t value) {
+  return (value < 0) ? 0 : ((value > 65535) ? 65535 : value);
+}
+
+// Constructor
+VibeLEDNoise::VibeLEDNoise(uint32_t seed) {
+  setSeed(seed);
+}
+
+// Select the noise field (each seed shifts and scrambles the lattice)
+void VibeLEDNoise::setSeed(uint32_t seed) {
+  uint32_t mixed = (seed ^ (seed >> 16)) * 2654435761UL;
+  mixed ^= mixed >> 13;
+  _seed[0] = mixed;
+  _seed[1] = mixed >> 8;
+  _seed[2] = mixed >> 16;
+  _seed[3] = mixed >> 24;
+}
+
+// 1D noise (8.8 coordinates)
+uint8_t VibeLEDNoise::noise8(uint16_t x) {
+  uint8_t X = (x >> 8) + _seed[0];
+  uint8_t fx = x;
+  int16_t dx = fx >> 1;
+
+  // Gradients are slopes from -128 to 127
+  int16_t g0 = ((int8_t)_hash(X) * dx) >> 6;
+  int16_t g1 = ((int8_t)_hash(X + 1) * (dx - 128)) >> 6;
+  return _clamp8(_lerp8(g0, g1, _ease8(fx)) + 128);
+}
+
+// 2D noise (8.8 coordinates)
+uint8_t VibeLEDNoise::noise8(uint16_t x, uint16_t y) {
+  uint8_t X = (x >> 8) + _seed[0];
+  uint8_t Y = (y >> 8) + _seed[1];
+  uint8_t fx = x;
+  uint8_t fy = y;
+  int16_t dx = fx >> 1;
+  int16_t dy = fy >> 1;
+
+  uint8_t A = _hash(X) + Y;
+  uint8_t B = _hash(X + 1) + Y;
+  uint8_t u = _ease8(fx);
+
+  int16_t x1 = _lerp8(_grad8(_hash(A), dx, dy, 0), _grad8(_hash(B), dx - 128, dy, 0), u);
+  int16_t x2 = _lerp8(_grad8(_hash(A + 1), dx, dy - 128, 0), _grad8(_hash(B + 1), dx - 128, dy - 128, 0), u);
+  return _clamp8(_lerp8(x1, x2, _ease8(fy)) + 128);
+}
+
+// 3D noise (8.8 coordinates)
+uint8_t VibeLEDNoise::noise8(uint16_t x, uint16_t y, uint16_t z) {
+  return _clamp8(_signed8(x, y, z) + 128);
+}
+
+// 1D noise (16.16 coordinates)
+uint16_t VibeLEDNoise::noise16(uint32_t x) {
+  uint8_t X = (uint8_t)(x >> 16) + _seed[0];
+  uint16_t fx = x;
+  int32_t dx = fx >> 2;
+
+  int32_t g0 = ((int8_t)_hash(X) * dx) >> 6;
+  int32_t g1 = ((int8_t)_hash(X + 1) * (dx - 16384)) >> 6;
+  return _clamp16(_lerp15(g0, g1, _ease15(fx)) * 2 + 32768);
+}
+
+// 2D noise (16.16 coordinates)
+uint16_t VibeLEDNoise::noise16(uint32_t x, uint32_t y) {
+  uint8_t X = (uint8_t)(x >> 16) + _seed[0];
+  uint8_t Y = (uint8_t)(y >> 16) + _seed[1];
+  uint16_t fx = x;
+  uint16_t fy = y;
+  int32_t dx = fx >> 2;
+  int32_t dy = fy >> 2;
+
+  uint8_t A = _hash(X) + Y;
+  uint8_t B = _hash(X + 1) + Y;
+  uint16_t u = _ease15(fx);
+
+  int32_t x1 = _lerp15(_grad16(_hash(A), dx, dy, 0), _grad16(_hash(B), dx - 16384, dy, 0), u);
+  int32_t x2 = _lerp15(_grad16(_hash(A + 1), dx, dy - 16384, 0), _grad16(_hash(B + 1), dx - 16384, dy - 16384, 0), u);
+  return _clamp16(_lerp15(x1, x2, _ease15(fy)) * 2 + 32768);
+}
+
+// 3D noise (16.16 coordinates)
+uint16_t VibeLEDNoise::noise16(uint32_t x, uint32_t y, uint32_t z) {
+  return _clamp16(_signed16(x, y, z) * 2 + 32768);
+}
+
+// Fractal 3D noise (8.8 coordinates, 1-8 octaves)
+uint8_t VibeLEDNoise::fractal8(uint16_t x, uint16_t y, uint16_t z, uint8_t octaves) {
+  octaves = constrain(octaves, 1, 8);
+
+  // Octaves are independent, so the sum varies about as much as one
+  // octave and is used without normalizing
+  int16_t sum = 0;
+  for (uint8_t i = 0; i < octaves; i++) {
+    sum += _signed8(x, y, z) >> i;
+
+    // Double the frequency; the offsets keep the octaves from lining up
+    x = (x << 1) + 0x2B5;
+    y = (y << 1) + 0x1C3;
+    z = (z << 1) + 0x37E;
+  }
+
+  return _clamp8(sum + 128);
+}
+
+// Fractal 3D noise (16.16 coordinates, 1-8 octaves)
+uint16_t VibeLEDNoise::fractal16(uint32_t x, uint32_t y, uint32_t z, uint8_t octaves) {
+  octaves = constrain(octaves, 1, 8);
+
+  int32_t sum = 0;
+  for (uint8_t i = 0; i < octaves; i++) {
+    sum += _signed16(x, y, z) >> i;
+
+    x = (x << 1) + 0x2B500;
+    y = (y << 1) + 0x1C300;
+    z = (z << 1) + 0x37E00;
+  }
+
+  return _clamp16(sum * 2 + 32768);
+}
+
+// Fill a run of values along x
+void VibeLEDNoise::fill(uint8_t* out, uint16_t count, uint16_t x, uint16_t xStep,
+                        uint16_t y, uint16_t z, uint8_t octaves) {
+  if (octaves > 1) {
+    for (uint16_t i = 0; i < count; i++) {
+      out[i] = fractal8(x, y, z, octaves);
+      x += xStep;
+    }
+    return;
+  }
+
+  // Everything that depends on y and z only
+  uint8_t Y = (y >> 8) + _seed[1];
+  uint8_t Z = (z >> 8) + _seed[2];
+  uint8_t fy = y;
+  uint8_t fz = z;
+  int16_t dy = fy >> 1;
+  int16_t dz = fz >> 1;
+  uint8_t v = _ease8(fy);
+  uint8_t w = _ease8(fz);
+
+  uint8_t corner[8] = { 0 };
+  uint16_t cell = 0x100;  // No cell hashed yet
+
+  for (uint16_t i = 0; i < count; i++) {
+    uint8_t X = (x >> 8) + _seed[0];
+
+    // Rehash the corners only when x enters a new cell
+    if (X != cell) {
+      uint8_t A = _hash(X) + Y;
+      uint8_t B = _hash(X + 1) + Y;
+      uint8_t AA = _hash(A) + Z;
+      uint8_t AB = _hash(A + 1) + Z;
+      uint8_t BA = _hash(B) + Z;
+      uint8_t BB = _hash(B + 1) + Z;
+      corner[0] = _hash(AA);
+      corner[1] = _hash(BA);
+      corner[2] = _hash(AB);
+      corner[3] = _hash(BB);
+      corner[4] = _hash(AA + 1);
+      corner[5] = _hash(BA + 1);
+      corner[6] = _hash(AB + 1);
+      corner[7] = _hash(BB + 1);
+      cell = X;
+    }
+
+    uint8_t fx = x;
+    int16_t dx = fx >> 1;
+    uint8_t u = _ease8(fx);
+
+    int16_t x1 = _lerp8(_grad8(corner[0], dx, dy, dz), _grad8(corner[1], dx - 128, dy, dz), u);
+    int16_t x2 = _lerp8(_grad8(corner[2], dx, dy - 128, dz), _grad8(corner[3], dx - 128, dy - 128, dz), u);
+    int16_t y1 = _lerp8(x1, x2, v);
+    x1 = _lerp8(_grad8(corner[4], dx, dy, dz - 128), _grad8(corner[5], dx - 128, dy, dz - 128), u);
+    x2 = _lerp8(_grad8(corner[6], dx, dy - 128, dz - 128), _grad8(corner[7], dx - 128, dy - 128, dz - 128), u);
+    int16_t y2 = _lerp8(x1, x2, v);
+
+    out[i] = _clamp8(_lerp8(y1, y2, w) + 128);
+    x += xStep;
+  }
+}
+
+// Permutation lookup (XOR with a seed byte keeps it a permutation)
+uint8_t VibeLEDNoise::_hash(uint8_t i) {
+  return pgm_read_byte(&_perm[i]) ^ _seed[3];
+}
+
+// 3D noise core, about -128..128 (distances in 1/128 of a cell)
+int16_t VibeLEDNoise::_signed8(uint16_t x, uint16_t y, uint16_t z) {
+  uint8_t X = (x >> 8) + _seed[0];
+  uint8_t Y = (y >> 8) + _seed[1];
+  uint8_t Z = (z >> 8) + _seed[2];
+  uint8_t fx = x;
+  uint8_t fy = y;
+  uint8_t fz = z;
+  int16_t dx = fx >> 1;
+  int16_t dy = fy >> 1;
+  int16_t dz = fz >> 1;
+  uint8_t u = _ease8(fx);
+  uint8_t v = _ease8(fy);
+  uint8_t w = _ease8(fz);
+
+  // Hash the eight corners of the cell
+  uint8_t A = _hash(X) + Y;
+  uint8_t B = _hash(X + 1) + Y;
+  uint8_t AA = _hash(A) + Z;
+  uint8_t AB = _hash(A + 1) + Z;
+  uint8_t BA = _hash(B) + Z;
+  uint8_t BB = _hash(B + 1) + Z;
+
+  int16_t x1 = _lerp8(_grad8(_hash(AA), dx, dy, dz), _grad8(_hash(BA), dx - 128, dy, dz), u);
+  int16_t x2 = _lerp8(_grad8(_hash(AB), dx, dy - 128, dz), _grad8(_hash(BB), dx - 128, dy - 128, dz), u);
+  int16_t y1 = _lerp8(x1, x2, v);
+  x1 = _lerp8(_grad8(_hash(AA + 1), dx, dy, dz - 128), _grad8(_hash(BA + 1), dx - 128, dy, dz - 128), u);
+  x2 = _lerp8(_grad8(_hash(AB + 1), dx, dy - 128, dz - 128), _grad8(_hash(BB + 1), dx - 128, dy - 128, dz - 128), u);
+  int16_t y2 = _lerp8(x1, x2, v);
+
+  return _lerp8(y1, y2, w);
+}
+
+// 3D noise core, about -16384..16384 (distances in 1/16384 of a cell)
+int32_t VibeLEDNoise::_signed16(uint32_t x, uint32_t y, uint32_t z) {
+  uint8_t X = (uint8_t)(x >> 16) + _seed[0];
+  uint8_t Y = (uint8_t)(y >> 16) + _seed[1];
+  uint8_t Z = (uint8_t)(z >> 16) + _seed[2];
+  uint16_t fx = x;
+  uint16_t fy = y;
+  uint16_t fz = z;
+  int32_t dx = fx >> 2;
+  int32_t dy = fy >> 2;
+  int32_t dz = fz >> 2;
+  uint16_t u = _ease15(fx);
+  uint16_t v = _ease15(fy);
+  uint16_t w = _ease15(fz);
+
+  uint8_t A = _hash(X) + Y;
+  uint8_t B = _hash(X + 1) + Y;
+  uint8_t AA = _hash(A) + Z;
+  uint8_t AB = _hash(A + 1) + Z;
+  uint8_t BA = _hash(B) + Z;
+  uint8_t BB = _hash(B + 1) + Z;
+
+  int32_t x1 = _lerp15(_grad16(_hash(AA), dx, dy, dz), _grad16(_hash(BA), dx - 16384, dy, dz), u);
+  int32_t x2 = _lerp15(_grad16(_hash(AB), dx, dy - 16384, dz), _grad16(_hash(BB), dx - 16384, dy - 16384, dz), u);
+  int32_t y1 = _lerp15(x1, x2, v);
+  x1 = _lerp15(_grad16(_hash(AA + 1), dx, dy, dz - 16384), _grad16(_hash(BA + 1), dx - 16384, dy, dz - 16384), u);
+  x2 = _lerp15(_grad16(_hash(AB + 1), dx, dy - 16384, dz - 16384), _grad16(_hash(BB + 1), dx - 16384, dy - 16384, dz - 16384), u);
+  int32_t y2 = _lerp15(x1, x2, v);
+
+  return _lerp15(y1, y2, w);
+}
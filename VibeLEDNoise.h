@@ -0,0 +1,53 @@
+/*
+  VibeLEDNoise.h - Integer gradient noise for organic effects.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDNoise_h
+#define VibeLEDNoise_h
+
+#include "Arduino.h"
+
+// Smooth gradient noise (Perlin style) using integer math only.
+//
+// 8-bit functions take 8.8 fixed point coordinates: the high byte selects
+// the lattice cell and the low byte is the position inside it, so a step of
+// 256 moves one cell. 16-bit functions take 16.16 coordinates. Results are
+// centered on 128 (32768), change smoothly and repeat every 256 cells.
+// The same seed and coordinates always give the same value on every board.
+class VibeLEDNoise {
+  public:
+    VibeLEDNoise(uint32_t seed = 0);
+    void setSeed(uint32_t seed);
+
+    // 8-bit noise (8.8 coordinates)
+    uint8_t noise8(uint16_t x);
+    uint8_t noise8(uint16_t x, uint16_t y);
+    uint8_t noise8(uint16_t x, uint16_t y, uint16_t z);
+
+    // 16-bit noise (16.16 coordinates)
+    uint16_t noise16(uint32_t x);
+    uint16_t noise16(uint32_t x, uint32_t y);
+    uint16_t noise16(uint32_t x, uint32_t y, uint32_t z);
+
+    // Fractal noise: octaves at doubling frequency and halving amplitude
+    uint8_t fractal8(uint16_t x, uint16_t y, uint16_t z, uint8_t octaves);
+    uint16_t fractal16(uint32_t x, uint32_t y, uint32_t z, uint8_t octaves);
+
+    // Fill count values along x (x, x + xStep, ...) at fixed y and z.
+    // Faster than calling noise8() per value: the y and z terms are
+    // computed once and corners are only rehashed when x enters a new cell.
+    void fill(uint8_t* out, uint16_t count, uint16_t x, uint16_t xStep,
+              uint16_t y, uint16_t z, uint8_t octaves = 1);
+
+  private:
+    uint8_t _seed[4];   // Lattice offsets for x, y, z and a hash mask
+
+    uint8_t _hash(uint8_t i);
+    int16_t _signed8(uint16_t x, uint16_t y, uint16_t z);
+    int32_t _signed16(uint32_t x, uint32_t y, uint32_t z);
+};
+
+#endif
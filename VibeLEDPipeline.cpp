@@ -0,0 +1,145 @@
+/*
+  VibeLEDPipeline.cpp - Pipelined rendering and output across two cores.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDPipeline.h"
+#include "VibeLEDProfile.h"
+
+#ifdef VIBELED_HAS_PIPELINE
+
+// Constructor (all frame buffers are allocated here)
+VibeLEDFrameQueue::VibeLEDFrameQueue(uint16_t numLeds, uint8_t capacity, uint8_t bytesPerLed) :
+  _head(0), _tail(0), _full(0), _empty(0), _maxDepth(0) {
+  _numLeds = numLeds;
+  _bytesPerLed = bytesPerLed;
+  _frameSize = (uint32_t)numLeds * bytesPerLed;
+  _capacity = capacity ? capacity : 1;
+  _headSlot = 0;
+  _tailSlot = 0;
+  _frames = new uint8_t[_frameSize * _capacity];
+  VIBELED_PROFILE_ALLOCATION(_frameSize * _capacity);
+}
+
+// Get a free buffer to render into, or nullptr when the queue is full
+uint8_t* VibeLEDFrameQueue::acquire() {
+  uint32_t head = _head.load(std::memory_order_relaxed);
+  uint32_t tail = _tail.load(std::memory_order_acquire);
+
+  if (head - tail >= _capacity) {
+    _full.store(_full.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return _frames + _headSlot * _frameSize;
+}
+
+// Publish the buffer returned by acquire()
+void VibeLEDFrameQueue::push() {
+  if (++_headSlot == _capacity) _headSlot = 0;
+  uint32_t head = _head.load(std::memory_order_relaxed) + 1;
+  _head.store(head, std::memory_order_release);
+
+  uint16_t depth = head - _tail.load(std::memory_order_relaxed);
+  if (depth > _maxDepth.load(std::memory_order_relaxed)) {
+    _maxDepth.store(depth, std::memory_order_relaxed);
+  }
+}
+
+// Get the oldest frame, or nullptr when the queue is empty
+const uint8_t* VibeLEDFrameQueue::front() {
+  uint32_t tail = _tail.load(std::memory_order_relaxed);
+  uint32_t head = _head.load(std::memory_order_acquire);
+
+  if (head == tail) {
+    _empty.store(_empty.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return _frames + _tailSlot * _frameSize;
+}
+
+// Return the frame from front() to the render side
+void VibeLEDFrameQueue::pop() {
+  if (++_tailSlot == _capacity) _tailSlot = 0;
+  _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Frames currently waiting
+uint16_t VibeLEDFrameQueue::getDepth() {
+  return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+}
+
+// Number of frame buffers
+uint8_t VibeLEDFrameQueue::getCapacity() {
+  return _capacity;
+}
+
+// LEDs per frame
+uint16_t VibeLEDFrameQueue::getNumLeds() {
+  return _numLeds;
+}
+
+// Bytes per LED in each frame
+uint8_t VibeLEDFrameQueue::getBytesPerLed() {
+  return _bytesPerLed;
+}
+
+// Get queue statistics
+FrameQueueStats VibeLEDFrameQueue::getStats() {
+  FrameQueueStats stats;
+  stats.pushed = _head.load(std::memory_order_relaxed);
+  stats.popped = _tail.load(std::memory_order_relaxed);
+  stats.full = _full.load(std::memory_order_relaxed);
+  stats.empty = _empty.load(std::memory_order_relaxed);
+  stats.maxDepth = _maxDepth.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// Constructor
+VibeLEDPipeline::VibeLEDPipeline(VibeLED& leds, VibeLEDFrameQueue& queue, VibeLEDFrameSink& sink) :
+  _leds(leds), _queue(queue), _sink(sink) {
+}
+
+// Render the next frame into the queue if it is due and a buffer is free
+bool VibeLEDPipeline::render() {
+  return render(millis());
+}
+
+// Render at an explicit time in milliseconds
+bool VibeLEDPipeline::render(unsigned long now) {
+  // A queue sized for another strip or holding frames in another format
+  // would overflow its buffers
+  if (_leds.getNumLeds() != _queue.getNumLeds() ||
+      _leds.getBytesPerLed() != _queue.getBytesPerLed()) return false;
+
+  // Back-pressure: check for a buffer first so the effect does not advance
+  uint8_t* frame = _queue.acquire();
+  if (frame == nullptr) {
+    VIBELED_PROFILE_SKIPPED_PUSH();
+    return false;
+  }
+
+  if (!_leds.render(now)) return false;
+
+  _leds.encode(frame);
+  _queue.push();
+  return true;
+}
+
+// Push the oldest queued frame to the LEDs
+bool VibeLEDPipeline::present() {
+  const uint8_t* frame = _queue.front();
+  if (frame == nullptr) return false;
+
+  _sink.write(frame, _queue.getNumLeds());
+  _queue.pop();
+  return true;
+}
+
+// Get the frame queue (for statistics)
+VibeLEDFrameQueue& VibeLEDPipeline::getQueue() {
+  return _queue;
+}
+
+#endif
@@ -0,0 +1,117 @@
+/*
+  VibeLEDPipeline.h - Pipelined rendering and output across two cores.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDPipeline_h
+#define VibeLEDPipeline_h
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+// Needs std::atomic, which the AVR core does not provide
+#if !defined(__AVR__)
+#define VIBELED_HAS_PIPELINE 1
+
+#include <atomic>
+
+// Receives finished frames on the output core (output colors with
+// brightness and power limiting applied, in the strip's output format:
+// VibeLED::getBytesPerLed() bytes per LED)
+class VibeLEDFrameSink {
+  public:
+    virtual ~VibeLEDFrameSink() {}
+    virtual void write(const uint8_t* frame, uint16_t numLeds) = 0;
+};
+
+// Queue statistics
+struct FrameQueueStats {
+  uint32_t pushed;     // Frames queued by the render side
+  uint32_t popped;     // Frames taken by the output side
+  uint32_t full;       // Times the render side found no free buffer
+  uint32_t empty;      // Times the output side found no frame
+  uint16_t maxDepth;   // Most frames waiting at once
+};
+
+// Lock-free single-producer/single-consumer ring of pre-allocated frame
+// buffers. One side only writes _head and the other only writes _tail, so
+// plain atomic loads and stores (acquire/release) are enough; no
+// read-modify-write operations are needed, which keeps it lock-free on
+// cores without atomic exchange (such as the RP2040's Cortex-M0+).
+class VibeLEDFrameQueue {
+  public:
+    VibeLEDFrameQueue(uint16_t numLeds, uint8_t capacity = 3, uint8_t bytesPerLed = 3);
+
+    // Render side: get a free buffer (nullptr when full), fill it, then push
+    uint8_t* acquire();
+    void push();
+
+    // Output side: get the oldest frame (nullptr when empty), then release it
+    const uint8_t* front();
+    void pop();
+
+    // State queries (safe from either side)
+    uint16_t getDepth();
+    uint8_t getCapacity();
+    uint16_t getNumLeds();
+    uint8_t getBytesPerLed();
+
+    // Statistics
+    FrameQueueStats getStats();
+
+  private:
+    uint16_t _numLeds;
+    uint8_t _bytesPerLed;
+    uint32_t _frameSize;
+    uint8_t _capacity;
+    uint8_t* _frames;
+
+    // Free-running frame counters; their difference is the depth
+    std::atomic<uint32_t> _head;   // Written by the render side only
+    std::atomic<uint32_t> _tail;   // Written by the output side only
+
+    // Buffer slots, wrapped at the capacity (a counter modulo a capacity
+    // that is not a power of two would jump when the counter wraps)
+    uint8_t _headSlot;             // Render side only
+    uint8_t _tailSlot;             // Output side only
+
+    // Each counter is written by one side only and read with relaxed loads
+    std::atomic<uint32_t> _full;
+    std::atomic<uint32_t> _empty;
+    std::atomic<uint16_t> _maxDepth;
+};
+
+// Splits update() into a render side and an output side that can run on
+// different cores. render() draws frame N+1 into a free queue buffer while
+// present() pushes frame N to the LEDs. When the queue is full, render()
+// waits (returns false) without advancing the effect, so no frame is lost.
+// The queue must be sized for the strip and hold frames of its output
+// format (create it with getBytesPerLed() bytes per LED after
+// VibeLED::setOutputFormat()); render() never writes a frame otherwise.
+//
+//   Core 0:  pipeline.render();    // instead of leds.update()
+//   Core 1:  pipeline.present();
+class VibeLEDPipeline {
+  public:
+    VibeLEDPipeline(VibeLED& leds, VibeLEDFrameQueue& queue, VibeLEDFrameSink& sink);
+
+    // Render side
+    bool render();
+    bool render(unsigned long now);
+
+    // Output side
+    bool present();
+
+    VibeLEDFrameQueue& getQueue();
+
+  private:
+    VibeLED& _leds;
+    VibeLEDFrameQueue& _queue;
+    VibeLEDFrameSink& _sink;
+};
+
+#endif  // !__AVR__
+
+#endif
@@ -0,0 +1,192 @@
+/*
+  VibeLEDProfile.cpp - Optional hot-path profiling counters and binary trace export.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDProfile.h"
+
+#ifdef VIBELED_PROFILE
+
+#if !defined(ESP32) && !defined(ESP8266) && (defined(__linux__) || defined(__APPLE__))
+#include <time.h>
+#endif
+
+VibeLEDProfiler VibeLEDProfile;
+
+// Constructor
+VibeLEDProfiler::VibeLEDProfiler() {
+  reset();
+}
+
+// Clear all counters and slots
+void VibeLEDProfiler::reset() {
+  _counters = ProfileCounters();
+  _numSlots = 0;
+}
+
+// Current tick count (wraps; only differences are used)
+uint32_t VibeLEDProfiler::ticks() {
+#if defined(ESP32) || defined(ESP8266)
+  return ESP.getCycleCount();
+#elif defined(__linux__) || defined(__APPLE__)
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint32_t)time.tv_sec * 1000000000UL + time.tv_nsec;
+#else
+  return micros();
+#endif
+}
+
+// Ticks per microsecond of ticks()
+uint16_t VibeLEDProfiler::ticksPerMicrosecond() {
+#if defined(ESP32) || defined(ESP8266)
+  return ESP.getCpuFreqMHz();
+#elif defined(__linux__) || defined(__APPLE__)
+  return 1000;
+#else
+  return 1;
+#endif
+}
+
+// Record the time spent rendering one frame of an effect
+void VibeLEDProfiler::recordRender(uint8_t effect, uint32_t ticks) {
+  _counters.frames++;
+  _record(_slotFor(effect)->render, ticks);
+}
+
+// Record the time spent pushing one frame to the outputs
+void VibeLEDProfiler::recordOutput(uint8_t effect, uint32_t ticks) {
+  _record(_slotFor(effect)->output, ticks);
+}
+
+// Record a heap allocation made by the library
+void VibeLEDProfiler::recordAllocation(uint32_t bytes) {
+  _counters.allocations++;
+  _counters.allocatedBytes += bytes;
+  if (_counters.frames > 0) {
+    _counters.frameAllocations++;
+  }
+}
+
+// Count a frame that started a whole interval late
+void VibeLEDProfiler::countLateFrame() {
+  _counters.lateFrames++;
+}
+
+// Count a frame that was rendered or due but not pushed
+void VibeLEDProfiler::countSkippedPush() {
+  _counters.skippedPushes++;
+}
+
+// Get the frame and allocation counters
+ProfileCounters VibeLEDProfiler::getCounters() {
+  return _counters;
+}
+
+// Number of slots in use
+uint8_t VibeLEDProfiler::getSlotCount() {
+  return _numSlots;
+}
+
+// Get a slot (nullptr if out of range)
+ProfileSlot* VibeLEDProfiler::getSlot(uint8_t index) {
+  return (index < _numSlots) ? &_slots[index] : nullptr;
+}
+
+// Write the counters and all slots (little endian, followed by a 16-bit
+// sum of every byte after the magic)
+void VibeLEDProfiler::dump(Print& out) {
+  uint16_t checksum = 0;
+  out.write((const uint8_t*)"VLPF", 4);
+
+  _write(out, VIBELED_PROFILE_VERSION, 1, checksum);
+  _write(out, VIBELED_PROFILE_BUCKETS, 1, checksum);
+  _write(out, _numSlots, 1, checksum);
+  _write(out, ticksPerMicrosecond(), 2, checksum);
+
+  _write(out, _counters.frames, 4, checksum);
+  _write(out, _counters.lateFrames, 4, checksum);
+  _write(out, _counters.skippedPushes, 4, checksum);
+  _write(out, _counters.allocations, 4, checksum);
+  _write(out, _counters.allocatedBytes, 4, checksum);
+  _write(out, _counters.frameAllocations, 4, checksum);
+
+  for (uint8_t i = 0; i < _numSlots; i++) {
+    _write(out, _slots[i].effect, 1, checksum);
+    _writeSection(out, _slots[i].render, checksum);
+    _writeSection(out, _slots[i].output, checksum);
+  }
+
+  uint16_t sum = checksum;
+  _write(out, sum, 2, checksum);
+}
+
+// Find or claim the slot of an effect
+ProfileSlot* VibeLEDProfiler::_slotFor(uint8_t effect) {
+  for (uint8_t i = 0; i < _numSlots; i++) {
+    if (_slots[i].effect == effect) return &_slots[i];
+  }
+
+  // The last slot is kept for all effects that do not get their own
+  if (_numSlots == VIBELED_PROFILE_SLOTS) {
+    return &_slots[_numSlots - 1];
+  }
+  if (_numSlots == VIBELED_PROFILE_SLOTS - 1) {
+    effect = VIBELED_PROFILE_OTHER;
+  }
+
+  ProfileSlot& slot = _slots[_numSlots++];
+  memset(&slot, 0, sizeof(slot));
+  slot.effect = effect;
+  slot.render.min = 0xFFFFFFFF;
+  slot.output.min = 0xFFFFFFFF;
+  return &slot;
+}
+
+// Add one time to a section
+void VibeLEDProfiler::_record(ProfileSection& section, uint32_t ticks) {
+  section.count++;
+  section.total += ticks;
+  if (ticks < section.min) section.min = ticks;
+  if (ticks > section.max) section.max = ticks;
+
+  // Bucket = number of significant bits
+  uint8_t bucket = 0;
+  while (ticks > 0 && bucket < VIBELED_PROFILE_BUCKETS - 1) {
+    ticks >>= 1;
+    bucket++;
+  }
+
+  // Halve all buckets when one is full, which keeps the shape
+  if (section.buckets[bucket] == 0xFFFF) {
+    for (uint8_t i = 0; i < VIBELED_PROFILE_BUCKETS; i++) {
+      section.buckets[i] >>= 1;
+    }
+  }
+  section.buckets[bucket]++;
+}
+
+// Write a value of 1 to 4 bytes, least significant first
+void VibeLEDProfiler::_write(Print& out, uint32_t value, uint8_t size, uint16_t& checksum) {
+  for (uint8_t i = 0; i < size; i++) {
+    uint8_t data = value >> (i * 8);
+    out.write(data);
+    checksum += data;
+  }
+}
+
+// Write one section: count, min, max, total (64 bit) and the buckets
+void VibeLEDProfiler::_writeSection(Print& out, ProfileSection& section, uint16_t& checksum) {
+  _write(out, section.count, 4, checksum);
+  _write(out, section.count ? section.min : 0, 4, checksum);
+  _write(out, section.max, 4, checksum);
+  _write(out, (uint32_t)section.total, 4, checksum);
+  _write(out, (uint32_t)(section.total >> 32), 4, checksum);
+  for (uint8_t i = 0; i < VIBELED_PROFILE_BUCKETS; i++) {
+    _write(out, section.buckets[i], 2, checksum);
+  }
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*
+  VibeLEDProfile.h - Optional hot-path profiling counters and binary trace export.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDProfile_h
+#define VibeLEDProfile_h
+
+#include "Arduino.h"
+
+// Profiling is compiled in only when VIBELED_PROFILE is defined for every
+// library source: uncomment the line below or add -DVIBELED_PROFILE to the
+// build flags. Without it the hooks expand to nothing.
+// #define VIBELED_PROFILE
+
+#ifdef VIBELED_PROFILE
+
+// Effects tracked separately; further effects share the last slot
+#ifndef VIBELED_PROFILE_SLOTS
+#if defined(__AVR__)
+#define VIBELED_PROFILE_SLOTS 3
+#else
+#define VIBELED_PROFILE_SLOTS 8
+#endif
+#endif
+
+// Histogram buckets: bucket b counts times of 2^(b-1) to 2^b - 1 ticks,
+// the last bucket everything longer
+#ifndef VIBELED_PROFILE_BUCKETS
+#define VIBELED_PROFILE_BUCKETS 24
+#endif
+
+// Effect ID of the shared overflow slot
+#define VIBELED_PROFILE_OTHER 0xFF
+
+// Binary dump format version
+#define VIBELED_PROFILE_VERSION 1
+
+// Timing of one hot path: totals and a log2 histogram
+struct ProfileSection {
+  uint32_t count;
+  uint32_t min;      // Ticks
+  uint32_t max;      // Ticks
+  uint64_t total;    // Ticks
+  uint16_t buckets[VIBELED_PROFILE_BUCKETS];
+};
+
+// Render (_updateEffect()) and output (_applyStates()) timing of one effect
+struct ProfileSlot {
+  uint8_t effect;    // EffectType, or VIBELED_PROFILE_OTHER
+  ProfileSection render;
+  ProfileSection output;
+};
+
+// Frame and allocation counters
+struct ProfileCounters {
+  uint32_t frames;            // Frames rendered
+  uint32_t lateFrames;        // Frames that started a whole interval late
+  uint32_t skippedPushes;     // Frames rendered or due but not pushed
+  uint32_t allocations;       // Heap allocations made by the library
+  uint32_t allocatedBytes;    // Bytes requested by those allocations
+  uint32_t frameAllocations;  // Allocations made after the first frame
+
+  ProfileCounters() :
+    frames(0),
+    lateFrames(0),
+    skippedPushes(0),
+    allocations(0),
+    allocatedBytes(0),
+    frameAllocations(0) {}
+};
+
+// Collects hot-path timings in fixed memory. Times are measured in ticks of
+// the fastest counter available: CPU cycles on ESP32 and ESP8266,
+// nanoseconds on Linux and macOS, microseconds elsewhere. Recording is not
+// thread safe; record from the thread that calls update().
+class VibeLEDProfiler {
+  public:
+    VibeLEDProfiler();
+    void reset();
+
+    // Hooks (use the VIBELED_PROFILE_* macros below)
+    static uint32_t ticks();
+    void recordRender(uint8_t effect, uint32_t ticks);
+    void recordOutput(uint8_t effect, uint32_t ticks);
+    void recordAllocation(uint32_t bytes);
+    void countLateFrame();
+    void countSkippedPush();
+
+    // Results
+    static uint16_t ticksPerMicrosecond();
+    ProfileCounters getCounters();
+    uint8_t getSlotCount();
+    ProfileSlot* getSlot(uint8_t index);
+
+    // Write everything in the compact binary format read by extras/profdump
+    void dump(Print& out);
+
+  private:
+    ProfileCounters _counters;
+    ProfileSlot _slots[VIBELED_PROFILE_SLOTS];
+    uint8_t _numSlots;
+
+    ProfileSlot* _slotFor(uint8_t effect);
+    static void _record(ProfileSection& section, uint32_t ticks);
+    static void _write(Print& out, uint32_t value, uint8_t size, uint16_t& checksum);
+    static void _writeSection(Print& out, ProfileSection& section, uint16_t& checksum);
+};
+
+// The library-wide profiler
+extern VibeLEDProfiler VibeLEDProfile;
+
+#define VIBELED_PROFILE_START(name) uint32_t name = VibeLEDProfiler::ticks()
+#define VIBELED_PROFILE_RENDER(effect, start) \
+  VibeLEDProfile.recordRender(effect, VibeLEDProfiler::ticks() - (start))
+#define VIBELED_PROFILE_OUTPUT(effect, start) \
+  VibeLEDProfile.recordOutput(effect, VibeLEDProfiler::ticks() - (start))
+#define VIBELED_PROFILE_ALLOCATION(bytes) VibeLEDProfile.recordAllocation(bytes)
+#define VIBELED_PROFILE_LATE_FRAME() VibeLEDProfile.countLateFrame()
+#define VIBELED_PROFILE_SKIPPED_PUSH() VibeLEDProfile.countSkippedPush()
+
+#else
+
+#define VIBELED_PROFILE_START(name)
+#define VIBELED_PROFILE_RENDER(effect, start)
+#define VIBELED_PROFILE_OUTPUT(effect, start)
+#define VIBELED_PROFILE_ALLOCATION(bytes)
+#define VIBELED_PROFILE_LATE_FRAME()
+#define VIBELED_PROFILE_SKIPPED_PUSH()
+
+#endif
+
+#endif
@@ -0,0 +1,327 @@
+/*
+  VibeLEDProtocol.cpp - Compact binary control protocol for VibeLED.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDProtocol.h"
+#include "VibeLEDVM.h"
+
+// Constructor
+VibeLEDProtocol::VibeLEDProtocol(VibeLED& leds) : _leds(leds) {
+  _vm = nullptr;
+  _latencyPending = false;
+  _arrival = 0;
+  _arrivalPushes = 0;
+  reset();
+}
+
+// Feed a single byte into the decoder
+void VibeLEDProtocol::feed(uint8_t data) {
+  unsigned long now = millis();
+
+  // Drop a partial frame if the sender went quiet
+  if (_state != STATE_SYNC && now - _lastByte > VIBELED_PROTOCOL_TIMEOUT) {
+    _stats.lengthErrors++;
+    _state = STATE_SYNC;
+  }
+  _lastByte = now;
+  _closeLatency();
+
+  State state = _state;
+  if (!_decode(data)) {
+    _rescan(data, state);
+  }
+}
+
+// Advance the decoder by one byte; false on a CRC or length error
+bool VibeLEDProtocol::_decode(uint8_t data) {
+  switch (_state) {
+    case STATE_SYNC:
+      if (data == VIBELED_PROTOCOL_SYNC) {
+        _state = STATE_LENGTH;
+      }
+      break;
+
+    case STATE_LENGTH:
+      if (data > VIBELED_PROTOCOL_MAX_PAYLOAD) {
+        _stats.lengthErrors++;
+        _state = STATE_SYNC;
+        return false;
+      }
+      _length = data;
+      _crc = _crc8(0, data);
+      _state = STATE_COMMAND;
+      break;
+
+    case STATE_COMMAND:
+      _command = data;
+      _crc = _crc8(_crc, data);
+      _received = 0;
+      _state = (_length > 0) ? STATE_PAYLOAD : STATE_CRC;
+      break;
+
+    case STATE_PAYLOAD:
+      _payload[_received++] = data;
+      _crc = _crc8(_crc, data);
+      if (_received >= _length) {
+        _state = STATE_CRC;
+      }
+      break;
+
+    case STATE_CRC:
+      _state = STATE_SYNC;
+      if (data != _crc) {
+        _stats.crcErrors++;
+        return false;
+      } else {
+        unsigned long arrival = micros();
+        uint32_t pushes = _leds.getPushCount();
+        if (_apply()) {
+          _stats.frames++;
+          // Time the oldest command not yet shown
+          if (!_latencyPending) {
+            _latencyPending = true;
+            _arrival = arrival;
+            _arrivalPushes = pushes;
+          }
+          _closeLatency();
+        } else {
+          _stats.unknownCommands++;
+        }
+      }
+      break;
+  }
+  return true;
+}
+
+// Scan a bad frame again for SYNC, starting after its own SYNC byte.
+// A corrupted length byte makes the decoder swallow the frames behind
+// it as payload; this finds them again.
+void VibeLEDProtocol::_rescan(uint8_t data, State failed) {
+  uint8_t bytes[VIBELED_PROTOCOL_MAX_PAYLOAD + 3];
+  uint16_t count = 0;
+  if (failed == STATE_CRC) {
+    bytes[count++] = _length;
+    bytes[count++] = _command;
+    for (uint16_t i = 0; i < _length; i++) {
+      bytes[count++] = _payload[i];
+    }
+  }
+  bytes[count++] = data;
+
+  // The decoder is back in STATE_SYNC, so every frame found here starts
+  // inside bytes; a nested error resumes after that frame's SYNC
+  uint16_t resume = 0;
+  uint16_t i = 0;
+  while (i < count) {
+    if (_state == STATE_SYNC && bytes[i] == VIBELED_PROTOCOL_SYNC) {
+      resume = i + 1;
+    }
+    if (_decode(bytes[i++])) continue;
+    i = resume;
+  }
+}
+
+// Close the latency measurement once a frame was pushed after the command
+void VibeLEDProtocol::_closeLatency() {
+  if (!_latencyPending) return;
+
+  if (_leds.getPushCount() == _arrivalPushes) return;
+
+  uint32_t latency = _leds.getLastPushTime() - _arrival;
+  _stats.lastLatency = latency;
+  if (latency > _stats.maxLatency) {
+    _stats.maxLatency = latency;
+  }
+  _latencyPending = false;
+}
+
+// Feed a block of bytes into the decoder
+void VibeLEDProtocol::feed(const uint8_t* data, uint16_t length) {
+  for (uint16_t i = 0; i < length; i++) {
+    feed(data[i]);
+  }
+}
+
+// Feed all bytes currently available on a stream (Serial, WiFiClient, ...)
+void VibeLEDProtocol::poll(Stream& stream) {
+  _closeLatency();
+  while (stream.available() > 0) {
+    feed((uint8_t)stream.read());
+  }
+}
+
+// Discard any partially received frame
+void VibeLEDProtocol::reset() {
+  _state = STATE_SYNC;
+  _length = 0;
+  _command = 0;
+  _received = 0;
+  _crc = 0;
+  _lastByte = 0;
+}
+
+// Accept bytecode effect uploads for this interpreter
+void VibeLEDProtocol::setVM(VibeLEDVM* vm) {
+  _vm = vm;
+}
+
+// Get decoder statistics
+ProtocolStats VibeLEDProtocol::getStats() {
+  _closeLatency();
+  return _stats;
+}
+
+// Reset decoder statistics
+void VibeLEDProtocol::resetStats() {
+  _stats = ProtocolStats();
+  _latencyPending = false;
+}
+
+// Build a complete frame for the given command
+uint16_t VibeLEDProtocol::encode(uint8_t command, const uint8_t* payload, uint8_t length, uint8_t* out) {
+  uint8_t crc = _crc8(0, length);
+  crc = _crc8(crc, command);
+
+  out[0] = VIBELED_PROTOCOL_SYNC;
+  out[1] = length;
+  out[2] = command;
+  for (uint8_t i = 0; i < length; i++) {
+    out[3 + i] = payload[i];
+    crc = _crc8(crc, payload[i]);
+  }
+  out[3 + length] = crc;
+
+  return length + 4;
+}
+
+// Apply a decoded frame to the LEDs
+bool VibeLEDProtocol::_apply() {
+  const uint8_t* p = _payload;
+
+  switch (_command) {
+    case CMD_SET_EFFECT:
+      if (_length == 1) {
+        _leds.setEffect((EffectType)p[0]);
+      } else if (_length == 3) {
+        _leds.setEffect((EffectType)p[0], _read16(p + 1));
+      } else {
+        return false;
+      }
+      _leds.refresh();
+      return true;
+
+    case CMD_SET_PARAMS: {
+      if (_length != 14) return false;
+      EffectParams params;
+      params.speed = _read16(p);
+      params.brightness = p[2];
+      params.color1 = Color(p[3], p[4], p[5]);
+      params.color2 = Color(p[6], p[7], p[8]);
+      params.color3 = Color(p[9], p[10], p[11]);
+      params.option1 = p[12];
+      params.option2 = p[13];
+      _leds.setParams(params);
+      _leds.refresh();
+      return true;
+    }
+
+    case CMD_SET_BRIGHTNESS:
+      if (_length != 1) return false;
+      _leds.setBrightness(p[0]);
+      _leds.show();
+      return true;
+
+    case CMD_SET_DELAY:
+      if (_length != 2) return false;
+      _leds.setDelay(_read16(p));
+      return true;
+
+    case CMD_SET_COLOR:
+      if (_length != 3) return false;
+      _leds.setColor(p[0], p[1], p[2]);
+      _leds.refresh();
+      return true;
+
+    case CMD_SET_GROUP:
+      if (_length != 4) return false;
+      _leds.setGroup(_read16(p), _read16(p + 2));
+      return true;
+
+    case CMD_RESET_GROUP:
+      if (_length != 0) return false;
+      _leds.resetGroup();
+      return true;
+
+    case CMD_SET_PIXELS: {
+      if (_length < 2) return false;
+      uint16_t start = _read16(p);
+      uint16_t numLeds = _leds.getNumLeds();
+      if (start >= numLeds) return false;
+
+      // LEDs past the end of the strip are dropped
+      if (_leds.getLEDType() == LED_TYPE_RGB) {
+        if ((_length - 2) % 3 != 0) return false;
+        _leds.writeLEDs(start, p + 2, min((_length - 2) / 3, numLeds - start));
+      } else {
+        // One bit per LED, least significant bit first
+        uint16_t count = min((_length - 2) * 8, numLeds - start);
+        for (uint16_t i = 0; i < count; i++) {
+          _leds.setLED(start + i, (bool)((p[2 + (i >> 3)] >> (i & 7)) & 1));
+        }
+      }
+      _leds.show();
+      return true;
+    }
+
+    case CMD_FILL_PIXELS: {
+      if (_length != 7) return false;
+      uint16_t start = _read16(p);
+      uint16_t end = _read16(p + 2);
+
+      if (_leds.getLEDType() == LED_TYPE_RGB) {
+        _leds.fillLEDs(start, end, Color(p[4], p[5], p[6]));
+      } else {
+        _leds.fillLEDs(start, end, (p[4] | p[5] | p[6]) != 0);
+      }
+      _leds.show();
+      return true;
+    }
+
+    case CMD_CLEAR:
+      if (_length != 0) return false;
+      _leds.clear();
+      return true;
+
+    case CMD_VM_WRITE:
+      if (_vm == nullptr || _length < 2) return false;
+      return _vm->write(_read16(p), p + 2, _length - 2);
+
+    case CMD_VM_COMMIT:
+      // A rejected program leaves the running one in place
+      if (_vm == nullptr || _length != 2) return false;
+      if (_vm->commit(_read16(p)) != VM_OK) return false;
+      _vm->start();
+      _leds.refresh();
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// CRC-8, polynomial 0x07 (bitwise, no table to keep flash usage small)
+uint8_t VibeLEDProtocol::_crc8(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+// Read a little-endian 16-bit value
+uint16_t VibeLEDProtocol::_read16(const uint8_t* data) {
+  return (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+}
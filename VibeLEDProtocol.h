@@ -0,0 +1,120 @@
+/*
+  VibeLEDProtocol.h - Compact binary control protocol for VibeLED.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDProtocol_h
+#define VibeLEDProtocol_h
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+class VibeLEDVM;
+
+// Frame layout: SYNC | LEN | CMD | PAYLOAD[LEN] | CRC8
+// The CRC-8 (polynomial 0x07) covers LEN, CMD and the payload.
+#define VIBELED_PROTOCOL_SYNC 0xA5
+
+// Largest payload accepted by the decoder (bytes)
+#ifndef VIBELED_PROTOCOL_MAX_PAYLOAD
+#define VIBELED_PROTOCOL_MAX_PAYLOAD 64
+#endif
+
+#if VIBELED_PROTOCOL_MAX_PAYLOAD > 255
+#error "VIBELED_PROTOCOL_MAX_PAYLOAD must fit the one-byte LEN field (255 at most)"
+#endif
+
+// A partially received frame is dropped after this many milliseconds of silence
+#ifndef VIBELED_PROTOCOL_TIMEOUT
+#define VIBELED_PROTOCOL_TIMEOUT 50
+#endif
+
+// Command IDs (multi-byte fields are little-endian)
+enum CommandType {
+  CMD_SET_EFFECT = 0x01,      // effect [, speed16]
+  CMD_SET_PARAMS = 0x02,      // speed16, brightness, color1, color2, color3, option1, option2
+  CMD_SET_BRIGHTNESS = 0x03,  // brightness
+  CMD_SET_DELAY = 0x04,       // ms16
+  CMD_SET_COLOR = 0x05,       // r, g, b
+  CMD_SET_GROUP = 0x06,       // start16, end16
+  CMD_RESET_GROUP = 0x07,     // (no payload)
+  CMD_SET_PIXELS = 0x08,      // start16, then r, g, b per LED (RGB) or a bitmap (single color)
+  CMD_FILL_PIXELS = 0x09,     // start16, end16, r, g, b
+  CMD_CLEAR = 0x0A,           // (no payload)
+  CMD_VM_WRITE = 0x0B,        // offset16, program bytes (needs setVM())
+  CMD_VM_COMMIT = 0x0C        // length16: verify the uploaded program and start it
+};
+
+// Decoder statistics
+struct ProtocolStats {
+  uint32_t frames;           // Frames decoded and applied
+  uint32_t crcErrors;        // Frames dropped because of a CRC mismatch
+  uint32_t lengthErrors;     // Frames dropped because of a bad length or timeout
+  uint32_t unknownCommands;  // Frames with an unknown command or malformed payload
+  uint32_t lastLatency;      // Microseconds from a command's last byte to the next frame pushed
+  uint32_t maxLatency;       // Worst latency seen since the last resetStats()
+
+  ProtocolStats() :
+    frames(0),
+    crcErrors(0),
+    lengthErrors(0),
+    unknownCommands(0),
+    lastLatency(0),
+    maxLatency(0) {}
+};
+
+class VibeLEDProtocol {
+  public:
+    VibeLEDProtocol(VibeLED& leds);
+
+    // Feed received bytes; complete frames are applied immediately, so call
+    // these from loop() (between update() calls), not from an interrupt
+    void feed(uint8_t data);
+    void feed(const uint8_t* data, uint16_t length);
+    void poll(Stream& stream);
+    void reset();
+
+    // Accept bytecode effect uploads for this interpreter
+    void setVM(VibeLEDVM* vm);
+
+    // Statistics
+    ProtocolStats getStats();
+    void resetStats();
+
+    // Build a frame into out (needs length + 4 bytes); returns the frame size
+    static uint16_t encode(uint8_t command, const uint8_t* payload, uint8_t length, uint8_t* out);
+
+  private:
+    enum State {
+      STATE_SYNC,
+      STATE_LENGTH,
+      STATE_COMMAND,
+      STATE_PAYLOAD,
+      STATE_CRC
+    };
+
+    VibeLED& _leds;
+    VibeLEDVM* _vm;
+    State _state;
+    uint8_t _length;
+    uint8_t _command;
+    uint8_t _received;
+    uint8_t _crc;
+    unsigned long _lastByte;
+    uint8_t _payload[VIBELED_PROTOCOL_MAX_PAYLOAD];
+    ProtocolStats _stats;
+    bool _latencyPending;
+    unsigned long _arrival;
+    uint32_t _arrivalPushes;
+
+    bool _decode(uint8_t data);
+    void _rescan(uint8_t data, State failed);
+    void _closeLatency();
+    bool _apply();
+    static uint8_t _crc8(uint8_t crc, uint8_t data);
+    static uint16_t _read16(const uint8_t* data);
+};
+
+#endif
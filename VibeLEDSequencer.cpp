@@ -0,0 +1,231 @@
+/*
+  VibeLEDSequencer.cpp - Timeline sequencer for VibeLED shows.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDSequencer.h"
+
+// Constructor
+VibeLEDSequencer::VibeLEDSequencer(VibeLED& leds) : _leds(leds) {
+  _cues = nullptr;
+  _numCues = 0;
+  _playing = false;
+  _started = false;
+
+  _index = 0;
+  _cueStart = 0;
+
+  _nextIndex = CUE_NO_LOOP;
+  _preloaded = false;
+
+  _loops = 0;
+  _fadeLevel = 255;
+}
+
+// Start a show now
+void VibeLEDSequencer::play(const Cue* cues, uint8_t count) {
+  play(cues, count, millis());
+}
+
+// Start a show at the given time (ms, same clock as update(now))
+void VibeLEDSequencer::play(const Cue* cues, uint8_t count, unsigned long start) {
+  _cues = cues;
+  _numCues = count;
+  _playing = (count > 0);
+  _started = false;
+  _cueStart = start;
+  _loops = 0;
+  _fadeLevel = 255;
+
+  if (_playing) _load(0);
+}
+
+// Stop the show; the current effect keeps running
+void VibeLEDSequencer::stop() {
+  if (_started && _fadeLevel != 255) {
+    _leds.setBrightness(_cue.brightness);
+  }
+  _playing = false;
+  _fadeLevel = 255;
+}
+
+// Advance the show and the effect
+void VibeLEDSequencer::update() {
+  update(millis());
+}
+
+// Advance the show and the effect at an explicit time (ms)
+void VibeLEDSequencer::update(unsigned long now) {
+  if (!_playing) {
+    _leds.update(now);
+    return;
+  }
+
+  // Switch to every cue whose deadline has passed (normally at most one)
+  bool switched = false;
+  while (_playing) {
+    if (_started && _cue.duration == 0) break;
+
+    unsigned long deadline = _started ? _cueStart + _cue.duration : _cueStart;
+    if ((long)(now - deadline) < 0) break;
+
+    if (!_preloaded) _preload();
+    if (_nextIndex == CUE_NO_LOOP) {
+      // End of the show: the last cue keeps running
+      stop();
+      break;
+    }
+
+    _start(deadline, now);
+    switched = true;
+  }
+
+  if (!_started) return;
+
+  _fade(now);
+  if (switched) {
+    _leds.refresh(now);
+  } else {
+    _leds.update(now);
+  }
+
+  // Read the following cue from flash well before it is needed
+  if (_playing && !_preloaded) _preload();
+}
+
+// True while a show is running
+bool VibeLEDSequencer::isPlaying() {
+  return _playing;
+}
+
+// Index of the current cue
+uint8_t VibeLEDSequencer::getCue() {
+  return _index;
+}
+
+// Time since the current cue started (ms)
+unsigned long VibeLEDSequencer::getCueElapsed(unsigned long now) {
+  return _started ? now - _cueStart : 0;
+}
+
+// Get sequencer statistics
+SequencerStats VibeLEDSequencer::getStats() {
+  return _stats;
+}
+
+// Reset sequencer statistics
+void VibeLEDSequencer::resetStats() {
+  _stats = SequencerStats();
+}
+
+// Copy a cue from flash and prepare its effect parameters
+void VibeLEDSequencer::_load(uint8_t index) {
+  _nextIndex = index;
+  memcpy_P(&_next, &_cues[index], sizeof(Cue));
+
+  _nextParams.speed = _next.speed;
+  _nextParams.brightness = _next.brightness;
+  _nextParams.color1 = Color(_next.color1[0], _next.color1[1], _next.color1[2]);
+  _nextParams.color2 = Color(_next.color2[0], _next.color2[1], _next.color2[2]);
+  _nextParams.color3 = Color(_next.color3[0], _next.color3[1], _next.color3[2]);
+  _nextParams.option1 = _next.option1;
+  _nextParams.option2 = _next.option2;
+  _preloaded = true;
+}
+
+// Work out which cue follows the current one and load it.
+// Only one loop point is active at a time (loops do not nest).
+void VibeLEDSequencer::_preload() {
+  uint16_t next = _index + 1;
+
+  if (_cue.loopTo != CUE_NO_LOOP && _cue.loopTo < _numCues) {
+    if (_cue.loopCount == 0) {
+      next = _cue.loopTo;
+    } else if (_loops < _cue.loopCount) {
+      _loops++;
+      next = _cue.loopTo;
+    } else {
+      _loops = 0;
+    }
+  }
+
+  if (next >= _numCues) {
+    _nextIndex = CUE_NO_LOOP;
+    _preloaded = true;
+    return;
+  }
+  _load(next);
+}
+
+// Switch to the preloaded cue; deadline is when it should have started
+void VibeLEDSequencer::_start(unsigned long deadline, unsigned long now) {
+  unsigned long begin = micros();
+
+  _index = _nextIndex;
+  _cue = _next;
+  _cueStart = deadline;
+  _started = true;
+  _preloaded = false;
+
+  uint16_t numLeds = _leds.getNumLeds();
+  uint16_t first = min(_cue.first, (uint16_t)(numLeds - 1));
+  uint16_t last = (_cue.last == CUE_ALL_LEDS) ? numLeds - 1 : _cue.last;
+
+  // Turn off everything outside the segment
+  if (_cue.transition & CUE_CLEAR) {
+    bool rgb = (_leds.getLEDType() == LED_TYPE_RGB);
+    if (first > 0) {
+      if (rgb) {
+        _leds.fillLEDs(0, first - 1, Color(0, 0, 0));
+      } else {
+        _leds.fillLEDs(0, first - 1, false);
+      }
+    }
+    if (last < numLeds - 1) {
+      if (rgb) {
+        _leds.fillLEDs(last + 1, numLeds - 1, Color(0, 0, 0));
+      } else {
+        _leds.fillLEDs(last + 1, numLeds - 1, false);
+      }
+    }
+  }
+
+  _leds.setGroup(first, last);
+  _leds.setEffect((EffectType)_cue.effect, _nextParams);
+  _fadeLevel = 255;
+
+  int32_t error = (int32_t)(now - deadline);
+  _stats.cues++;
+  _stats.lastError = error;
+  if (error > _stats.maxError) _stats.maxError = error;
+
+  uint32_t elapsed = micros() - begin;
+  if (elapsed > _stats.switchMicros) _stats.switchMicros = elapsed;
+}
+
+// Scale the cue brightness for fades into and out of it
+void VibeLEDSequencer::_fade(unsigned long now) {
+  uint8_t level = 255;
+  unsigned long elapsed = now - _cueStart;
+
+  // Fade in: first half of this cue's fade time
+  if ((_cue.transition & ~CUE_CLEAR) == CUE_FADE && _cue.fadeTime > 1) {
+    unsigned long half = _cue.fadeTime / 2;
+    if (elapsed < half) level = (elapsed * 255) / half;
+  }
+
+  // Fade out: second half of the next cue's fade time
+  if (_preloaded && _nextIndex != CUE_NO_LOOP && _cue.duration > 0 &&
+      (_next.transition & ~CUE_CLEAR) == CUE_FADE && _next.fadeTime > 1) {
+    unsigned long half = _next.fadeTime / 2;
+    unsigned long remaining = (elapsed < _cue.duration) ? _cue.duration - elapsed : 0;
+    if (remaining < half) level = min(level, (uint8_t)((remaining * 255) / half));
+  }
+
+  if (level != _fadeLevel) {
+    _fadeLevel = level;
+    _leds.setBrightness(((uint16_t)_cue.brightness * level) / 255);
+  }
+}
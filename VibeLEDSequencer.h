@@ -0,0 +1,124 @@
+/*
+  VibeLEDSequencer.h - Timeline sequencer for VibeLED shows.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDSequencer_h
+#define VibeLEDSequencer_h
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+// Transitions into a cue
+#define CUE_CUT 0          // Switch at the deadline
+#define CUE_FADE 1         // Fade the previous cue out and this one in
+#define CUE_CLEAR 0x80     // Flag: turn off the LEDs outside this cue's segment
+
+// Segment end meaning "to the last LED"
+#define CUE_ALL_LEDS 0xFFFF
+
+// loopTo value for cues that simply continue with the next one
+#define CUE_NO_LOOP 0xFF
+
+// One step of a show. Plain data so cue lists can live in flash (PROGMEM):
+//
+//   const Cue show[] PROGMEM = {
+//     // effect, speed, brightness, color1, color2, color3, option1, option2,
+//     // first, last LED, duration (ms), transition, fade (ms), loopTo, loopCount
+//     { EFFECT_BREATHE, 20, 255, {255, 0, 0}, {0, 0, 0}, {0, 0, 0}, 0, 0, 0, CUE_ALL_LEDS, 10000, CUE_CUT, 0, CUE_NO_LOOP, 0 },
+//     { EFFECT_RAINBOW, 30, 255, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, 0, 0, 0, CUE_ALL_LEDS, 30000, CUE_FADE, 1000, CUE_NO_LOOP, 0 },
+//     { EFFECT_CHASE, 50, 255, {0, 0, 255}, {0, 0, 0}, {0, 0, 0}, 0, 0, 0, 49, 20000, CUE_FADE | CUE_CLEAR, 1000, 0, 0 }
+//   };
+struct Cue {
+  uint8_t effect;         // EffectType
+  uint16_t speed;         // Effect speed (ms per step)
+  uint8_t brightness;     // Effect brightness (0-255)
+  uint8_t color1[3];      // Primary color (r, g, b)
+  uint8_t color2[3];      // Secondary color (r, g, b)
+  uint8_t color3[3];      // Tertiary color (r, g, b)
+  uint8_t option1;        // Effect-specific option 1
+  uint8_t option2;        // Effect-specific option 2
+  uint16_t first;         // First LED of the segment
+  uint16_t last;          // Last LED of the segment (CUE_ALL_LEDS = end of strip)
+  uint32_t duration;      // Cue length in ms (0 = hold until stop())
+  uint8_t transition;     // CUE_CUT or CUE_FADE, optionally | CUE_CLEAR
+  uint16_t fadeTime;      // Length of a CUE_FADE transition (ms)
+  uint8_t loopTo;         // Cue to jump back to afterwards (CUE_NO_LOOP = continue)
+  uint8_t loopCount;      // Number of jumps back before continuing (0 = forever)
+};
+
+// Sequencer statistics
+struct SequencerStats {
+  uint32_t cues;          // Cues started
+  int32_t lastError;      // How late the last cue started (ms)
+  int32_t maxError;       // Latest cue start since resetStats() (ms)
+  uint32_t switchMicros;  // Worst time spent switching to a cue (microseconds)
+
+  SequencerStats() :
+    cues(0),
+    lastError(0),
+    maxError(0),
+    switchMicros(0) {}
+};
+
+// Plays a list of cues on a VibeLED instance. Cue deadlines are computed from
+// the show start, not from when the previous switch happened, so timing
+// errors do not accumulate. The next cue is read from flash and converted to
+// effect parameters right after the current one's first frame, so a switch
+// only changes a few fields and renders the new cue's first frame in the same
+// update() call.
+class VibeLEDSequencer {
+  public:
+    VibeLEDSequencer(VibeLED& leds);
+
+    // Playback control (cues must point to PROGMEM)
+    void play(const Cue* cues, uint8_t count);
+    void play(const Cue* cues, uint8_t count, unsigned long start);
+    void stop();
+
+    // Call from loop() instead of VibeLED::update()
+    void update();
+    void update(unsigned long now);
+
+    // State queries
+    bool isPlaying();
+    uint8_t getCue();
+    unsigned long getCueElapsed(unsigned long now);
+
+    // Statistics
+    SequencerStats getStats();
+    void resetStats();
+
+  private:
+    VibeLED& _leds;
+
+    const Cue* _cues;
+    uint8_t _numCues;
+    bool _playing;
+    bool _started;
+
+    // Current cue
+    uint8_t _index;
+    Cue _cue;
+    unsigned long _cueStart;    // Deadline the current cue started at
+
+    // Preloaded next cue
+    uint8_t _nextIndex;         // CUE_NO_LOOP when the show ends
+    Cue _next;
+    EffectParams _nextParams;
+    bool _preloaded;
+
+    uint8_t _loops;             // Jumps back taken at the current loop point
+    uint8_t _fadeLevel;         // Brightness scale applied last (255 = none)
+
+    SequencerStats _stats;
+
+    void _load(uint8_t index);
+    void _preload();
+    void _start(unsigned long deadline, unsigned long now);
+    void _fade(unsigned long now);
+};
+
+#endif
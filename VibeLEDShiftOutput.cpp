@@ -0,0 +1,221 @@
+/*
+  VibeLEDShiftOutput.cpp - 74HC595 shift register chain output for VibeLED.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDShiftOutput.h"
+#include "VibeLEDProfile.h"
+
+// Constructor
+VibeLEDShiftOutput::VibeLEDShiftOutput(uint8_t dataPin, uint8_t clockPin, uint8_t latchPin, uint8_t depth) {
+  _dataPin = dataPin;
+  _clockPin = clockPin;
+  _latchPin = latchPin;
+  _depth = constrain(depth, 1, 8);
+
+  _numBytes = 0;
+  _planes = nullptr;
+  _front = nullptr;
+  _back = nullptr;
+  _pending = false;
+
+  _plane = 0;
+  _planeStart = 0;
+  _planeLength = 0;
+  setRefreshRate(200);
+
+  resetStats();
+}
+
+// Destructor
+VibeLEDShiftOutput::~VibeLEDShiftOutput() {
+  delete[] _planes;
+}
+
+// Initialize pins and allocate the bit planes
+void VibeLEDShiftOutput::begin(VibeLED& leds) {
+  pinMode(_dataPin, OUTPUT);
+  pinMode(_clockPin, OUTPUT);
+  pinMode(_latchPin, OUTPUT);
+  digitalWrite(_clockPin, LOW);
+  digitalWrite(_latchPin, LOW);
+
+#if defined(__AVR__)
+  _dataPort = portOutputRegister(digitalPinToPort(_dataPin));
+  _clockPort = portOutputRegister(digitalPinToPort(_clockPin));
+  _dataMask = digitalPinToBitMask(_dataPin);
+  _clockMask = digitalPinToBitMask(_clockPin);
+#endif
+
+  uint32_t outputs = (uint32_t)leds.getNumLeds() * (leds.getLEDType() == LED_TYPE_RGB ? 3 : 1);
+  _numBytes = (outputs + 7) / 8;
+
+  delete[] _planes;
+  _planes = new uint8_t[(uint32_t)_numBytes * _depth * 2];
+  VIBELED_PROFILE_ALLOCATION((uint32_t)_numBytes * _depth * 2);
+  for (uint32_t i = 0; i < (uint32_t)_numBytes * _depth * 2; i++) {
+    _planes[i] = 0;
+  }
+  _front = _planes;
+  _back = _planes + (uint32_t)_numBytes * _depth;
+
+  _plane = 0;
+  _planeStart = micros();
+  _planeLength = _unitMicros;
+  _writePlane(_front);
+}
+
+// Convert a frame into bit planes
+void VibeLEDShiftOutput::show(VibeLED& leds) {
+  if (_planes == nullptr) return;
+
+  // Keep refresh() from swapping in a half-written frame
+  _pending = false;
+
+  for (uint32_t i = 0; i < (uint32_t)_numBytes * _depth; i++) {
+    _back[i] = 0;
+  }
+
+  uint8_t brightness = leds.getOutputBrightness();
+  bool rgb = leds.getLEDType() == LED_TYPE_RGB;
+  uint8_t shift = 8 - _depth;
+  uint16_t numLeds = leds.getNumLeds();
+  uint32_t output = 0;
+
+  for (uint16_t i = 0; i < numLeds; i++) {
+    uint8_t values[3];
+    uint8_t channels;
+
+    if (rgb) {
+      // Brightness, power limiting and dithering are already applied
+      Color color = leds.getOutputColor(i);
+      values[0] = color.r;
+      values[1] = color.g;
+      values[2] = color.b;
+      channels = 3;
+    } else {
+      values[0] = leds.getLEDState(i) ? brightness : 0;
+      channels = 1;
+    }
+
+    for (uint8_t c = 0; c < channels; c++, output++) {
+      uint8_t level = values[c] >> shift;
+      uint8_t* byte = _back + (output >> 3);
+      uint8_t mask = 1 << (output & 7);
+
+      for (uint8_t b = 0; b < _depth; b++) {
+        if (level & (1 << b)) {
+          byte[(uint32_t)b * _numBytes] |= mask;
+        }
+      }
+    }
+  }
+
+  if (_depth == 1) {
+    // No modulation: latch the frame right away
+    uint8_t* swap = _front;
+    _front = _back;
+    _back = swap;
+    _writePlane(_front);
+  } else {
+    _pending = true;
+  }
+}
+
+// Set the target refresh rate (complete modulation cycles per second)
+void VibeLEDShiftOutput::setRefreshRate(uint16_t hz) {
+  if (hz == 0) hz = 1;
+  uint32_t units = (1UL << _depth) - 1;
+  _unitMicros = 1000000UL / ((uint32_t)hz * units);
+  if (_unitMicros == 0) _unitMicros = 1;
+}
+
+// Advance binary code modulation; shifts out a new plane only when one is due
+void VibeLEDShiftOutput::refresh() {
+  if (_depth == 1 || _planes == nullptr) return;
+
+  unsigned long now = micros();
+  if (now - _planeStart < _planeLength) return;
+
+  uint8_t next = _plane + 1;
+  if (next >= _depth) {
+    next = 0;
+    _cycles++;
+
+    // Only swap frames on a cycle boundary so every cycle is consistent
+    if (_pending) {
+      uint8_t* swap = _front;
+      _front = _back;
+      _back = swap;
+      _pending = false;
+    }
+  }
+
+  _planeStart += _planeLength;
+  _plane = next;
+  _planeLength = _unitMicros << next;
+
+  // Resynchronize if refresh() was called too late to catch up
+  if (now - _planeStart >= _planeLength) {
+    _planeStart = now;
+  }
+
+  _writePlane(_front + (uint32_t)next * _numBytes);
+}
+
+// Get output statistics
+ShiftOutputStats VibeLEDShiftOutput::getStats() {
+  ShiftOutputStats stats;
+  unsigned long elapsed = micros() - _statsStart;
+
+  stats.cycles = _cycles;
+  stats.planeWrites = _planeWrites;
+  stats.busyMicros = _busyMicros;
+  stats.refreshRate = (elapsed > 0) ? (uint16_t)(((uint64_t)_cycles * 1000000UL) / elapsed) : 0;
+  stats.cpuLoad = (elapsed > 0) ? (uint16_t)(((uint64_t)_busyMicros * 1000UL) / elapsed) : 0;
+
+  return stats;
+}
+
+// Reset output statistics
+void VibeLEDShiftOutput::resetStats() {
+  _statsStart = micros();
+  _cycles = 0;
+  _planeWrites = 0;
+  _busyMicros = 0;
+}
+
+// Shift one bit plane into the chain and latch it
+void VibeLEDShiftOutput::_writePlane(const uint8_t* plane) {
+  unsigned long start = micros();
+
+  // The last register in the chain is shifted first
+  for (uint16_t i = _numBytes; i > 0; i--) {
+    _shiftByte(plane[i - 1]);
+  }
+  digitalWrite(_latchPin, HIGH);
+  digitalWrite(_latchPin, LOW);
+
+  _planeWrites++;
+  _busyMicros += micros() - start;
+}
+
+// Shift one byte out, most significant bit (Q7) first
+void VibeLEDShiftOutput::_shiftByte(uint8_t value) {
+#if defined(__AVR__)
+  for (uint8_t i = 0; i < 8; i++) {
+    if (value & 0x80) {
+      *_dataPort |= _dataMask;
+    } else {
+      *_dataPort &= ~_dataMask;
+    }
+    *_clockPort |= _clockMask;
+    *_clockPort &= ~_clockMask;
+    value <<= 1;
+  }
+#else
+  shiftOut(_dataPin, _clockPin, MSBFIRST, value);
+#endif
+}
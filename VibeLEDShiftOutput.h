@@ -0,0 +1,82 @@
+/*
+  VibeLEDShiftOutput.h - 74HC595 shift register chain output for VibeLED.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDShiftOutput_h
+#define VibeLEDShiftOutput_h
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+// Shift register output statistics
+struct ShiftOutputStats {
+  uint32_t cycles;       // Complete modulation cycles since resetStats()
+  uint32_t planeWrites;  // Bit planes shifted out since resetStats()
+  uint32_t busyMicros;   // Time spent shifting and latching
+  uint16_t refreshRate;  // Measured refresh rate (Hz)
+  uint16_t cpuLoad;      // Share of CPU time spent in the output (per mille)
+};
+
+// Drives a chain of 74HC595 shift registers. Output 0 is Q0 of the first
+// register after the MCU. Single color LEDs use one output each; RGB LEDs use
+// three consecutive outputs (R, G, B).
+//
+// With a depth of 1 every frame is shifted out once in show(). With a depth of
+// 2-8 bits, binary code modulation gives each output 2^depth brightness levels:
+// bit plane n is held for 2^n time units, so a refresh cycle needs only `depth`
+// shift bursts no matter how many levels there are. Call refresh() as often as
+// possible (from loop() or a timer interrupt) to keep the planes on time.
+class VibeLEDShiftOutput : public VibeLEDOutput {
+  public:
+    VibeLEDShiftOutput(uint8_t dataPin, uint8_t clockPin, uint8_t latchPin, uint8_t depth = 1);
+    ~VibeLEDShiftOutput();
+
+    // VibeLEDOutput interface
+    void begin(VibeLED& leds);
+    void show(VibeLED& leds);
+
+    // Binary code modulation
+    void setRefreshRate(uint16_t hz);
+    void refresh();
+
+    // Statistics
+    ShiftOutputStats getStats();
+    void resetStats();
+
+  private:
+    uint8_t _dataPin;
+    uint8_t _clockPin;
+    uint8_t _latchPin;
+    uint8_t _depth;
+
+    uint16_t _numBytes;
+    uint8_t* _planes;          // Two sets of `depth` bit planes (front and back)
+    uint8_t* _front;
+    uint8_t* _back;
+    volatile bool _pending;    // Back planes hold a new frame
+
+    uint8_t _plane;
+    unsigned long _planeStart;
+    unsigned long _planeLength;
+    unsigned long _unitMicros;
+
+    unsigned long _statsStart;
+    uint32_t _cycles;
+    uint32_t _planeWrites;
+    uint32_t _busyMicros;
+
+#if defined(__AVR__)
+    volatile uint8_t* _dataPort;
+    volatile uint8_t* _clockPort;
+    uint8_t _dataMask;
+    uint8_t _clockMask;
+#endif
+
+    void _writePlane(const uint8_t* plane);
+    void _shiftByte(uint8_t value);
+};
+
+#endif
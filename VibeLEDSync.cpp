@@ -0,0 +1,225 @@
+/*
+  VibeLEDSync.cpp - Shared clock for synchronized playback across VibeLED controllers.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDSync.h"
+
+// Constructor
+VibeLEDSync::VibeLEDSync(VibeLEDSyncTransport& transport, bool master) : _transport(transport) {
+  _master = master;
+  _interval = 1000;
+  _latency = 0;
+
+  _lastMicros = 0;
+  _wraps = 0;
+
+  _lastSend = 0;
+  _sequence = 0;
+
+  _locked = master;
+  _haveSequence = false;
+  _lastSequence = 0;
+  _offset = 0;
+  _correction = 0;
+  _anchor = 0;
+  _lastLocal = 0;
+  _lastShared = 0;
+  _skew = 0;
+  _numSamples = 0;
+  _nextSample = 0;
+
+  _stats.sent = 0;
+  _stats.received = 0;
+  _stats.rejected = 0;
+  _stats.lastError = 0;
+  _stats.skew = 0;
+  _stats.locked = master;
+}
+
+// Set how often the master sends its time (ms)
+void VibeLEDSync::setInterval(uint16_t ms) {
+  _interval = max(ms, 1);
+}
+
+// Set the fixed transport delay to compensate for (microseconds)
+void VibeLEDSync::setLatency(uint16_t us) {
+  _latency = us;
+}
+
+// Send or receive sync messages
+void VibeLEDSync::update() {
+  uint64_t local = _localMicros();
+
+  if (_master) {
+    if (local - _lastSend >= (uint64_t)_interval * 1000) {
+      uint8_t message[VIBELED_SYNC_MESSAGE_SIZE];
+      uint8_t length = encode(_sequence++, local, message);
+      _transport.send(message, length);
+      _lastSend = local;
+      _stats.sent++;
+    }
+    return;
+  }
+
+  uint8_t message[VIBELED_SYNC_MESSAGE_SIZE];
+  uint8_t length;
+  while ((length = _transport.receive(message, sizeof(message))) > 0) {
+    receive(message, length, local);
+  }
+}
+
+// Shared time in milliseconds
+unsigned long VibeLEDSync::now() {
+  return (unsigned long)(nowMicros() / 1000);
+}
+
+// Shared time in microseconds
+uint64_t VibeLEDSync::nowMicros() {
+  return toShared(_localMicros());
+}
+
+// Convert a local time to shared time (microseconds). Times at or after
+// the previous conversion never give an earlier shared time.
+uint64_t VibeLEDSync::toShared(uint64_t localMicros) {
+  if (_master) return localMicros;
+
+  uint64_t shared = localMicros + _offsetAt(localMicros);
+  if (localMicros >= _lastLocal) {
+    if (shared < _lastShared) shared = _lastShared;
+    _lastLocal = localMicros;
+    _lastShared = shared;
+  }
+  return shared;
+}
+
+// Apply a received sync message
+bool VibeLEDSync::receive(const uint8_t* data, uint8_t length, uint64_t localMicros) {
+  if (_master) return false;
+
+  if (length != VIBELED_SYNC_MESSAGE_SIZE || data[0] != 'V' || data[1] != 'S' ||
+      (_haveSequence && data[2] == _lastSequence)) {
+    _stats.rejected++;
+    return false;
+  }
+  _haveSequence = true;
+  _lastSequence = data[2];
+
+  // Offset shown so far, before the skew and anchor change
+  int64_t current = _offsetAt(localMicros);
+
+  uint64_t master = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    master |= (uint64_t)data[3 + i] << (8 * i);
+  }
+
+  // Each message gives offset - delay; keep a window of recent samples
+  _samples[_nextSample] = (int64_t)(master + _latency - localMicros);
+  _sampleTimes[_nextSample] = (uint32_t)localMicros;
+  uint8_t newest = _nextSample;
+  _nextSample = (_nextSample + 1) % VIBELED_SYNC_WINDOW;
+  if (_numSamples < VIBELED_SYNC_WINDOW) _numSamples++;
+
+  // Skew: least-squares slope of the samples (delays average out).
+  // x is the sample age in ms, y the sample relative to the newest in us.
+  if (_numSamples >= 4) {
+    int64_t sumX = 0;
+    int64_t sumY = 0;
+    int64_t sumXY = 0;
+    int64_t sumXX = 0;
+    for (uint8_t i = 0; i < _numSamples; i++) {
+      int64_t x = -(int64_t)(((uint32_t)localMicros - _sampleTimes[i]) / 1000);
+      int64_t y = _samples[i] - _samples[newest];
+      sumX += x;
+      sumY += y;
+      sumXY += x * y;
+      sumXX += x * x;
+    }
+
+    int64_t numerator = _numSamples * sumXY - sumX * sumY;
+    int64_t denominator = _numSamples * sumXX - sumX * sumX;
+    if (denominator > 0) {
+      // us per ms to units of 2^-24, smoothed once the window is full
+      int32_t fit = (int32_t)((numerator * 16777) / denominator);
+      _skew = (_numSamples < VIBELED_SYNC_WINDOW) ? fit : _skew + (fit - _skew) / 4;
+    }
+  }
+
+  // Offset: the least delayed sample (largest offset), projected to now
+  int64_t best = 0;
+  for (uint8_t i = 0; i < _numSamples; i++) {
+    int64_t elapsed = (uint32_t)localMicros - _sampleTimes[i];
+    int64_t sample = _samples[i] + (((int64_t)_skew * elapsed) >> 24);
+    if (i == 0 || sample > best) best = sample;
+  }
+
+  // Slew from the offset shown so far towards the new one; the first
+  // message and large errors are stepped
+  int64_t error = best - current;
+  if (_locked) {
+    _stats.lastError = (int32_t)error;
+  }
+  if (_locked && error <= VIBELED_SYNC_MAX_SLEW && error >= -VIBELED_SYNC_MAX_SLEW) {
+    _offset = current;
+    _correction = error;
+  } else {
+    _offset = best;
+    _correction = 0;
+    _lastLocal = 0;
+    _lastShared = 0;
+  }
+  _anchor = localMicros;
+  _locked = true;
+
+  _stats.received++;
+  _stats.locked = true;
+  _stats.skew = (int32_t)(((int64_t)_skew * 1000000) >> 24);
+  return true;
+}
+
+// Build a sync message
+uint8_t VibeLEDSync::encode(uint8_t sequence, uint64_t masterMicros, uint8_t* out) {
+  out[0] = 'V';
+  out[1] = 'S';
+  out[2] = sequence;
+  for (uint8_t i = 0; i < 8; i++) {
+    out[3 + i] = (uint8_t)(masterMicros >> (8 * i));
+  }
+  return VIBELED_SYNC_MESSAGE_SIZE;
+}
+
+// True once the shared clock is valid
+bool VibeLEDSync::isLocked() {
+  return _locked;
+}
+
+// Get synchronization statistics
+SyncStats VibeLEDSync::getStats() {
+  return _stats;
+}
+
+// Shared minus local time at a local time: the offset at the last
+// correction, plus skew and the part of the correction slewed in since
+int64_t VibeLEDSync::_offsetAt(uint64_t localMicros) {
+  int64_t elapsed = (int64_t)(localMicros - _anchor);
+  int64_t offset = _offset + (((int64_t)_skew * elapsed) >> 24);
+  if (elapsed > 0 && _correction != 0) {
+    int64_t slewed = elapsed >> VIBELED_SYNC_SLEW_SHIFT;
+    if (_correction > 0) {
+      offset += (slewed < _correction) ? slewed : _correction;
+    } else {
+      offset -= (slewed < -_correction) ? slewed : -_correction;
+    }
+  }
+  return offset;
+}
+
+// micros() extended to 64 bits (call at least once every 70 minutes)
+uint64_t VibeLEDSync::_localMicros() {
+  uint32_t now = micros();
+  if (now < _lastMicros) _wraps++;
+  _lastMicros = now;
+  return ((uint64_t)_wraps << 32) | now;
+}
@@ -0,0 +1,127 @@
+/*
+  VibeLEDSync.h - Shared clock for synchronized playback across VibeLED controllers.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDSync_h
+#define VibeLEDSync_h
+
+#include "Arduino.h"
+
+// Sync message: 'V' 'S' | sequence | master time (64-bit microseconds, little-endian)
+#define VIBELED_SYNC_MESSAGE_SIZE 11
+
+// Number of recent sync messages used to reject transport jitter
+#ifndef VIBELED_SYNC_WINDOW
+#define VIBELED_SYNC_WINDOW 16
+#endif
+
+// Offset corrections are slewed in at 1/2^VIBELED_SYNC_SLEW_SHIFT of the
+// elapsed time (4: 62.5 us per ms) so the shared clock never runs backwards.
+// Larger corrections than VIBELED_SYNC_MAX_SLEW microseconds (e.g. after the
+// master restarted) are stepped instead.
+#ifndef VIBELED_SYNC_SLEW_SHIFT
+#define VIBELED_SYNC_SLEW_SHIFT 4
+#endif
+
+#ifndef VIBELED_SYNC_MAX_SLEW
+#define VIBELED_SYNC_MAX_SLEW 1000000
+#endif
+
+// Transport for sync messages (UDP broadcast, ESP-NOW, RS-485, radio, ...)
+class VibeLEDSyncTransport {
+  public:
+    virtual ~VibeLEDSyncTransport() {}
+    virtual void send(const uint8_t* data, uint8_t length) = 0;
+    virtual uint8_t receive(uint8_t* data, uint8_t maxLength) = 0;  // Bytes received, 0 if none
+};
+
+// Synchronization statistics
+struct SyncStats {
+  uint32_t sent;       // Sync messages sent (master)
+  uint32_t received;   // Sync messages accepted (followers)
+  uint32_t rejected;   // Malformed or duplicate messages
+  int32_t lastError;   // Phase error corrected at the last sync (microseconds)
+  int32_t skew;        // Estimated clock skew versus the master (parts per million)
+  bool locked;         // At least one sync message has been applied
+};
+
+// Keeps a shared clock across controllers. The master broadcasts its time;
+// followers estimate their skew from a least-squares fit over the last
+// VIBELED_SYNC_WINDOW messages, and their offset from the least delayed of
+// those messages projected with that skew, which rejects transport jitter.
+// Between messages the shared clock keeps running at the master's rate, and
+// once locked it is monotonic: corrections are slewed in, and successive
+// conversions never go backwards (apart from stepped corrections).
+//
+// Use the shared time with VibeLED::setTimebase() and update(now) so every
+// controller renders the identical frame:
+//
+//   leds.setTimebase(0, 1234);
+//   sync.update();
+//   leds.update(sync.now());
+class VibeLEDSync {
+  public:
+    VibeLEDSync(VibeLEDSyncTransport& transport, bool master = false);
+
+    // Configuration
+    void setInterval(uint16_t ms);
+    void setLatency(uint16_t us);
+
+    // Call from loop(): sends (master) or receives (followers) sync messages
+    void update();
+
+    // Shared time
+    unsigned long now();
+    uint64_t nowMicros();
+    uint64_t toShared(uint64_t localMicros);
+
+    // Apply a received message with an explicit local receive time
+    // (for transports that timestamp on arrival, and for host simulation)
+    bool receive(const uint8_t* data, uint8_t length, uint64_t localMicros);
+
+    // Build a sync message for the given master time
+    static uint8_t encode(uint8_t sequence, uint64_t masterMicros, uint8_t* out);
+
+    // Statistics
+    bool isLocked();
+    SyncStats getStats();
+
+  private:
+    VibeLEDSyncTransport& _transport;
+    bool _master;
+    uint16_t _interval;
+    uint16_t _latency;
+
+    // 64-bit local clock built from micros()
+    uint32_t _lastMicros;
+    uint32_t _wraps;
+
+    // Master state
+    uint64_t _lastSend;
+    uint8_t _sequence;
+
+    // Follower state
+    bool _locked;
+    bool _haveSequence;
+    uint8_t _lastSequence;
+    int64_t _offset;       // Shared minus local time at _anchor (microseconds)
+    int64_t _correction;   // Offset correction slewed in after _anchor
+    uint64_t _anchor;      // Local time of the last correction
+    uint64_t _lastLocal;   // Last conversion, kept so shared time is monotonic
+    uint64_t _lastShared;
+    int32_t _skew;         // Rate difference, in units of 2^-24
+    int64_t _samples[VIBELED_SYNC_WINDOW];       // Master minus local time
+    uint32_t _sampleTimes[VIBELED_SYNC_WINDOW];  // Local receive times (low 32 bits)
+    uint8_t _numSamples;
+    uint8_t _nextSample;
+
+    SyncStats _stats;
+
+    int64_t _offsetAt(uint64_t localMicros);
+    uint64_t _localMicros();
+};
+
+#endif
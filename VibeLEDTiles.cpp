@@ -0,0 +1,235 @@
+/*
+  VibeLEDTiles.cpp - Parallel tiled rendering for very large strips (Linux, macOS, Windows).
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+// Standard headers first: Arduino.h may define min() and max() as macros
+#if defined(__linux__) || defined(__APPLE__) || defined(_WIN32)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+#include "VibeLEDTiles.h"
+#include "VibeLEDProfile.h"
+
+#ifdef VIBELED_HAS_TILES
+
+// Worker threads and the frame they are rendering
+struct VibeLEDTilePool {
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable start;   // A new frame is ready
+  std::condition_variable done;    // The last worker finished
+  uint32_t generation;             // Incremented for every frame
+  uint8_t pending;                 // Workers still rendering the frame
+  bool stop;
+
+  // Current frame (written under the mutex before the workers start)
+  uint16_t first;
+  uint16_t last;
+  uint32_t lastTile;
+  bool trackPower;
+  std::atomic<uint32_t> nextTile;  // Next tile to claim
+  std::vector<int32_t> power;      // Change in the power estimate per worker
+};
+
+// Constructor (0 threads = one per core)
+VibeLEDTileRenderer::VibeLEDTileRenderer(VibeLED& leds, uint8_t threads, uint16_t tileSize) :
+  _leds(leds) {
+  if (threads == 0) {
+    threads = min(max(std::thread::hardware_concurrency(), 1u), 255u);
+  }
+  _threads = threads;
+  _tileSize = (tileSize > 0) ? tileSize : VIBELED_TILE_SIZE;
+  _stats = TileStats();
+
+  _pool = new VibeLEDTilePool();
+  _pool->generation = 0;
+  _pool->pending = 0;
+  _pool->stop = false;
+  _pool->power.resize(_threads);
+
+  // The calling thread renders too, so start one worker less
+  for (uint8_t i = 1; i < _threads; i++) {
+    _pool->threads.push_back(std::thread(_workerLoop, this, i));
+  }
+}
+
+// Destructor (stops the workers)
+VibeLEDTileRenderer::~VibeLEDTileRenderer() {
+  {
+    std::lock_guard<std::mutex> lock(_pool->mutex);
+    _pool->stop = true;
+  }
+  _pool->start.notify_all();
+
+  for (size_t i = 0; i < _pool->threads.size(); i++) {
+    _pool->threads[i].join();
+  }
+  delete _pool;
+}
+
+// Update the effect (should be called in loop())
+void VibeLEDTileRenderer::update() {
+  update(millis());
+}
+
+// Update the effect at an explicit time in milliseconds
+void VibeLEDTileRenderer::update(unsigned long now) {
+  if (_leds._frameDue(now)) {
+    unsigned long start = micros();
+    _renderFrame();
+    _leds._recordRender(start);
+    _leds._applyStates();
+  } else if (_leds._pushPending) {
+    _leds._pushPending = false;
+    _leds._applyStates();
+  }
+}
+
+// Render the next frame if it is due, without pushing it to the outputs
+bool VibeLEDTileRenderer::render(unsigned long now) {
+  if (!_leds._frameDue(now)) return false;
+
+  unsigned long start = micros();
+  _renderFrame();
+  _leds._recordRender(start);
+  _leds._limitPower();
+  _leds._ditherFrame();
+
+  // The frame is pushed elsewhere, so only the render time counts
+  _leds._recordOutput(micros());
+  _leds._recordPush();
+  return true;
+}
+
+// Number of threads, including the calling thread
+uint8_t VibeLEDTileRenderer::getThreads() {
+  return _threads;
+}
+
+// LEDs per tile
+uint16_t VibeLEDTileRenderer::getTileSize() {
+  return _tileSize;
+}
+
+// Get renderer statistics
+TileStats VibeLEDTileRenderer::getStats() {
+  return _stats;
+}
+
+// Render one frame, in tiles when the effect allows it
+void VibeLEDTileRenderer::_renderFrame() {
+  VibeLEDTilePool& pool = *_pool;
+
+  // Tiles are aligned to multiples of the tile size, so neighbouring tiles
+  // never share a cache line except at the group edges
+  uint16_t first = _leds._groupStart;
+  uint16_t last = _leds._groupEnd;
+  uint32_t firstTile = first / _tileSize;
+  uint32_t lastTile = last / _tileSize;
+
+  if (!_leds._isPixelEffect() || _threads < 2 || firstTile == lastTile) {
+    _leds._updateEffect();
+    _stats.serialFrames++;
+    return;
+  }
+
+  VIBELED_PROFILE_START(ticks);
+
+  // The running power total is not thread safe: suspend it while the tiles
+  // render and add up the change in each tile instead
+  uint16_t powerLimit = _leds._powerLimit;
+  _leds._powerLimit = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.first = first;
+    pool.last = last;
+    pool.lastTile = lastTile;
+    pool.trackPower = (powerLimit > 0);
+    pool.nextTile.store(firstTile);
+    pool.pending = _threads - 1;
+    pool.generation++;
+  }
+  pool.start.notify_all();
+
+  _renderTiles(0);
+
+  {
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    while (pool.pending > 0) {
+      pool.done.wait(lock);
+    }
+  }
+
+  _leds._powerLimit = powerLimit;
+  if (powerLimit > 0) {
+    for (uint8_t i = 0; i < _threads; i++) {
+      _leds._powerLevel += pool.power[i];
+    }
+  }
+
+  VIBELED_PROFILE_RENDER(_leds._currentEffect, ticks);
+  _leds._endFrame();
+  _stats.parallelFrames++;
+  _stats.tiles = lastTile - firstTile + 1;
+}
+
+// Claim and render tiles until none are left
+void VibeLEDTileRenderer::_renderTiles(uint8_t worker) {
+  VibeLEDTilePool& pool = *_pool;
+  int32_t power = 0;
+
+  for (;;) {
+    uint32_t tile = pool.nextTile.fetch_add(1);
+    if (tile > pool.lastTile) break;
+
+    uint16_t first = max(tile * _tileSize, (uint32_t)pool.first);
+    uint16_t last = min(tile * _tileSize + _tileSize - 1, (uint32_t)pool.last);
+
+    if (pool.trackPower) {
+      uint32_t before = _leds._powerSum(first, last);
+      _leds._renderPixels(first, last);
+      power += (int32_t)(_leds._powerSum(first, last) - before);
+    } else {
+      _leds._renderPixels(first, last);
+    }
+  }
+
+  pool.power[worker] = power;
+}
+
+// Worker thread: render the tiles of every new frame
+void VibeLEDTileRenderer::_workerLoop(VibeLEDTileRenderer* renderer, uint8_t worker) {
+  VibeLEDTilePool& pool = *renderer->_pool;
+  uint32_t generation = 0;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(pool.mutex);
+      while (!pool.stop && pool.generation == generation) {
+        pool.start.wait(lock);
+      }
+      if (pool.stop) return;
+      generation = pool.generation;
+    }
+
+    renderer->_renderTiles(worker);
+
+    {
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      pool.pending--;
+      if (pool.pending == 0) {
+        pool.done.notify_one();
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*
+  VibeLEDTiles.h - Parallel tiled rendering for very large strips (Linux, macOS, Windows).
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDTiles_h
+#define VibeLEDTiles_h
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+// Needs an operating system with threads (single board computers, previews)
+#if defined(__linux__) || defined(__APPLE__) || defined(_WIN32)
+#define VIBELED_HAS_TILES 1
+
+// LEDs per tile: 3 KB of colors (9 KB with high precision) stays in L1 cache
+#ifndef VIBELED_TILE_SIZE
+#define VIBELED_TILE_SIZE 1024
+#endif
+
+// Tiled renderer statistics
+struct TileStats {
+  uint32_t parallelFrames;  // Frames rendered in tiles across the workers
+  uint32_t serialFrames;    // Frames of stateful effects rendered on one thread
+  uint16_t tiles;           // Tiles in the last parallel frame
+
+  TileStats() :
+    parallelFrames(0),
+    serialFrames(0),
+    tiles(0) {}
+};
+
+struct VibeLEDTilePool;
+
+// Renders per-pixel effects (static, blink, fades, chase, marquee, rainbow,
+// wave) by splitting the group into tiles that a pool of threads renders in
+// parallel. Every LED is computed exactly as in VibeLED::update(), so the
+// frames are identical for any number of threads. Effects that carry state
+// from LED to LED or frame to frame (fire, waterfall, sparkle, meteor, ...)
+// and custom effects are rendered on the calling thread as usual.
+//
+//   VibeLEDTileRenderer tiles(leds);   // All cores
+//   tiles.update();                    // Instead of leds.update()
+class VibeLEDTileRenderer {
+  public:
+    VibeLEDTileRenderer(VibeLED& leds, uint8_t threads = 0, uint16_t tileSize = VIBELED_TILE_SIZE);
+    ~VibeLEDTileRenderer();
+
+    // Same as VibeLED::update() and VibeLED::render()
+    void update();
+    void update(unsigned long now);
+    bool render(unsigned long now);
+
+    // State queries
+    uint8_t getThreads();
+    uint16_t getTileSize();
+    TileStats getStats();
+
+  private:
+    VibeLED& _leds;
+    uint8_t _threads;       // Including the calling thread
+    uint16_t _tileSize;
+    VibeLEDTilePool* _pool; // Worker threads (VibeLEDTiles.cpp)
+    TileStats _stats;
+
+    void _renderFrame();
+    void _renderTiles(uint8_t worker);
+
+    static void _workerLoop(VibeLEDTileRenderer* renderer, uint8_t worker);
+};
+
+#endif  // __linux__ || __APPLE__ || _WIN32
+
+#endif
@@ -0,0 +1,502 @@
+/*
+  VibeLEDVM.cpp - Bytecode interpreter for user-defined VibeLED effects.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "VibeLEDVM.h"
+
+// First quarter of a sine wave, 0-127 (index 64 = peak)
+static const uint8_t VM_SINE_TABLE[65] PROGMEM = {
+  0, 3, 6, 9, 12, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46,
+  49, 51, 54, 57, 60, 63, 65, 68, 71, 73, 76, 78, 81, 83, 85, 88,
+  90, 92, 94, 96, 98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116,
+  117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127,
+  127
+};
+
+// Constructor
+VibeLEDVM::VibeLEDVM(VibeLED& leds) : _leds(leds) {
+  _length = 0;
+  _error = VM_OK;
+
+  for (uint8_t i = 0; i < VIBELED_VM_VARS; i++) {
+    _vars[i] = 0;
+  }
+}
+
+// Load and verify a program; the running program is kept on failure
+VMError VibeLEDVM::load(const uint8_t* code, uint16_t length) {
+  if (!write(0, code, length)) {
+    _error = VM_ERR_LENGTH;
+    return _error;
+  }
+  return commit(length);
+}
+
+// Store part of a program being uploaded
+bool VibeLEDVM::write(uint16_t offset, const uint8_t* data, uint16_t length) {
+  if ((uint32_t)offset + length > VIBELED_VM_MAX_PROGRAM) return false;
+
+  memcpy(_staging + offset, data, length);
+  return true;
+}
+
+// Verify the uploaded program and switch to it
+VMError VibeLEDVM::commit(uint16_t length) {
+  uint16_t cost = 0;
+  _error = verify(_staging, length, &cost);
+  if (_error != VM_OK) return _error;
+
+  memcpy(_program, _staging, length);
+  _length = length;
+  for (uint8_t i = 0; i < VIBELED_VM_VARS; i++) {
+    _vars[i] = 0;
+  }
+
+  _stats.cost = cost;
+  _stats.frameOps = (uint32_t)cost * _leds.getNumLeds();
+  return VM_OK;
+}
+
+// Start the loaded program as the current effect
+void VibeLEDVM::start() {
+  if (_length > 0) {
+    _leds.setCustomEffect(this);
+  }
+}
+
+// Check a program without loading it. Jumps only go forward, so one pass in
+// program order sees every path into an instruction before the instruction.
+VMError VibeLEDVM::verify(const uint8_t* code, uint16_t length, uint16_t* cost) {
+  if (length == 0 || length > VIBELED_VM_MAX_PROGRAM) return VM_ERR_LENGTH;
+
+  int8_t depth[VIBELED_VM_MAX_PROGRAM];      // Stack depth on entry (-1 = not reached)
+  uint16_t longest[VIBELED_VM_MAX_PROGRAM];  // Instructions on the longest path here
+  for (uint16_t i = 0; i < length; i++) {
+    depth[i] = -1;
+    longest[i] = 0;
+  }
+  depth[0] = 0;
+
+  uint16_t worst = 0;
+  uint16_t pc = 0;
+
+  while (pc < length) {
+    uint8_t opcode = code[pc];
+    uint8_t size = _operandSize(opcode);
+    if (size == 0xFF) return VM_ERR_OPCODE;
+    if (pc + size >= length) return VM_ERR_LENGTH;
+
+    // No jump may land inside an operand
+    for (uint8_t k = 1; k <= size; k++) {
+      if (depth[pc + k] >= 0) return VM_ERR_JUMP;
+    }
+
+    uint16_t next = pc + 1 + size;
+    if (depth[pc] < 0) {
+      // Unreachable code is allowed but not counted
+      pc = next;
+      continue;
+    }
+
+    if ((opcode == OP_PARAM && code[pc + 1] >= PARAM_COUNT) ||
+        ((opcode == OP_LOAD || opcode == OP_STORE) && code[pc + 1] >= VIBELED_VM_VARS)) {
+      return VM_ERR_OPERAND;
+    }
+
+    uint8_t inputs;
+    int8_t effect = _stackEffect(opcode, inputs);
+    if (depth[pc] < inputs) return VM_ERR_STACK;
+    int8_t after = depth[pc] + effect;
+    if (after > VIBELED_VM_STACK) return VM_ERR_STACK;
+
+    uint16_t count = longest[pc] + 1;
+    if (count > worst) worst = count;
+
+    // Successors: the next instruction and/or the jump target
+    uint16_t targets[2];
+    uint8_t numTargets = 0;
+    if (opcode == OP_JMP || opcode == OP_JZ) {
+      targets[numTargets++] = next + code[pc + 1];
+    }
+    if (opcode != OP_END && opcode != OP_JMP) {
+      targets[numTargets++] = next;
+    }
+
+    for (uint8_t t = 0; t < numTargets; t++) {
+      uint16_t target = targets[t];
+      if (target > length) return VM_ERR_JUMP;
+      if (target == length) continue;  // Running off the end finishes the LED
+
+      if (depth[target] < 0) {
+        depth[target] = after;
+        longest[target] = count;
+      } else if (depth[target] != after) {
+        return VM_ERR_STACK;
+      } else if (count > longest[target]) {
+        longest[target] = count;
+      }
+    }
+
+    pc = next;
+  }
+
+  if ((uint32_t)worst * _leds.getNumLeds() > VIBELED_VM_MAX_FRAME_OPS) return VM_ERR_COST;
+
+  if (cost != nullptr) *cost = worst;
+  return VM_OK;
+}
+
+// True once a program has been loaded
+bool VibeLEDVM::isLoaded() {
+  return _length > 0;
+}
+
+// Result of the last load() or commit()
+VMError VibeLEDVM::getError() {
+  return _error;
+}
+
+// Get interpreter statistics
+VMStats VibeLEDVM::getStats() {
+  return _stats;
+}
+
+// Reset interpreter statistics (the program cost is kept)
+void VibeLEDVM::resetStats() {
+  _stats.frames = 0;
+  _stats.lastMicros = 0;
+  _stats.maxMicros = 0;
+}
+
+// Run the program once for every LED of the group
+void VibeLEDVM::render(VibeLED& leds, uint16_t first, uint16_t last, uint16_t step, unsigned long now) {
+  unsigned long start = micros();
+
+  EffectParams params = leds.getParams();
+  int32_t paramValues[PARAM_COUNT] = {
+    params.color1.r, params.color1.g, params.color1.b,
+    params.color2.r, params.color2.g, params.color2.b,
+    params.option1, params.option2, params.speed
+  };
+
+  bool rgb = (leds.getLEDType() == LED_TYPE_RGB);
+  int32_t count = last - first + 1;
+  int32_t time = now & 0x7FFFFFFF;
+
+  // The verifier guarantees the stack stays within bounds on every path
+  int32_t stack[VIBELED_VM_STACK];
+  const uint8_t* end = _program + _length;
+
+  for (uint16_t led = first; led <= last; led++) {
+    int32_t* sp = stack;
+    const uint8_t* pc = _program;
+
+    while (pc < end) {
+      switch (*pc++) {
+        case OP_END:
+          pc = end;
+          break;
+        case OP_PUSH8:
+          *sp++ = *pc++;
+          break;
+        case OP_PUSH16:
+          *sp++ = (int16_t)(pc[0] | (pc[1] << 8));
+          pc += 2;
+          break;
+        case OP_INDEX:
+          *sp++ = led - first;
+          break;
+        case OP_COUNT:
+          *sp++ = count;
+          break;
+        case OP_STEP:
+          *sp++ = step;
+          break;
+        case OP_TIME:
+          *sp++ = time;
+          break;
+        case OP_PARAM:
+          *sp++ = paramValues[*pc++];
+          break;
+        case OP_LOAD:
+          *sp++ = _vars[*pc++];
+          break;
+        case OP_STORE:
+          _vars[*pc++] = *--sp;
+          break;
+        case OP_DUP:
+          *sp = sp[-1];
+          sp++;
+          break;
+        case OP_DROP:
+          sp--;
+          break;
+        case OP_SWAP: {
+          int32_t a = sp[-2];
+          sp[-2] = sp[-1];
+          sp[-1] = a;
+          break;
+        }
+        case OP_OVER:
+          *sp = sp[-2];
+          sp++;
+          break;
+        // Arithmetic wraps around like unsigned math
+        case OP_ADD:
+          sp--;
+          sp[-1] = (uint32_t)sp[-1] + (uint32_t)*sp;
+          break;
+        case OP_SUB:
+          sp--;
+          sp[-1] = (uint32_t)sp[-1] - (uint32_t)*sp;
+          break;
+        case OP_MUL:
+          sp--;
+          sp[-1] = (uint32_t)sp[-1] * (uint32_t)*sp;
+          break;
+        case OP_DIV:
+          sp--;
+          if (*sp == -1) {
+            sp[-1] = 0 - (uint32_t)sp[-1];
+          } else {
+            sp[-1] = (*sp != 0) ? sp[-1] / *sp : 0;
+          }
+          break;
+        case OP_MOD:
+          sp--;
+          sp[-1] = (*sp != 0 && *sp != -1) ? sp[-1] % *sp : 0;
+          break;
+        case OP_AND:
+          sp--;
+          sp[-1] &= *sp;
+          break;
+        case OP_OR:
+          sp--;
+          sp[-1] |= *sp;
+          break;
+        case OP_XOR:
+          sp--;
+          sp[-1] ^= *sp;
+          break;
+        case OP_SHL:
+          sp--;
+          sp[-1] = (uint32_t)sp[-1] << (*sp & 31);
+          break;
+        case OP_SHR:
+          sp--;
+          sp[-1] >>= (*sp & 31);
+          break;
+        case OP_MIN:
+          sp--;
+          if (*sp < sp[-1]) sp[-1] = *sp;
+          break;
+        case OP_MAX:
+          sp--;
+          if (*sp > sp[-1]) sp[-1] = *sp;
+          break;
+        case OP_LT:
+          sp--;
+          sp[-1] = sp[-1] < *sp;
+          break;
+        case OP_GT:
+          sp--;
+          sp[-1] = sp[-1] > *sp;
+          break;
+        case OP_EQ:
+          sp--;
+          sp[-1] = sp[-1] == *sp;
+          break;
+        case OP_NOT:
+          sp[-1] = !sp[-1];
+          break;
+        case OP_JMP:
+          pc += *pc + 1;
+          break;
+        case OP_JZ: {
+          uint8_t offset = *pc++;
+          if (*--sp == 0) pc += offset;
+          break;
+        }
+        case OP_SIN8:
+          sp[-1] = _sin8(sp[-1]);
+          break;
+        case OP_RANDOM8:
+          *sp++ = random(256);
+          break;
+        case OP_SCALE8:
+          // Widened first: a * 255 overflows 32 bits for |a| >= 2^23
+          sp--;
+          sp[-1] = (int32_t)(((int64_t)sp[-1] * (*sp & 0xFF)) >> 8);
+          break;
+        case OP_HSV: {
+          // Saturation mixes towards white, value scales the result
+          Color color = VibeLED::hueToColor(sp[-3]);
+          uint16_t s = constrain(sp[-2], 0, 255);
+          uint16_t v = constrain(sp[-1], 0, 255) + 1;
+          sp[-3] = ((((color.r * (s + 1)) >> 8) + 255 - s) * v) >> 8;
+          sp[-2] = ((((color.g * (s + 1)) >> 8) + 255 - s) * v) >> 8;
+          sp[-1] = ((((color.b * (s + 1)) >> 8) + 255 - s) * v) >> 8;
+          break;
+        }
+        case OP_BLEND: {
+          uint8_t amount = constrain(sp[-1], 0, 255);
+          uint16_t weight = amount ? amount + 1 : 0;
+          sp -= 4;
+          for (uint8_t c = 0; c < 3; c++) {
+            int32_t a = constrain(sp[c - 3], 0, 255);
+            int32_t b = constrain(sp[c], 0, 255);
+            sp[c - 3] = (a * (256 - weight) + b * weight) >> 8;
+          }
+          break;
+        }
+        case OP_GET:
+          if (rgb) {
+            Color color = leds.getLEDColor(led);
+            sp[0] = color.r;
+            sp[1] = color.g;
+            sp[2] = color.b;
+          } else {
+            sp[0] = sp[1] = sp[2] = leds.getLEDState(led) ? 255 : 0;
+          }
+          sp += 3;
+          break;
+        case OP_OUT:
+          sp -= 3;
+          if (rgb) {
+            leds.setLED(led, Color(constrain(sp[0], 0, 255), constrain(sp[1], 0, 255), constrain(sp[2], 0, 255)));
+          } else {
+            leds.setLED(led, sp[0] > 127 || sp[1] > 127 || sp[2] > 127);
+          }
+          break;
+      }
+    }
+  }
+
+  _stats.frames++;
+  _stats.lastMicros = micros() - start;
+  if (_stats.lastMicros > _stats.maxMicros) {
+    _stats.maxMicros = _stats.lastMicros;
+  }
+}
+
+// Operand bytes following an opcode (0xFF = unknown opcode)
+uint8_t VibeLEDVM::_operandSize(uint8_t opcode) {
+  switch (opcode) {
+    case OP_PUSH8:
+    case OP_PARAM:
+    case OP_LOAD:
+    case OP_STORE:
+    case OP_JMP:
+    case OP_JZ:
+      return 1;
+    case OP_PUSH16:
+      return 2;
+    case OP_END:
+    case OP_INDEX:
+    case OP_COUNT:
+    case OP_STEP:
+    case OP_TIME:
+    case OP_DUP:
+    case OP_DROP:
+    case OP_SWAP:
+    case OP_OVER:
+    case OP_ADD:
+    case OP_SUB:
+    case OP_MUL:
+    case OP_DIV:
+    case OP_MOD:
+    case OP_AND:
+    case OP_OR:
+    case OP_XOR:
+    case OP_SHL:
+    case OP_SHR:
+    case OP_MIN:
+    case OP_MAX:
+    case OP_LT:
+    case OP_GT:
+    case OP_EQ:
+    case OP_NOT:
+    case OP_SIN8:
+    case OP_RANDOM8:
+    case OP_SCALE8:
+    case OP_HSV:
+    case OP_BLEND:
+    case OP_GET:
+    case OP_OUT:
+      return 0;
+    default:
+      return 0xFF;
+  }
+}
+
+// Values an opcode pops (inputs) and its net change to the stack depth
+int8_t VibeLEDVM::_stackEffect(uint8_t opcode, uint8_t& inputs) {
+  switch (opcode) {
+    case OP_PUSH8:
+    case OP_PUSH16:
+    case OP_INDEX:
+    case OP_COUNT:
+    case OP_STEP:
+    case OP_TIME:
+    case OP_PARAM:
+    case OP_LOAD:
+    case OP_RANDOM8:
+      inputs = 0;
+      return 1;
+    case OP_STORE:
+    case OP_DROP:
+    case OP_JZ:
+      inputs = 1;
+      return -1;
+    case OP_DUP:
+      inputs = 1;
+      return 1;
+    case OP_SWAP:
+      inputs = 2;
+      return 0;
+    case OP_OVER:
+      inputs = 2;
+      return 1;
+    case OP_NOT:
+    case OP_SIN8:
+      inputs = 1;
+      return 0;
+    case OP_HSV:
+      inputs = 3;
+      return 0;
+    case OP_BLEND:
+      inputs = 7;
+      return -4;
+    case OP_GET:
+      inputs = 0;
+      return 3;
+    case OP_OUT:
+      inputs = 3;
+      return -3;
+    case OP_END:
+    case OP_JMP:
+      inputs = 0;
+      return 0;
+    default:
+      // Binary operators
+      inputs = 2;
+      return -1;
+  }
+}
+
+// Sine of x (256 = full turn), 0-255
+uint8_t VibeLEDVM::_sin8(uint8_t x) {
+  uint8_t index = x & 63;
+  uint8_t value;
+
+  if (x & 64) {
+    value = pgm_read_byte(&VM_SINE_TABLE[64 - index]);
+  } else {
+    value = pgm_read_byte(&VM_SINE_TABLE[index]);
+  }
+
+  return (x & 128) ? 128 - value : 128 + value;
+}
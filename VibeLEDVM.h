@@ -0,0 +1,166 @@
+/*
+  VibeLEDVM.h - Bytecode interpreter for user-defined VibeLED effects.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#ifndef VibeLEDVM_h
+#define VibeLEDVM_h
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+// Largest program accepted (bytes)
+#ifndef VIBELED_VM_MAX_PROGRAM
+#define VIBELED_VM_MAX_PROGRAM 128
+#endif
+
+// Upper bound on instructions executed per frame (longest path * LEDs)
+#ifndef VIBELED_VM_MAX_FRAME_OPS
+#define VIBELED_VM_MAX_FRAME_OPS 32000
+#endif
+
+// Stack depth and number of variables (variables persist across frames)
+#define VIBELED_VM_STACK 16
+#define VIBELED_VM_VARS 8
+
+// Opcodes. The program runs once per LED of the group; values are 32-bit
+// signed. Jumps are forward only, so every run ends within the program length.
+// Stack effects are shown as (inputs -- outputs).
+enum VMOpcode {
+  OP_END = 0x00,       // ( -- ) finish this LED
+  OP_PUSH8 = 0x01,     // ( -- n ) 8-bit unsigned immediate
+  OP_PUSH16 = 0x02,    // ( -- n ) 16-bit signed immediate, little-endian
+  OP_INDEX = 0x03,     // ( -- i ) LED position within the group
+  OP_COUNT = 0x04,     // ( -- n ) number of LEDs in the group
+  OP_STEP = 0x05,      // ( -- step ) effect step
+  OP_TIME = 0x06,      // ( -- ms ) frame time in milliseconds (low 31 bits)
+  OP_PARAM = 0x07,     // ( -- v ) effect parameter, immediate VMParam
+  OP_LOAD = 0x08,      // ( -- v ) variable, immediate index
+  OP_STORE = 0x09,     // ( v -- ) variable, immediate index
+  OP_DUP = 0x0A,       // ( a -- a a )
+  OP_DROP = 0x0B,      // ( a -- )
+  OP_SWAP = 0x0C,      // ( a b -- b a )
+  OP_OVER = 0x0D,      // ( a b -- a b a )
+  OP_ADD = 0x10,       // ( a b -- a+b )
+  OP_SUB = 0x11,       // ( a b -- a-b )
+  OP_MUL = 0x12,       // ( a b -- a*b )
+  OP_DIV = 0x13,       // ( a b -- a/b ) 0 when b is 0
+  OP_MOD = 0x14,       // ( a b -- a%b ) 0 when b is 0
+  OP_AND = 0x15,       // ( a b -- a&b )
+  OP_OR = 0x16,        // ( a b -- a|b )
+  OP_XOR = 0x17,       // ( a b -- a^b )
+  OP_SHL = 0x18,       // ( a b -- a<<b ) b masked to 0-31
+  OP_SHR = 0x19,       // ( a b -- a>>b ) b masked to 0-31
+  OP_MIN = 0x1A,       // ( a b -- min )
+  OP_MAX = 0x1B,       // ( a b -- max )
+  OP_LT = 0x1C,        // ( a b -- a<b )
+  OP_GT = 0x1D,        // ( a b -- a>b )
+  OP_EQ = 0x1E,        // ( a b -- a==b )
+  OP_NOT = 0x1F,       // ( a -- !a )
+  OP_JMP = 0x20,       // ( -- ) skip forward by the 8-bit immediate
+  OP_JZ = 0x21,        // ( a -- ) skip forward by the 8-bit immediate if a is 0
+  OP_SIN8 = 0x30,      // ( x -- s ) sine of x (256 = full turn), 0-255
+  OP_RANDOM8 = 0x31,   // ( -- r ) random 0-255
+  OP_SCALE8 = 0x32,    // ( a b -- a*b/256 )
+  OP_HSV = 0x33,       // ( h s v -- r g b )
+  OP_BLEND = 0x34,     // ( r1 g1 b1 r2 g2 b2 amount -- r g b ) amount 0-255 towards the second color
+  OP_GET = 0x35,       // ( -- r g b ) current color of this LED
+  OP_OUT = 0x36        // ( r g b -- ) write this LED (single color: on if any channel > 127)
+};
+
+// Effect parameters readable with OP_PARAM
+enum VMParam {
+  PARAM_COLOR1_R = 0,
+  PARAM_COLOR1_G = 1,
+  PARAM_COLOR1_B = 2,
+  PARAM_COLOR2_R = 3,
+  PARAM_COLOR2_G = 4,
+  PARAM_COLOR2_B = 5,
+  PARAM_OPTION1 = 6,
+  PARAM_OPTION2 = 7,
+  PARAM_SPEED = 8,
+  PARAM_COUNT = 9
+};
+
+// Verifier results
+enum VMError {
+  VM_OK = 0,
+  VM_ERR_LENGTH = 1,    // Empty, too long, or an operand runs past the end
+  VM_ERR_OPCODE = 2,    // Unknown opcode
+  VM_ERR_OPERAND = 3,   // Variable or parameter index out of range
+  VM_ERR_JUMP = 4,      // Jump not forward onto an instruction boundary
+  VM_ERR_STACK = 5,     // Stack underflow, overflow or mismatch where paths join
+  VM_ERR_COST = 6       // Worst case exceeds VIBELED_VM_MAX_FRAME_OPS for this strip
+};
+
+// Interpreter statistics
+struct VMStats {
+  uint32_t frames;      // Frames rendered
+  uint16_t cost;        // Longest path through the program (instructions per LED)
+  uint32_t frameOps;    // Worst case instructions per frame (cost * LEDs)
+  uint32_t lastMicros;  // Time spent rendering the last frame
+  uint32_t maxMicros;   // Worst frame time since resetStats()
+
+  VMStats() :
+    frames(0),
+    cost(0),
+    frameOps(0),
+    lastMicros(0),
+    maxMicros(0) {}
+};
+
+// Runs verified bytecode as an EFFECT_CUSTOM effect. Programs are checked
+// once when loaded: every operand is in range, jumps only go forward, the
+// stack depth is known at every instruction, and the worst case per frame
+// is bounded, so the interpreter itself needs no run-time checks.
+//
+// Programs are written with extras/vmasm/vmasm.py and loaded directly or
+// uploaded with the control protocol (CMD_VM_WRITE / CMD_VM_COMMIT).
+class VibeLEDVM : public VibeLEDEffect {
+  public:
+    VibeLEDVM(VibeLED& leds);
+
+    // Load and verify a program; the running program is kept on failure
+    VMError load(const uint8_t* code, uint16_t length);
+
+    // Upload in pieces, then verify and switch to it
+    bool write(uint16_t offset, const uint8_t* data, uint16_t length);
+    VMError commit(uint16_t length);
+
+    // Start the loaded program as the current effect
+    void start();
+
+    // Check a program without loading it
+    VMError verify(const uint8_t* code, uint16_t length, uint16_t* cost = nullptr);
+
+    // State queries
+    bool isLoaded();
+    VMError getError();
+
+    // Statistics
+    VMStats getStats();
+    void resetStats();
+
+    // VibeLEDEffect
+    void render(VibeLED& leds, uint16_t first, uint16_t last, uint16_t step, unsigned long now);
+
+  private:
+    VibeLED& _leds;
+
+    uint8_t _program[VIBELED_VM_MAX_PROGRAM];
+    uint8_t _staging[VIBELED_VM_MAX_PROGRAM];
+    uint16_t _length;
+    VMError _error;
+
+    int32_t _vars[VIBELED_VM_VARS];
+
+    VMStats _stats;
+
+    static uint8_t _operandSize(uint8_t opcode);
+    static int8_t _stackEffect(uint8_t opcode, uint8_t& inputs);
+    static uint8_t _sin8(uint8_t x);
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*
+  AudioReactive.ino - Audio-reactive effects example for the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include <VibeLED.h>
+#include <VibeLEDAudio.h>
+
+// Define the number of LEDs
+#define NUM_LEDS 10
+
+// Microphone module (biased to half the supply) on A0
+#define MIC_PIN A0
+#define SAMPLE_RATE 4000
+#define BLOCK_SIZE 64
+
+// RGB LEDs with R, G, B on pins 9, 10, 11
+VibeLED leds(9, 10, 11, NUM_LEDS);
+
+// Band analyzer
+VibeLEDAudio audio(SAMPLE_RATE);
+
+int16_t samples[BLOCK_SIZE];
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("VibeLED Audio Reactive Example"));
+
+  // Initialize the library
+  leds.begin();
+  leds.setEffect(EFFECT_WAVE, 30);
+
+  // Bass, mids and highs
+  audio.addBand(100);
+  audio.addBand(600);
+  audio.addBand(1500);
+  audio.setBeatBand(0);
+
+  // Flash brighter on every beat, let the mids pick the color and
+  // the overall level drive the speed (louder = faster)
+  audio.bind(AUDIO_SOURCE_BEAT, MOD_BRIGHTNESS, 60, 255);
+  audio.bind(1, MOD_HUE, 0, 255);
+  audio.bind(AUDIO_SOURCE_LEVEL, MOD_SPEED, 60, 10);
+}
+
+void loop() {
+  // Capture one block at roughly SAMPLE_RATE
+  for (uint8_t i = 0; i < BLOCK_SIZE; i++) {
+    samples[i] = (analogRead(MIC_PIN) - 512) << 4;
+    delayMicroseconds(1000000UL / SAMPLE_RATE - 110);  // analogRead takes ~110 us on AVR
+  }
+
+  // Analyze it and push the modulation into the effect
+  audio.process(samples, BLOCK_SIZE);
+  audio.apply(leds);
+
+  // Update the effect animation
+  leds.update();
+
+  if (audio.isBeat()) {
+    Serial.print(F("beat, analysis us: "));
+    Serial.println(audio.getStats().lastMicros);
+  }
+}
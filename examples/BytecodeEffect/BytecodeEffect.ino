@@ -0,0 +1,72 @@
+/*
+  BytecodeEffect.ino - Bytecode effect example for the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include <VibeLED.h>
+#include <VibeLEDVM.h>
+#include <VibeLEDProtocol.h>
+
+// Define the number of LEDs
+#define NUM_LEDS 60
+
+// RGB LEDs with R, G, B on pins 9, 10, 11
+VibeLED leds(9, 10, 11, NUM_LEDS);
+
+// Interpreter for uploaded effects
+VibeLEDVM vm(leds);
+
+// Control link; new effects can be uploaded while the sketch runs:
+//   python3 vmasm.py wave.vmasm -f frames -o wave.bin
+//   then send wave.bin to the serial port
+VibeLEDProtocol protocol(leds);
+
+// Built-in program: sine wave of the primary color
+// (vmasm.py examples/wave.vmasm -n waveProgram)
+const uint8_t waveProgram[28] = {
+  0x05, 0x01, 0x04, 0x12, 0x03, 0x01, 0x14, 0x12, 0x10, 0x30, 0x09, 0x00,
+  0x07, 0x00, 0x08, 0x00, 0x32, 0x07, 0x01, 0x08, 0x00, 0x32, 0x07, 0x02,
+  0x08, 0x00, 0x32, 0x36
+};
+
+// Variables for statistics reporting
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(115200);
+
+  // Initialize the library
+  leds.begin();
+  leds.setColor(0, 128, 255);
+  leds.setDelay(20);
+
+  // Verify and run the built-in program
+  if (vm.load(waveProgram, sizeof(waveProgram)) == VM_OK) {
+    vm.start();
+  } else {
+    Serial.print("Program rejected, error ");
+    Serial.println(vm.getError());
+  }
+
+  // Accept CMD_VM_WRITE / CMD_VM_COMMIT uploads
+  protocol.setVM(&vm);
+}
+
+void loop() {
+  protocol.poll(Serial);
+  leds.update();
+
+  // Report the interpreter cost every 5 seconds
+  if (millis() - lastReport >= 5000) {
+    lastReport = millis();
+    VMStats stats = vm.getStats();
+
+    Serial.print("Instructions per LED (max): ");
+    Serial.print(stats.cost);
+    Serial.print(", frame time: ");
+    Serial.print(stats.lastMicros);
+    Serial.println(" us");
+  }
+}
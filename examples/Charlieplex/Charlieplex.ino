@@ -0,0 +1,61 @@
+/*
+  Charlieplex.ino - Charlieplexed LED example for the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include <VibeLED.h>
+#include <VibeLEDMatrixOutput.h>
+
+// 5 pins drive 5 * 4 = 20 LEDs
+#define NUM_PINS 5
+#define NUM_LEDS 20
+
+const uint8_t pins[NUM_PINS] = { 2, 3, 4, 5, 6 };
+
+// For a row/column matrix use instead:
+// const uint8_t rowPins[4] = { 2, 3, 4, 5 };
+// const uint8_t colPins[5] = { 6, 7, 8, 9, 10 };
+// VibeLEDMatrixOutput matrix(rowPins, 4, colPins, 5);
+
+// Single color LEDs; the pin argument is unused when an output driver is attached
+VibeLED leds(pins[0], NUM_LEDS);
+VibeLEDMatrixOutput matrix(pins, NUM_PINS);
+
+// Variables for statistics reporting
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("VibeLED Charlieplex Example"));
+
+  // Attach the driver before begin() so it can set up its pins
+  leds.setOutput(&matrix);
+  leds.begin();
+
+  matrix.setScanRate(120);   // Full scans per second
+  matrix.setDutyCycle(90);   // Leave 10% of each slot dark to avoid ghosting
+  leds.setEffect(EFFECT_SNAKE, 80);
+}
+
+void loop() {
+  // Update the effect animation (non-blocking)
+  leds.update();
+
+  // Light the next scan slot when it is due; call this as often as possible
+  matrix.refresh();
+
+  // Report the measured scan rate and duty cycle every 5 seconds
+  if (millis() - lastReport > 5000) {
+    lastReport = millis();
+    MatrixOutputStats stats = matrix.getStats();
+    Serial.print(F("scan_hz="));
+    Serial.print(stats.scanRate);
+    Serial.print(F(" slots="));
+    Serial.print(stats.slots);
+    Serial.print(F(" led_duty_permille="));
+    Serial.println(stats.ledDuty);
+    matrix.resetStats();
+  }
+}
@@ -0,0 +1,49 @@
+/*
+  HighPrecisionFade.ino - 16-bit fades with temporal dithering for the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include <VibeLED.h>
+
+// Define the number of LEDs
+#define NUM_LEDS 10
+
+// RGB LEDs with R, G, B on pins 9, 10, 11
+VibeLED leds(9, 10, 11, NUM_LEDS);
+
+// Measure the average cost of one frame (render + output) in microseconds
+unsigned long measureFrame(uint16_t frames) {
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < frames; i++) {
+    leds.refresh();
+  }
+  return (micros() - start) / frames;
+}
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("VibeLED High Precision Fade Example"));
+
+  // Initialize the library
+  leds.begin();
+  leds.setBrightness(16);  // Low brightness is where 8-bit fades step visibly
+  leds.setEffect(EFFECT_BREATHE, 10, Color(255, 120, 40));
+
+  // Benchmark the extra per-frame cost of the 16-bit pipeline
+  unsigned long standard = measureFrame(200);
+  leds.setHighPrecision(true);
+  unsigned long precise = measureFrame(200);
+
+  Serial.print(F("8-bit frame us: "));
+  Serial.println(standard);
+  Serial.print(F("16-bit + dither frame us: "));
+  Serial.println(precise);
+}
+
+void loop() {
+  // Update the effect animation (non-blocking); a short delay keeps the
+  // dithering fast enough to be invisible
+  leds.update();
+}
@@ -0,0 +1,91 @@
+/*
+  PipelinedOutput.ino - Rendering and output on separate cores with the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  One core renders the next frame while the other pushes the previous one
+  to the LEDs. Runs on dual-core boards: ESP32 (FreeRTOS task pinned to
+  core 0) and RP2040 (setup1()/loop1() on core 1).
+*/
+
+#include <VibeLED.h>
+#include <VibeLEDPipeline.h>
+
+// Define the number of LEDs
+#define NUM_LEDS 60
+
+// Number of frame buffers (2 is enough when both sides keep up; 3 absorbs jitter)
+#define FRAME_BUFFERS 3
+
+// Sends finished frames to the LEDs. Replace the body with your strip
+// driver (e.g. copy into a NeoPixel buffer and call show()).
+class PwmSink : public VibeLEDFrameSink {
+  public:
+    void write(const uint8_t* frame, uint16_t numLeds) {
+      // The first LED on pins 9, 10, 11 as an example
+      analogWrite(9, frame[0]);
+      analogWrite(10, frame[1]);
+      analogWrite(11, frame[2]);
+    }
+};
+
+// The pins are not driven by VibeLED in pipelined mode; the sink writes the output
+VibeLED leds(9, 10, 11, NUM_LEDS);
+
+VibeLEDFrameQueue queue(NUM_LEDS, FRAME_BUFFERS);
+PwmSink sink;
+VibeLEDPipeline pipeline(leds, queue, sink);
+
+#if defined(ESP32)
+// Output side on core 0 (the Arduino loop runs on core 1)
+void outputTask(void* parameter) {
+  for (;;) {
+    if (!pipeline.present()) vTaskDelay(1);
+  }
+}
+#endif
+
+void setup() {
+  Serial.begin(115200);
+
+  pinMode(9, OUTPUT);
+  pinMode(10, OUTPUT);
+  pinMode(11, OUTPUT);
+
+  // Initialize the library
+  leds.begin();
+  leds.setEffect(EFFECT_FIRE, 20);
+
+#if defined(ESP32)
+  xTaskCreatePinnedToCore(outputTask, "output", 4096, NULL, 1, NULL, 0);
+#endif
+}
+
+void loop() {
+  // Render side: replaces leds.update()
+  pipeline.render();
+
+  // Print queue statistics every 5 seconds
+  static unsigned long lastReport = 0;
+  if (millis() - lastReport >= 5000) {
+    lastReport = millis();
+    FrameQueueStats stats = queue.getStats();
+    Serial.print("Frames: ");
+    Serial.print(stats.popped);
+    Serial.print("  Render waits: ");
+    Serial.print(stats.full);
+    Serial.print("  Max depth: ");
+    Serial.println(stats.maxDepth);
+  }
+}
+
+#if defined(ARDUINO_ARCH_RP2040)
+// Output side on core 1
+void setup1() {
+}
+
+void loop1() {
+  pipeline.present();
+}
+#endif
@@ -0,0 +1,67 @@
+/*
+  Sequencer.ino - Timeline sequencer example for the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include <VibeLED.h>
+#include <VibeLEDSequencer.h>
+
+// Define the number of LEDs
+#define NUM_LEDS 100
+
+// RGB LEDs with R, G, B on pins 9, 10, 11
+VibeLED leds(9, 10, 11, NUM_LEDS);
+
+// Plays the cue list below
+VibeLEDSequencer sequencer(leds);
+
+// The show lives in flash:
+//   effect, speed, brightness, color1, color2, color3, option1, option2,
+//   first, last LED, duration (ms), transition, fade (ms), loopTo, loopCount
+const Cue show[] PROGMEM = {
+  // Red breathe for 10 seconds
+  { EFFECT_BREATHE, 20, 255, {255, 0, 0}, {0, 0, 0}, {0, 0, 0}, 0, 0, 0, CUE_ALL_LEDS, 10000, CUE_CUT, 0, CUE_NO_LOOP, 0 },
+
+  // Fade into a rainbow for 30 seconds
+  { EFFECT_RAINBOW, 30, 255, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, 0, 0, 0, CUE_ALL_LEDS, 30000, CUE_FADE, 1000, CUE_NO_LOOP, 0 },
+
+  // Blue chase on LEDs 0-49 with the rest off, then back to the rainbow twice
+  { EFFECT_CHASE, 50, 255, {0, 0, 255}, {0, 0, 0}, {0, 0, 0}, 0, 0, 0, 49, 20000, CUE_FADE | CUE_CLEAR, 1000, 1, 2 },
+
+  // Finish on a static white that holds until stop()
+  { EFFECT_STATIC, 100, 128, {255, 255, 255}, {0, 0, 0}, {0, 0, 0}, 0, 0, 0, CUE_ALL_LEDS, 0, CUE_FADE, 2000, CUE_NO_LOOP, 0 }
+};
+
+// Variables for statistics reporting
+uint8_t lastCue = 0xFF;
+
+void setup() {
+  Serial.begin(115200);
+
+  // Initialize the library
+  leds.begin();
+
+  // Start the show now
+  sequencer.play(show, sizeof(show) / sizeof(show[0]));
+}
+
+void loop() {
+  // Replaces leds.update(): switches cues on time and renders the effect
+  sequencer.update();
+
+  // Report how accurately each cue started
+  if (sequencer.getCue() != lastCue) {
+    lastCue = sequencer.getCue();
+    SequencerStats stats = sequencer.getStats();
+
+    Serial.print("Cue ");
+    Serial.print(lastCue);
+    Serial.print(" started ");
+    Serial.print(stats.lastError);
+    Serial.print(" ms late, switch took ");
+    Serial.print(stats.switchMicros);
+    Serial.println(" us (worst)");
+  }
+}
@@ -0,0 +1,58 @@
+/*
+  SerialControl.ino - Binary serial control example for the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include <VibeLED.h>
+#include <VibeLEDProtocol.h>
+
+// Define the number of LEDs
+#define NUM_LEDS 10
+
+// RGB LEDs with R, G, B on pins 9, 10, 11
+VibeLED leds(9, 10, 11, NUM_LEDS);
+
+// Decoder that applies received commands to the LEDs
+VibeLEDProtocol protocol(leds);
+
+// Variables for statistics reporting
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(115200);
+
+  // Initialize the library
+  leds.begin();
+  leds.setEffect(EFFECT_RAINBOW, 50);
+
+  // Example frame: switch to a red breathe effect at 80 ms per step
+  // A5 03 01 03 50 00 <crc>  (SET_EFFECT, EFFECT_BREATHE, speed 80)
+  uint8_t payload[3] = { EFFECT_BREATHE, 80, 0 };
+  uint8_t frame[3 + 4];
+  uint16_t length = VibeLEDProtocol::encode(CMD_SET_EFFECT, payload, 3, frame);
+  protocol.feed(frame, length);
+}
+
+void loop() {
+  // Decode and apply any commands waiting on the serial port
+  protocol.poll(Serial);
+
+  // Update the effect animation (non-blocking)
+  leds.update();
+
+  // Report decoder statistics every 10 seconds
+  if (millis() - lastReport > 10000) {
+    lastReport = millis();
+    ProtocolStats stats = protocol.getStats();
+    Serial.print(F("frames="));
+    Serial.print(stats.frames);
+    Serial.print(F(" crc_errors="));
+    Serial.print(stats.crcErrors);
+    Serial.print(F(" latency_us="));
+    Serial.print(stats.lastLatency);
+    Serial.print(F(" max_latency_us="));
+    Serial.println(stats.maxLatency);
+  }
+}
@@ -0,0 +1,58 @@
+/*
+  ShiftRegister.ino - 74HC595 shift register example for the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include <VibeLED.h>
+#include <VibeLEDShiftOutput.h>
+
+// Define the number of LEDs (8 per 74HC595)
+#define NUM_LEDS 32
+
+// Shift register pins
+#define DATA_PIN 11
+#define CLOCK_PIN 13
+#define LATCH_PIN 10
+
+// Single color LEDs; the pin argument is unused when an output driver is attached
+VibeLED leds(DATA_PIN, NUM_LEDS);
+
+// 4 bits of binary code modulation = 16 brightness levels per LED
+VibeLEDShiftOutput shiftOutput(DATA_PIN, CLOCK_PIN, LATCH_PIN, 4);
+
+// Variables for statistics reporting
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("VibeLED Shift Register Example"));
+
+  // Attach the driver before begin() so it can set up its pins
+  leds.setOutput(&shiftOutput);
+  leds.begin();
+
+  shiftOutput.setRefreshRate(200);  // 200 Hz, well above visible flicker
+  leds.setBrightness(64);           // Dimmed through modulation
+  leds.setEffect(EFFECT_KNIGHT_RIDER, 60);
+}
+
+void loop() {
+  // Update the effect animation (non-blocking)
+  leds.update();
+
+  // Keep the modulation running; call this as often as possible
+  shiftOutput.refresh();
+
+  // Report the measured refresh rate and CPU load every 5 seconds
+  if (millis() - lastReport > 5000) {
+    lastReport = millis();
+    ShiftOutputStats stats = shiftOutput.getStats();
+    Serial.print(F("refresh_hz="));
+    Serial.print(stats.refreshRate);
+    Serial.print(F(" cpu_permille="));
+    Serial.println(stats.cpuLoad);
+    shiftOutput.resetStats();
+  }
+}
@@ -0,0 +1,62 @@
+/*
+  SyncedPlayback.ino - Synchronized playback across controllers with the VibeLED library
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include <VibeLED.h>
+#include <VibeLEDSync.h>
+
+// Define the number of LEDs
+#define NUM_LEDS 10
+
+// Set to true on exactly one controller
+#define IS_MASTER false
+
+// Sync messages over a shared serial bus (e.g. RS-485)
+class SerialTransport : public VibeLEDSyncTransport {
+  public:
+    void send(const uint8_t* data, uint8_t length) {
+      Serial.write(data, length);
+    }
+
+    uint8_t receive(uint8_t* data, uint8_t maxLength) {
+      // Resynchronize on the 'V' 'S' header
+      while (Serial.available() && Serial.peek() != 'V') Serial.read();
+      if (Serial.available() < VIBELED_SYNC_MESSAGE_SIZE || maxLength < VIBELED_SYNC_MESSAGE_SIZE) {
+        return 0;
+      }
+      return Serial.readBytes(data, VIBELED_SYNC_MESSAGE_SIZE);
+    }
+};
+
+// RGB LEDs with R, G, B on pins 9, 10, 11
+VibeLED leds(9, 10, 11, NUM_LEDS);
+
+SerialTransport transport;
+VibeLEDSync sync(transport, IS_MASTER);
+
+void setup() {
+  Serial.begin(115200);
+
+  // Initialize the library
+  leds.begin();
+  leds.setEffect(EFFECT_SPARKLE, 40, Color(255, 160, 40));
+
+  // Derive the effect step from shared time; the same seed on every
+  // controller makes random effects identical too
+  leds.setTimebase(0, 1234);
+
+  // The master sends its time every 500 ms
+  sync.setInterval(500);
+}
+
+void loop() {
+  sync.update();
+
+  // Followers render once they have heard from the master
+  if (sync.isLocked()) {
+    leds.update(sync.now());
+  }
+}
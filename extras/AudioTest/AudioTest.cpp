@@ -0,0 +1,378 @@
+/*
+  AudioTest.cpp - Checks VibeLEDAudio against known signals read from WAV files.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Writes three test recordings as 16-bit mono WAV files (a tone at every
+  band frequency, a logarithmic sweep and a drum loop), reads them back
+  and feeds them to VibeLEDAudio in blocks, as a sketch would feed ADC
+  samples. Checks:
+
+  - every band magnitude of every block against a double precision
+    Goertzel filter over the same samples,
+  - tones: the band at the tone frequency reads a quarter of the amplitude,
+  - sweep: each band peaks when the sweep passes its frequency,
+  - drums: one beat per kick drum, within two blocks of the kick,
+  - beat hold: with short blocks at 44.1 kHz, beats are held off for the
+    hold time and not longer (no per-block rounding of the elapsed time),
+  - addBand() rejects 0 Hz, half the sample rate and above.
+
+  With a WAV file as the argument, prints the band magnitudes and beat
+  times of that file instead.
+
+  Usage: AudioTest [dir]
+         AudioTest file.wav
+*/
+
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "VibeLEDAudio.h"
+
+const uint16_t sampleRate = 8000;
+const uint16_t blockSize = 256;
+const uint16_t bands[] = { 63, 160, 400, 1000, 2500 };
+const uint8_t numBands = sizeof(bands) / sizeof(bands[0]);
+
+struct Wav {
+  uint32_t sampleRate;
+  std::vector<int16_t> samples;  // Mono (channels are averaged)
+};
+
+// Samples of one test signal, 16-bit mono
+typedef std::vector<int16_t> Signal;
+
+static void write16(FILE* file, uint16_t value) {
+  fputc(value & 0xFF, file);
+  fputc(value >> 8, file);
+}
+
+static void write32(FILE* file, uint32_t value) {
+  write16(file, value & 0xFFFF);
+  write16(file, value >> 16);
+}
+
+static uint32_t read32(const uint8_t* data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static bool writeWav(const std::string& path, const Signal& signal) {
+  FILE* file = fopen(path.c_str(), "wb");
+  if (file == nullptr) return false;
+
+  uint32_t bytes = signal.size() * 2;
+  fwrite("RIFF", 1, 4, file);
+  write32(file, 36 + bytes);
+  fwrite("WAVEfmt ", 1, 8, file);
+  write32(file, 16);
+  write16(file, 1);              // PCM
+  write16(file, 1);              // Mono
+  write32(file, sampleRate);
+  write32(file, sampleRate * 2);
+  write16(file, 2);
+  write16(file, 16);
+  fwrite("data", 1, 4, file);
+  write32(file, bytes);
+  for (int16_t sample : signal) write16(file, (uint16_t)sample);
+  fclose(file);
+  return true;
+}
+
+// Read 8- or 16-bit PCM; returns false for anything else
+static bool readWav(const std::string& path, Wav& wav) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) return false;
+  std::vector<uint8_t> data;
+  uint8_t buffer[4096];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + length);
+  }
+  fclose(file);
+
+  if (data.size() < 12 || memcmp(&data[0], "RIFF", 4) != 0 || memcmp(&data[8], "WAVE", 4) != 0) {
+    return false;
+  }
+
+  uint16_t channels = 0;
+  uint16_t bits = 0;
+  for (size_t chunk = 12; chunk + 8 <= data.size();) {
+    uint32_t size = read32(&data[chunk + 4]);
+    const uint8_t* body = &data[chunk + 8];
+    if (chunk + 8 + size > data.size()) size = data.size() - chunk - 8;
+
+    if (memcmp(&data[chunk], "fmt ", 4) == 0 && size >= 16) {
+      if ((body[0] | (body[1] << 8)) != 1) return false;
+      channels = body[2] | (body[3] << 8);
+      wav.sampleRate = read32(body + 4);
+      bits = body[14] | (body[15] << 8);
+    } else if (memcmp(&data[chunk], "data", 4) == 0 && channels > 0) {
+      uint8_t width = bits / 8;
+      if ((bits != 8 && bits != 16) || width == 0) return false;
+      for (uint32_t i = 0; i + width * channels <= size; i += width * channels) {
+        int32_t sum = 0;
+        for (uint16_t c = 0; c < channels; c++) {
+          const uint8_t* sample = body + i + c * width;
+          sum += (bits == 8) ? (sample[0] - 128) << 8 : (int16_t)(sample[0] | (sample[1] << 8));
+        }
+        wav.samples.push_back(sum / channels);
+      }
+      return true;
+    }
+    chunk += 8 + size + (size & 1);
+  }
+  return false;
+}
+
+// Test signals
+static Signal tones(int16_t amplitude, uint32_t samplesPerTone) {
+  Signal signal;
+  for (uint16_t frequency : bands) {
+    for (uint32_t n = 0; n < samplesPerTone; n++) {
+      signal.push_back(lround(amplitude * sin(2.0 * PI * frequency * n / sampleRate)));
+    }
+  }
+  return signal;
+}
+
+// Logarithmic sweep from f0 to f1 Hz; the frequency at t is f0 * (f1 / f0)^(t / seconds)
+static Signal sweep(double f0, double f1, double seconds, int16_t amplitude) {
+  Signal signal;
+  double k = log(f1 / f0) / seconds;
+  for (uint32_t n = 0; n < seconds * sampleRate; n++) {
+    double t = (double)n / sampleRate;
+    signal.push_back(lround(amplitude * sin(2.0 * PI * f0 * (exp(k * t) - 1) / k)));
+  }
+  return signal;
+}
+
+// Kick drums with falling pitch, off-beat hi-hats and a quiet bass line
+static Signal drums(double bpm, uint8_t kicks, std::vector<double>& kickTimes) {
+  Signal signal;
+  double interval = 60.0 / bpm;
+  double first = 0.25;
+  uint32_t length = (first + interval * kicks) * sampleRate;
+  uint32_t noise = 12345;
+  double phase = 0;
+
+  for (uint8_t i = 0; i < kicks; i++) kickTimes.push_back(first + i * interval);
+
+  for (uint32_t n = 0; n < length; n++) {
+    double t = (double)n / sampleRate;
+    double value = 0;
+
+    double beat = (t - first) / interval;
+    if (beat >= 0) {
+      value = 1500 * sin(2.0 * PI * 110 * t);
+
+      double since = (beat - floor(beat)) * interval;
+      double frequency = 50 + 100 * exp(-since / 0.03);
+      phase += 2.0 * PI * frequency / sampleRate;
+      value += 12000 * exp(-since / 0.08) * sin(phase);
+
+      double offBeat = since - interval / 2;
+      if (offBeat >= 0) {
+        noise ^= noise << 13;
+        noise ^= noise >> 17;
+        noise ^= noise << 5;
+        value += 4000 * exp(-offBeat / 0.02) * ((int32_t)(noise & 0xFFFF) - 32768) / 32768.0;
+      }
+    }
+    signal.push_back(constrain(lround(value), -32767, 32767));
+  }
+  return signal;
+}
+
+// Double precision reference of process(): the magnitude of one band over
+// one block, with the same Q14 coefficient
+static double reference(const int16_t* samples, uint16_t count, uint16_t frequency) {
+  double coeff = (int16_t)(2.0 * cos(2.0 * PI * frequency / sampleRate) * 16384.0) / 16384.0;
+  double s1 = 0;
+  double s2 = 0;
+  for (uint16_t n = 0; n < count; n++) {
+    double s0 = (samples[n] >> 2) + coeff * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+  double power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+  return sqrt(power > 0 ? power : 0) * 2 / count;
+}
+
+// Feed a signal in blocks; records magnitudes per block and beat times
+struct Analysis {
+  std::vector<std::vector<uint16_t>> magnitudes;
+  std::vector<double> beats;      // End of the block that reported the beat (s)
+  double worstError;              // Largest difference to the reference (1 = tolerance)
+};
+
+static Analysis analyze(const Signal& signal, uint32_t rate) {
+  VibeLEDAudio audio(rate);
+  for (uint16_t frequency : bands) audio.addBand(frequency);
+
+  Analysis analysis;
+  analysis.worstError = 0;
+  for (uint32_t start = 0; start + blockSize <= signal.size(); start += blockSize) {
+    audio.process(&signal[start], blockSize);
+
+    std::vector<uint16_t> block;
+    for (uint8_t b = 0; b < numBands; b++) {
+      uint16_t magnitude = audio.getMagnitude(b);
+      double expected = reference(&signal[start], blockSize, bands[b]);
+      // The fixed-point state is cut to 15 bits before the power, so allow
+      // a relative error on top of rounding
+      double error = fabs(magnitude - expected) / (expected * 0.02 + 4);
+      if (error > analysis.worstError) analysis.worstError = error;
+      block.push_back(magnitude);
+    }
+    analysis.magnitudes.push_back(block);
+    if (audio.isBeat()) analysis.beats.push_back((double)(start + blockSize) / rate);
+  }
+  return analysis;
+}
+
+static int check(const char* name, bool ok) {
+  printf("%-42s %s\n", name, ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
+
+// Print the analysis of any WAV file
+static int show(const std::string& path) {
+  Wav wav;
+  if (!readWav(path, wav)) {
+    printf("%s: not an 8- or 16-bit PCM WAV file\n", path.c_str());
+    return 1;
+  }
+  Analysis analysis = analyze(wav.samples, wav.sampleRate);
+
+  printf("%u Hz, %u samples, blocks of %u\n\n%8s", wav.sampleRate, (unsigned)wav.samples.size(),
+         blockSize, "time s");
+  for (uint16_t frequency : bands) printf(" %7u Hz", frequency);
+  printf("  beat\n");
+  for (size_t i = 0; i < analysis.magnitudes.size(); i++) {
+    double end = (double)(i + 1) * blockSize / wav.sampleRate;
+    printf("%8.3f", end);
+    for (uint16_t magnitude : analysis.magnitudes[i]) printf(" %10u", magnitude);
+    bool beat = false;
+    for (double time : analysis.beats) beat = beat || fabs(time - end) < 1e-9;
+    printf("  %s\n", beat ? "*" : "");
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  std::string dir = (argc > 1) ? argv[1] : ".";
+  if (dir.size() > 4 && dir.compare(dir.size() - 4, 4, ".wav") == 0) return show(dir);
+  int failures = 0;
+
+  // Write the recordings, then read them back as a user's files would be
+  const int16_t amplitude = 8000;
+  const uint32_t toneLength = blockSize * 16;
+  std::vector<double> kickTimes;
+  const char* names[] = { "tones.wav", "sweep.wav", "drums.wav" };
+  Signal written[] = { tones(amplitude, toneLength), sweep(40, 3500, 8, amplitude),
+                       drums(120, 16, kickTimes) };
+  Signal signals[3];
+  for (int i = 0; i < 3; i++) {
+    std::string path = dir + "/" + names[i];
+    Wav wav;
+    bool ok = writeWav(path, written[i]) && readWav(path, wav) && wav.sampleRate == sampleRate &&
+              wav.samples == written[i];
+    signals[i] = wav.samples;
+    failures += check((std::string("read back ") + names[i]).c_str(), ok);
+    remove(path.c_str());
+  }
+  if (failures) return 1;
+
+  // Tones: the band at the tone frequency reads amplitude / 4
+  Analysis tone = analyze(signals[0], sampleRate);
+  bool tonesOk = true;
+  printf("\ntones (amplitude %d, expect %d at the tone frequency)\n", amplitude, amplitude / 4);
+  for (uint8_t b = 0; b < numBands; b++) {
+    // Last block of the tone, once the filter sees nothing else
+    const std::vector<uint16_t>& block = tone.magnitudes[(b + 1) * toneLength / blockSize - 1];
+    printf("  %4u Hz:", bands[b]);
+    for (uint16_t magnitude : block) printf(" %5u", magnitude);
+    printf("\n");
+    if (abs((int)block[b] - amplitude / 4) > amplitude / 4 / 50) tonesOk = false;
+    for (uint8_t other = 0; other < numBands; other++) {
+      if (other != b && block[other] >= block[b]) tonesOk = false;
+    }
+  }
+  failures += check("tone bands", tonesOk);
+
+  // Sweep: each band peaks when the sweep passes its frequency, to within a
+  // block or a quarter of the time the sweep takes to cross the band's
+  // resolution (sample rate / block size), which is long for low bands
+  Analysis swept = analyze(signals[1], sampleRate);
+  bool sweepOk = true;
+  double rate = log(3500 / 40.0) / 8;
+  double halfWidth = (double)sampleRate / blockSize / 2;
+  printf("\nsweep 40-3500 Hz over 8 s, peak time of each band (s)\n");
+  for (uint8_t b = 0; b < numBands; b++) {
+    size_t peak = 0;
+    for (size_t i = 0; i < swept.magnitudes.size(); i++) {
+      if (swept.magnitudes[i][b] > swept.magnitudes[peak][b]) peak = i;
+    }
+    double measured = (peak + 0.5) * blockSize / sampleRate;
+    double expected = log(bands[b] / 40.0) / rate;
+    double crossing = log((bands[b] + halfWidth) / (bands[b] - halfWidth)) / rate;
+    double tolerance = max((double)blockSize / sampleRate, crossing / 4);
+    printf("  %4u Hz: expected %.3f +- %.3f, measured %.3f\n", bands[b], expected, tolerance, measured);
+    if (fabs(measured - expected) > tolerance) sweepOk = false;
+  }
+  failures += check("sweep peak times", sweepOk);
+
+  // Drums: one beat per kick, reported within two blocks
+  Analysis drum = analyze(signals[2], sampleRate);
+  bool drumsOk = drum.beats.size() == kickTimes.size();
+  printf("\ndrums 120 bpm, %u kicks, %u beats\n", (unsigned)kickTimes.size(), (unsigned)drum.beats.size());
+  for (size_t i = 0; i < drum.beats.size() && i < kickTimes.size(); i++) {
+    double delay = drum.beats[i] - kickTimes[i];
+    if (delay < 0 || delay > 2.0 * blockSize / sampleRate) drumsOk = false;
+    if (i < 4) printf("  kick %.3f s, beat %.3f s\n", kickTimes[i], drum.beats[i]);
+  }
+  failures += check("beat times", drumsOk);
+
+  double worst = max(max(tone.worstError, swept.worstError), drum.worstError);
+  printf("\n");
+  failures += check("magnitudes match the reference", worst <= 1.0);
+
+  // Beat hold: a tone burst in every other block of 64 samples at 44.1 kHz
+  // (1.45 ms each); beats must be at least the 20 ms hold apart, and no
+  // more than two blocks longer
+  const uint16_t holdRate = 44100;
+  const uint16_t holdBlock = 64;
+  const uint16_t holdMs = 20;
+  VibeLEDAudio held(holdRate);
+  held.addBand(1000);
+  held.setBeatSensitivity(24, holdMs);
+  int16_t burst[holdBlock];
+  int16_t silence[holdBlock] = { 0 };
+  for (uint16_t n = 0; n < holdBlock; n++) burst[n] = 8000 * sin(2.0 * PI * 1000 * n / holdRate);
+  std::vector<uint32_t> beatSamples;
+  for (uint32_t block = 0; block < 400; block++) {
+    held.process((block & 1) ? burst : silence, holdBlock);
+    if (held.isBeat()) beatSamples.push_back((block + 1) * holdBlock);
+  }
+  uint32_t holdSamples = (uint32_t)holdMs * holdRate / 1000;
+  bool holdOk = beatSamples.size() > 4;
+  for (size_t i = 1; i < beatSamples.size(); i++) {
+    uint32_t interval = beatSamples[i] - beatSamples[i - 1];
+    if (interval < holdSamples || interval >= holdSamples + 2 * holdBlock) holdOk = false;
+  }
+  printf("\nbeat hold %u ms at %u Hz, blocks of %u: %u beats, first interval %u samples\n",
+         holdMs, holdRate, holdBlock, (unsigned)beatSamples.size(),
+         beatSamples.size() > 1 ? (unsigned)(beatSamples[1] - beatSamples[0]) : 0);
+  failures += check("beat hold time", holdOk);
+
+  // Band frequencies whose coefficient does not fit
+  VibeLEDAudio audio(sampleRate);
+  bool rejected = !audio.addBand(0) && !audio.addBand(sampleRate / 2) && !audio.addBand(sampleRate);
+  rejected = rejected && audio.addBand(1) && audio.addBand(sampleRate / 2 - 1);
+  failures += check("addBand() range", rejected);
+
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+/*
+  GovernorSim.cpp - Host check that governed effects keep their speed.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Runs every effect on the simulated clock with the frame-rate governor
+  held at a low and at a high frame rate (setFrameRate() with equal
+  bounds), with the same random seed. The effect step follows the clock,
+  so each frame of the slow run must equal the frame the fast run was
+  showing at the same time: effects with state (fire, meteor trails,
+  sparkle...) run the steps between slow frames without showing them, up
+  to VIBELED_MAX_CATCH_UP steps per frame, so min_fps must stay above
+  50 / VIBELED_MAX_CATCH_UP (about 3 fps by default). Also reports how
+  many frames each run rendered; above the effect's step rate of 50 per
+  second the fast run renders no more, since there is nothing new to show.
+
+  Usage: GovernorSim [leds] [seconds] [min_fps] [max_fps]
+*/
+
+#include <map>
+
+#include "HostTest.h"
+
+struct Result {
+  uint32_t frames;
+  std::map<unsigned long, uint32_t> shown;  // Frame hash by render time (ms)
+};
+
+static Result run(EffectType effect, uint16_t numLeds, uint32_t seconds, uint16_t fps) {
+  hostSetMicros(0);
+  VibeLED leds(9, 10, 11, numLeds);
+  leds.begin();
+  setTestEffect(leds, effect);
+  leds.setFrameRate(fps, fps);
+  randomSeed(5);
+
+  Result result;
+  uint32_t lastFrames = leds.getFrameStats().frames;
+  uint64_t end = (uint64_t)seconds * 1000000;
+  while (hostMicros() < end) {
+    leds.update();
+    uint32_t frames = leds.getFrameStats().frames;
+    if (frames != lastFrames) {
+      lastFrames = frames;
+      result.shown[millis()] = hashFrame(leds);
+    }
+    hostAdvanceMicros(1000);
+  }
+  result.frames = result.shown.size();
+  return result;
+}
+
+int main(int argc, char** argv) {
+  uint16_t numLeds = (argc > 1) ? atoi(argv[1]) : 60;
+  uint32_t seconds = (argc > 2) ? atoi(argv[2]) : 10;
+  uint16_t minFps = (argc > 3) ? atoi(argv[3]) : 10;
+  uint16_t maxFps = (argc > 4) ? atoi(argv[4]) : 100;
+  int failures = 0;
+
+  printf("%u LEDs, %u s, 20 ms effect steps, %u and %u fps\n\n", numLeds, seconds, minFps,
+         maxFps);
+  printf("%-18s %10s %10s %9s  check\n", "effect", "slow", "fast", "matched");
+
+  for (const EffectTest& test : effectTests) {
+    Result slow = run(test.effect, numLeds, seconds, minFps);
+    Result fast = run(test.effect, numLeds, seconds, maxFps);
+
+    uint32_t matched = 0;
+    for (const auto& frame : slow.shown) {
+      // Last fast frame rendered at or before the slow one
+      auto shown = fast.shown.upper_bound(frame.first);
+      if (shown != fast.shown.begin() && (--shown)->second == frame.second) matched++;
+    }
+
+    bool ok = slow.frames > 0 && matched == slow.frames;
+    if (!ok) failures++;
+    printf("%-18s %10u %10u %8u%%  %s\n", test.name, slow.frames, fast.frames,
+           slow.frames ? matched * 100 / slow.frames : 0, ok ? "ok" : "DIFFERS");
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+/*
+  IdleSim.cpp - Host simulation of VibeLED's low-power idle mode.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Runs each effect twice on the simulated clock: once with the usual busy
+  loop that calls update() continuously, and once with
+  sleepUntilNextFrame() after every update(). Every loop pass and every
+  rendered frame cost simulated CPU time. Reports the frames per second,
+  the time awake per second (busy/idle; busy loops are always awake) and
+  checks that both loops showed the same sequence of frames.
+
+  Usage: IdleSim [leds] [seconds]
+*/
+
+#include <vector>
+
+#include "HostTest.h"
+
+const uint32_t loopCost = 20;     // One pass through loop() (us)
+const uint32_t ledCost = 4;       // Rendering and pushing one LED (us)
+
+struct Scenario {
+  const char* name;
+  EffectType effect;
+  uint16_t speed;
+  bool highPrecision;
+};
+
+const Scenario scenarios[] = {
+  { "none", EFFECT_NONE, 100, false },
+  { "static", EFFECT_STATIC, 100, false },
+  { "gradient", EFFECT_GRADIENT, 50, false },
+  { "fade_in", EFFECT_FADE_IN, 20, false },
+  { "breathe", EFFECT_BREATHE, 20, false },
+  { "rainbow", EFFECT_RAINBOW, 30, false },
+  { "static/16", EFFECT_STATIC, 10, true }
+};
+
+struct Result {
+  uint32_t frames;
+  uint32_t awake;                // Time awake per second of the last window (us)
+  double awakeShare;             // Whole run (percent)
+  uint32_t sleeps;
+  std::vector<uint32_t> shown;   // Distinct consecutive frames
+};
+
+static Result run(const Scenario& scenario, uint16_t numLeds, uint32_t seconds, bool sleep) {
+  hostSetMicros(0);
+  VibeLED leds(9, 10, 11, numLeds);
+  leds.setHighPrecision(scenario.highPrecision);
+  leds.begin();
+  leds.setEffect(scenario.effect, scenario.speed, Color(255, 120, 30));
+
+  Result result;
+  result.frames = 0;
+  result.sleeps = 0;
+
+  uint64_t end = (uint64_t)seconds * 1000000;
+  uint32_t lastFrames = leds.getFrameStats().frames;
+  while (hostMicros() < end) {
+    leds.update();
+    hostAdvanceMicros(loopCost);
+
+    uint32_t frames = leds.getFrameStats().frames;
+    if (frames != lastFrames) {
+      lastFrames = frames;
+      result.frames++;
+      hostAdvanceMicros((uint32_t)ledCost * numLeds);
+
+      uint32_t hash = hashFrame(leds);
+      if (result.shown.empty() || result.shown.back() != hash) {
+        result.shown.push_back(hash);
+      }
+    }
+
+    if (sleep) leds.sleepUntilNextFrame(1000);
+  }
+
+  IdleStats stats = leds.getIdleStats();
+  result.sleeps = stats.sleeps;
+  result.awake = sleep ? stats.awakeTime : 1000000;
+  result.awakeShare = sleep ? 100.0 - stats.sleepTime * 100000.0 / hostMicros() : 100.0;
+  return result;
+}
+
+int main(int argc, char** argv) {
+  uint16_t numLeds = (argc > 1) ? atoi(argv[1]) : 60;
+  uint32_t seconds = (argc > 2) ? atoi(argv[2]) : 10;
+  int failures = 0;
+
+  // wake() before sleeping ends the next sleep at once
+  {
+    hostSetMicros(0);
+    VibeLED leds(9, 10, 11, numLeds);
+    leds.begin();
+    leds.setEffect(EFFECT_STATIC, 100);
+    leds.refresh();
+    leds.wake();
+    bool ok = leds.sleepUntilNextFrame(1000) == 0 && leds.sleepUntilNextFrame(1000) == 1000;
+    printf("wake before sleep: %s\n\n", ok ? "ok" : "FAIL");
+    if (!ok) failures++;
+  }
+
+  printf("%u LEDs, %u s, %u us per loop, %u us per LED and frame\n\n", numLeds, seconds,
+         loopCost, ledCost);
+  printf("%-11s %8s %8s %17s %11s %8s  check\n", "effect", "fps", "sleeps", "awake us/s",
+         "awake %", "frames");
+
+  for (const Scenario& scenario : scenarios) {
+    Result busy = run(scenario, numLeds, seconds, false);
+    Result idle = run(scenario, numLeds, seconds, true);
+
+    bool ok = busy.shown == idle.shown;
+    if (!ok) failures++;
+    printf("%-11s %8.1f %8u %8u/%8u %5.1f/%5.1f %8u  %s\n", scenario.name,
+           (double)idle.frames / seconds, idle.sleeps, busy.awake, idle.awake, busy.awakeShare,
+           idle.awakeShare, (unsigned)idle.shown.size(), ok ? "ok" : "MISMATCH");
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+/*
+  NoiseBench.cpp - Benchmark and checks for VibeLEDNoise.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  For every noise function, reports the time per value, the output range,
+  mean and standard deviation, and the largest jump between neighbouring
+  samples (smoothness). Also checks that the results are deterministic for
+  a seed, that seeds give different fields, and that fill() matches
+  noise8() value for value.
+
+  Usage: NoiseBench [samples]
+*/
+
+#include "HostTest.h"
+#include "VibeLEDNoise.h"
+
+enum Function {
+  NOISE8_1D, NOISE8_2D, NOISE8_3D, FRACTAL8, NOISE16_1D, NOISE16_2D, NOISE16_3D, FRACTAL16
+};
+
+struct Test {
+  const char* name;
+  Function function;
+  bool wide;  // 16-bit result
+};
+
+const Test tests[] = {
+  { "noise8 1D", NOISE8_1D, false },
+  { "noise8 2D", NOISE8_2D, false },
+  { "noise8 3D", NOISE8_3D, false },
+  { "fractal8 x4", FRACTAL8, false },
+  { "noise16 1D", NOISE16_1D, true },
+  { "noise16 2D", NOISE16_2D, true },
+  { "noise16 3D", NOISE16_3D, true },
+  { "fractal16 x4", FRACTAL16, true }
+};
+
+// Sample i along a diagonal line through the field, 1/16 cell apart
+static uint32_t sample(VibeLEDNoise& noise, Function function, uint32_t i) {
+  uint16_t x = i * 16;
+  uint16_t y = i * 11 + 5000;
+  uint16_t z = i * 7 + 9000;
+
+  switch (function) {
+    case NOISE8_1D: return noise.noise8(x);
+    case NOISE8_2D: return noise.noise8(x, y);
+    case NOISE8_3D: return noise.noise8(x, y, z);
+    case FRACTAL8: return noise.fractal8(x, y, z, 4);
+    case NOISE16_1D: return noise.noise16((uint32_t)x << 8);
+    case NOISE16_2D: return noise.noise16((uint32_t)x << 8, (uint32_t)y << 8);
+    case NOISE16_3D: return noise.noise16((uint32_t)x << 8, (uint32_t)y << 8, (uint32_t)z << 8);
+    case FRACTAL16: return noise.fractal16((uint32_t)x << 8, (uint32_t)y << 8, (uint32_t)z << 8, 4);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  uint32_t samples = (argc > 1) ? atoi(argv[1]) : 1000000;
+  int failures = 0;
+  volatile uint32_t sink = 0;
+
+  printf("%u samples per function\n\n", samples);
+  printf("function        ns/value   min    max   mean  stddev  max_step  seeds\n");
+
+  for (const Test& test : tests) {
+    VibeLEDNoise noise(1234);
+    double scale = test.wide ? 65535.0 : 255.0;
+
+    // Timing
+    double start = nowNs();
+    for (uint32_t i = 0; i < samples; i++) {
+      sink += sample(noise, test.function, i);
+    }
+    double time = (nowNs() - start) / samples;
+
+    // Distribution and smoothness, as a fraction of the full range
+    uint32_t low = 0xFFFFFFFF;
+    uint32_t high = 0;
+    double sum = 0;
+    double squares = 0;
+    uint32_t maxStep = 0;
+    uint32_t previous = sample(noise, test.function, 0);
+    for (uint32_t i = 0; i < samples; i++) {
+      uint32_t value = sample(noise, test.function, i);
+      low = min(low, value);
+      high = max(high, value);
+      sum += value;
+      squares += (double)value * value;
+      uint32_t step = (value > previous) ? value - previous : previous - value;
+      maxStep = max(maxStep, step);
+      previous = value;
+    }
+    double mean = sum / samples;
+    double deviation = sqrt(squares / samples - mean * mean);
+
+    // Determinism: the same seed repeats, another seed differs
+    VibeLEDNoise same(1234);
+    VibeLEDNoise other(1235);
+    bool repeats = true;
+    uint32_t differences = 0;
+    for (uint32_t i = 0; i < 4096; i++) {
+      uint32_t value = sample(noise, test.function, i * 37);
+      if (sample(same, test.function, i * 37) != value) repeats = false;
+      if (sample(other, test.function, i * 37) != value) differences++;
+    }
+    bool ok = repeats && differences > 2048;
+    if (!ok) failures++;
+
+    printf("%-14s %8.1f  %5.3f  %5.3f  %5.3f  %5.3f   %6.3f    %s\n", test.name, time,
+           low / scale, high / scale, mean / scale, deviation / scale, maxStep / scale,
+           ok ? "ok" : "FAIL");
+  }
+
+  // fill() must match noise8() exactly, including across cell edges
+  VibeLEDNoise noise(99);
+  uint8_t values[1000];
+  bool fillOk = true;
+  for (uint16_t z = 0; z < 2000; z += 97) {
+    noise.fill(values, 1000, 12345, 37, 4321, z);
+    for (uint16_t i = 0; i < 1000; i++) {
+      if (values[i] != noise.noise8(12345 + i * 37, 4321, z)) fillOk = false;
+    }
+  }
+
+  double start = nowNs();
+  for (uint32_t i = 0; i < samples / 1000; i++) {
+    noise.fill(values, 1000, i * 13, 37, 4321, i);
+    sink += values[i % 1000];
+  }
+  double time = (nowNs() - start) / ((samples / 1000) * 1000.0);
+  printf("%-14s %8.1f  %46s\n", "fill (3D)", time, fillOk ? "ok" : "FAIL");
+  if (!fillOk) failures++;
+
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
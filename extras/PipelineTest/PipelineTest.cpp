@@ -0,0 +1,154 @@
+/*
+  PipelineTest.cpp - Stress test for VibeLEDPipeline and VibeLEDFrameQueue.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Renders each effect once on a single thread (render + encode, the
+  reference) and once through the pipeline with a render thread and an
+  output thread, and checks that the output thread received exactly the
+  same frames in the same order. The output thread sleeps at random to
+  force the queue to fill up and drain. Build with -fsanitize=thread to
+  check the queue for data races. Also checks that a queue sized for
+  another strip or holding frames of another format is never written.
+
+  Usage: PipelineTest [leds] [frames] [capacity]
+*/
+
+#include <thread>
+
+#include "HostTest.h"
+#include "VibeLEDPipeline.h"
+
+const EffectTest tests[] = {
+  { "rainbow", EFFECT_RAINBOW },
+  { "fire", EFFECT_FIRE },
+  { "sparkle", EFFECT_SPARKLE },
+  { "wave", EFFECT_WAVE }
+};
+
+// Hashes every frame it receives, slowing down now and then
+class HashSink : public VibeLEDFrameSink {
+  public:
+    uint32_t hash;
+    uint32_t frames;
+    uint32_t seed;
+
+    HashSink() {
+      hash = FNV_OFFSET;
+      frames = 0;
+      seed = 12345;
+    }
+
+    void write(const uint8_t* frame, uint16_t numLeds) {
+      hash = fnv(hash, frame, numLeds * 3);
+      frames++;
+
+      seed = seed * 1103515245UL + 12345;
+      if (((seed >> 16) & 63) == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    }
+};
+
+static void setup(VibeLED& leds, EffectType effect) {
+  leds.begin();
+  setTestEffect(leds, effect);
+  leds.setTimebase(0, 42);
+}
+
+// Render frames on one thread and hash them
+static uint32_t reference(EffectType effect, uint16_t numLeds, uint32_t frames) {
+  VibeLED leds(1, 2, 3, numLeds);
+  setup(leds, effect);
+
+  uint8_t* frame = new uint8_t[numLeds * 3];
+  uint32_t hash = FNV_OFFSET;
+  for (uint32_t f = 1; f <= frames; f++) {
+    if (leds.render(f * 20)) {
+      leds.encode(frame);
+      hash = fnv(hash, frame, numLeds * 3);
+    }
+  }
+  delete[] frame;
+  return hash;
+}
+
+int main(int argc, char** argv) {
+  uint16_t numLeds = (argc > 1) ? atoi(argv[1]) : 150;
+  uint32_t frames = (argc > 2) ? atoi(argv[2]) : 20000;
+  uint8_t capacity = (argc > 3) ? atoi(argv[3]) : 3;
+  int failures = 0;
+
+  printf("%u LEDs, %u frames, %u buffers\n\n", numLeds, frames, capacity);
+  printf("effect    pushed  popped  full     empty     depth  result\n");
+
+  for (const EffectTest& test : tests) {
+    uint32_t expected = reference(test.effect, numLeds, frames);
+
+    VibeLED leds(1, 2, 3, numLeds);
+    setup(leds, test.effect);
+    VibeLEDFrameQueue queue(numLeds, capacity);
+    HashSink sink;
+    VibeLEDPipeline pipeline(leds, queue, sink);
+
+    std::thread renderThread([&]() {
+      uint32_t f = 1;
+      while (f <= frames) {
+        // The simulated clock only moves on once the frame is queued
+        if (pipeline.render(f * 20)) {
+          f++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+
+    std::thread outputThread([&]() {
+      while (sink.frames < frames) {
+        if (!pipeline.present()) std::this_thread::yield();
+      }
+    });
+
+    renderThread.join();
+    outputThread.join();
+
+    FrameQueueStats stats = queue.getStats();
+    bool ok = (sink.hash == expected) && (sink.frames == frames);
+    if (!ok) failures++;
+
+    printf("%-9s %-7u %-7u %-8u %-9u %-6u %s\n", test.name, stats.pushed, stats.popped,
+           stats.full, stats.empty, stats.maxDepth, ok ? "ok" : "MISMATCH");
+  }
+
+  // Queues for a shorter and a longer strip: nothing is rendered or queued
+  uint16_t sizes[] = { (uint16_t)(numLeds / 2), (uint16_t)(numLeds + 1) };
+  printf("\n");
+  for (uint16_t size : sizes) {
+    VibeLED leds(1, 2, 3, numLeds);
+    setup(leds, EFFECT_RAINBOW);
+    VibeLEDFrameQueue queue(size, capacity);
+    HashSink sink;
+    VibeLEDPipeline pipeline(leds, queue, sink);
+
+    bool rejected = !pipeline.render(20) && !pipeline.present() && queue.getStats().pushed == 0;
+    if (!rejected) failures++;
+    printf("queue for %u LEDs: %s\n", size, rejected ? "rejected" : "WRITTEN");
+  }
+
+  // A queue of RGBW frames for an RGB strip: nothing is rendered or queued
+  {
+    VibeLED leds(1, 2, 3, numLeds);
+    setup(leds, EFFECT_RAINBOW);
+    VibeLEDFrameQueue queue(numLeds, capacity, 4);
+    HashSink sink;
+    VibeLEDPipeline pipeline(leds, queue, sink);
+
+    bool rejected = !pipeline.render(20) && !pipeline.present() && queue.getStats().pushed == 0;
+    if (!rejected) failures++;
+    printf("queue of 4-byte LEDs: %s\n", rejected ? "rejected" : "WRITTEN");
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "all frames match");
+  return failures ? 1 : 0;
+}
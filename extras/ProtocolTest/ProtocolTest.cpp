@@ -0,0 +1,312 @@
+/*
+  ProtocolTest.cpp - Round-trip checks for VibeLEDProtocol.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Builds a frame for every command with VibeLEDProtocol::encode(), feeds
+  it to a decoder byte by byte and checks what reached the strip, through
+  the getters and the last values written to the LED pins (the last LED
+  of the group is written last). Also checks that malformed payloads are
+  rejected, that pixel writes are clipped at the end of the strip, that
+  bytecode uploads are verified before they replace the running program,
+  the command-to-push latency (also for frames only rendered, as for a
+  pipeline), and recovery after CRC errors, corrupted length bytes and
+  timeouts.
+
+  Usage: ProtocolTest
+*/
+
+#include "Arduino.h"
+#include "VibeLED.h"
+#include "VibeLEDProtocol.h"
+#include "VibeLEDVM.h"
+
+const uint16_t numLeds = 10;
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  printf("%-40s %s\n", name, ok ? "ok" : "FAIL");
+  if (!ok) failures++;
+}
+
+// Encode a frame and feed it byte by byte
+static void send(VibeLEDProtocol& protocol, uint8_t command, const uint8_t* payload,
+                 uint8_t length) {
+  uint8_t frame[VIBELED_PROTOCOL_MAX_PAYLOAD + 4];
+  uint16_t size = VibeLEDProtocol::encode(command, payload, length, frame);
+  protocol.feed(frame, size);
+}
+
+// Whether the frame was applied (true) or rejected as malformed (false)
+static bool accepted(VibeLEDProtocol& protocol, uint8_t command, const uint8_t* payload,
+                     uint8_t length) {
+  ProtocolStats before = protocol.getStats();
+  send(protocol, command, payload, length);
+  ProtocolStats after = protocol.getStats();
+  return after.frames == before.frames + 1 && after.unknownCommands == before.unknownCommands;
+}
+
+// Last color written to the RGB pins (9, 10, 11)
+static bool shows(uint8_t r, uint8_t g, uint8_t b) {
+  return digitalRead(9) == r && digitalRead(10) == g && digitalRead(11) == b;
+}
+
+static bool sameColor(Color a, Color b) {
+  return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+// Pixels 0..numLeds-1 colored (i, 2i, 3i)
+static void paint(VibeLEDProtocol& protocol) {
+  uint8_t payload[2 + numLeds * 3] = { 0, 0 };
+  for (uint16_t i = 0; i < numLeds; i++) {
+    payload[2 + i * 3] = i;
+    payload[3 + i * 3] = i * 2;
+    payload[4 + i * 3] = i * 3;
+  }
+  send(protocol, CMD_SET_PIXELS, payload, sizeof(payload));
+}
+
+static void commands() {
+  hostSetMicros(0);
+  VibeLED leds(9, 10, 11, numLeds);
+  leds.begin();
+  VibeLEDProtocol protocol(leds);
+
+  uint8_t effect[] = { EFFECT_RAINBOW };
+  check("CMD_SET_EFFECT", accepted(protocol, CMD_SET_EFFECT, effect, 1) &&
+        leds.getEffect() == EFFECT_RAINBOW);
+  uint8_t effectSpeed[] = { EFFECT_STATIC, 0x34, 0x12 };
+  check("CMD_SET_EFFECT with speed", accepted(protocol, CMD_SET_EFFECT, effectSpeed, 3) &&
+        leds.getEffect() == EFFECT_STATIC && leds.getParams().speed == 0x1234);
+
+  uint8_t params[] = { 0x20, 0x01, 200, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+  EffectParams set;
+  bool ok = accepted(protocol, CMD_SET_PARAMS, params, sizeof(params));
+  set = leds.getParams();
+  check("CMD_SET_PARAMS", ok && set.speed == 0x120 && set.brightness == 200 &&
+        sameColor(set.color1, Color(1, 2, 3)) && sameColor(set.color2, Color(4, 5, 6)) &&
+        sameColor(set.color3, Color(7, 8, 9)) && set.option1 == 10 && set.option2 == 11);
+  uint8_t longParams[15] = { 0 };
+  check("CMD_SET_PARAMS 15 bytes rejected", !accepted(protocol, CMD_SET_PARAMS, longParams, 15) &&
+        leds.getParams().speed == 0x120);
+
+  uint8_t brightness[] = { 255 };
+  check("CMD_SET_BRIGHTNESS", accepted(protocol, CMD_SET_BRIGHTNESS, brightness, 1) &&
+        leds.getParams().brightness == 255);
+
+  uint8_t color[] = { 30, 60, 90 };
+  check("CMD_SET_COLOR", accepted(protocol, CMD_SET_COLOR, color, 3) &&
+        sameColor(leds.getParams().color1, Color(30, 60, 90)));
+
+  // A 50 ms delay: update() pushes again only 50 ms after the last frame
+  uint8_t delay[] = { 50, 0 };
+  ok = accepted(protocol, CMD_SET_DELAY, delay, 2);
+  leds.refresh();
+  uint32_t pushes = leds.getPushCount();
+  hostAdvanceMicros(49000);
+  leds.update();
+  ok = ok && leds.getPushCount() == pushes;
+  hostAdvanceMicros(1000);
+  leds.update();
+  check("CMD_SET_DELAY", ok && leds.getPushCount() == pushes + 1);
+
+  uint8_t none[] = { EFFECT_NONE };
+  send(protocol, CMD_SET_EFFECT, none, 1);
+  paint(protocol);
+  check("CMD_SET_PIXELS", shows(9, 18, 27));
+
+  uint8_t group[] = { 2, 0, 5, 0 };
+  ok = accepted(protocol, CMD_SET_GROUP, group, 4);
+  send(protocol, CMD_SET_BRIGHTNESS, brightness, 1);
+  check("CMD_SET_GROUP", ok && shows(5, 10, 15));
+  ok = accepted(protocol, CMD_RESET_GROUP, nullptr, 0);
+  send(protocol, CMD_SET_BRIGHTNESS, brightness, 1);
+  check("CMD_RESET_GROUP", ok && shows(9, 18, 27));
+
+  uint8_t fill[] = { 0, 0, 9, 0, 7, 8, 9 };
+  check("CMD_FILL_PIXELS", accepted(protocol, CMD_FILL_PIXELS, fill, 7) && shows(7, 8, 9));
+
+  check("CMD_CLEAR", accepted(protocol, CMD_CLEAR, nullptr, 0) && shows(0, 0, 0));
+
+  // Malformed payloads change nothing
+  ProtocolStats before = protocol.getStats();
+  send(protocol, CMD_SET_BRIGHTNESS, brightness, 0);
+  send(protocol, CMD_SET_COLOR, color, 2);
+  send(protocol, CMD_SET_GROUP, group, 3);
+  send(protocol, CMD_RESET_GROUP, group, 1);
+  send(protocol, CMD_FILL_PIXELS, fill, 6);
+  send(protocol, CMD_CLEAR, fill, 1);
+  send(protocol, CMD_SET_PIXELS, fill, 4);
+  send(protocol, 0x7F, nullptr, 0);
+  ProtocolStats after = protocol.getStats();
+  check("malformed payloads rejected", after.frames == before.frames &&
+        after.unknownCommands == before.unknownCommands + 8);
+}
+
+static void clipping() {
+  hostSetMicros(0);
+  VibeLED leds(9, 10, 11, numLeds);
+  leds.begin();
+  VibeLEDProtocol protocol(leds);
+
+  // Four LEDs from LED 8: the two past the end are dropped
+  uint8_t tail[] = { 8, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4 };
+  check("RGB pixels clipped at the end", accepted(protocol, CMD_SET_PIXELS, tail, sizeof(tail)) &&
+        shows(2, 2, 2));
+
+  uint8_t outside[] = { numLeds, 0, 1, 1, 1 };
+  uint8_t wrapping[] = { 0xFF, 0xFF, 1, 1, 1 };
+  check("RGB pixels past the end rejected",
+        !accepted(protocol, CMD_SET_PIXELS, outside, sizeof(outside)) &&
+        !accepted(protocol, CMD_SET_PIXELS, wrapping, sizeof(wrapping)) && shows(2, 2, 2));
+
+  VibeLED single(9, numLeds);
+  single.begin();
+  VibeLEDProtocol singleProtocol(single);
+
+  // 16 bits from LED 6: LEDs 6..9 are set, the last one on
+  uint8_t bits[] = { 6, 0, 0x08, 0xFF };
+  check("single color bits clipped", accepted(singleProtocol, CMD_SET_PIXELS, bits, 4) &&
+        digitalRead(9) == HIGH);
+  uint8_t off[] = { 6, 0, 0x07, 0xFF };
+  check("single color bits applied", accepted(singleProtocol, CMD_SET_PIXELS, off, 4) &&
+        digitalRead(9) == LOW);
+  uint8_t far[] = { 0xF8, 0xFF, 0xFF, 0xFF };
+  check("single color bits past the end rejected",
+        !accepted(singleProtocol, CMD_SET_PIXELS, far, 4) && digitalRead(9) == LOW);
+}
+
+static void vm() {
+  hostSetMicros(0);
+  VibeLED leds(9, 10, 11, numLeds);
+  leds.begin();
+  leds.setEffect(EFFECT_NONE);
+  VibeLEDProtocol protocol(leds);
+
+  // Every LED in color1: PARAM 0, PARAM 1, PARAM 2, OUT
+  uint8_t first[] = { 0, 0, OP_PARAM, PARAM_COLOR1_R, OP_PARAM, PARAM_COLOR1_G };
+  uint8_t second[] = { 4, 0, OP_PARAM, PARAM_COLOR1_B, OP_OUT };
+  uint8_t length[] = { 7, 0 };
+  check("CMD_VM_WRITE without setVM() rejected", !accepted(protocol, CMD_VM_WRITE, first, 6));
+
+  VibeLEDVM interpreter(leds);
+  protocol.setVM(&interpreter);
+  uint8_t color[] = { 40, 50, 60 };
+  send(protocol, CMD_SET_COLOR, color, 3);
+  bool ok = accepted(protocol, CMD_VM_WRITE, first, sizeof(first)) &&
+            accepted(protocol, CMD_VM_WRITE, second, sizeof(second));
+  check("CMD_VM_WRITE", ok);
+  check("CMD_VM_COMMIT", accepted(protocol, CMD_VM_COMMIT, length, 2) &&
+        leds.getEffect() == EFFECT_CUSTOM && shows(40, 50, 60));
+
+  // An upload that does not verify leaves the running program in place
+  uint8_t underflow[] = { 0, 0, OP_ADD, OP_OUT };
+  uint8_t badLength[] = { 2, 0 };
+  ok = accepted(protocol, CMD_VM_WRITE, underflow, sizeof(underflow)) &&
+       !accepted(protocol, CMD_VM_COMMIT, badLength, 2);
+  check("CMD_VM_COMMIT of a bad program rejected", ok && interpreter.getError() == VM_ERR_STACK &&
+        leds.getEffect() == EFFECT_CUSTOM && shows(40, 50, 60));
+
+  uint8_t past[] = { VIBELED_VM_MAX_PROGRAM & 0xFF, VIBELED_VM_MAX_PROGRAM >> 8, OP_END };
+  uint8_t shortCommit[] = { 7 };
+  check("malformed VM payloads rejected", !accepted(protocol, CMD_VM_WRITE, past, 3) &&
+        !accepted(protocol, CMD_VM_WRITE, past, 1) &&
+        !accepted(protocol, CMD_VM_COMMIT, shortCommit, 1));
+}
+
+static void latency() {
+  hostSetMicros(0);
+  VibeLED leds(9, 10, 11, numLeds);
+  leds.begin();
+  leds.setEffect(EFFECT_STATIC, 100);
+  leds.refresh();
+  VibeLEDProtocol protocol(leds);
+
+  // Shown at the next update(), 40 ms after the command arrived
+  hostAdvanceMicros(60000);
+  uint8_t group[] = { 0, 0, numLeds - 1, 0 };
+  send(protocol, CMD_SET_GROUP, group, 4);
+  bool pending = protocol.getStats().lastLatency == 0;
+  hostAdvanceMicros(40000);
+  leds.update();
+  ProtocolStats stats = protocol.getStats();
+  check("latency to the next push", pending && stats.lastLatency == 40000 &&
+        stats.maxLatency == 40000);
+
+  // Shown by the command itself
+  uint8_t brightness[] = { 100 };
+  send(protocol, CMD_SET_BRIGHTNESS, brightness, 1);
+  stats = protocol.getStats();
+  check("latency of an immediate push", stats.lastLatency == 0 && stats.maxLatency == 40000);
+
+  // Rendered for a pipeline (VibeLED::render()) rather than pushed
+  hostAdvanceMicros(100000);
+  send(protocol, CMD_SET_GROUP, group, 4);
+  hostAdvanceMicros(30000);
+  bool rendered = leds.render(millis());
+  stats = protocol.getStats();
+  check("latency to the next rendered frame", rendered && stats.lastLatency == 30000);
+}
+
+static void recovery() {
+  hostSetMicros(0);
+  VibeLED leds(9, 10, 11, numLeds);
+  leds.begin();
+  VibeLEDProtocol protocol(leds);
+
+  uint8_t frames[3][5];
+  uint8_t levels[] = { 10, 20, 30 };
+  for (uint8_t i = 0; i < 3; i++) {
+    VibeLEDProtocol::encode(CMD_SET_BRIGHTNESS, levels + i, 1, frames[i]);
+  }
+
+  // Bad CRC: dropped, the next frame decodes
+  uint8_t bad[5];
+  memcpy(bad, frames[0], 5);
+  bad[4] ^= 0x01;
+  protocol.feed(bad, 5);
+  protocol.feed(frames[1], 5);
+  ProtocolStats stats = protocol.getStats();
+  check("CRC error", stats.crcErrors == 1 && stats.frames == 1 &&
+        leds.getParams().brightness == 20);
+
+  // A corrupted length swallows the frames behind it until the CRC
+  // fails; the rescan finds them again
+  uint8_t header[] = { VIBELED_PROTOCOL_SYNC, 30, CMD_SET_COLOR };
+  protocol.feed(header, 3);
+  for (uint8_t i = 0; i < 3; i++) protocol.feed(frames[i], 5);
+  uint8_t filler[20] = { 0 };
+  protocol.feed(filler, sizeof(filler));
+  stats = protocol.getStats();
+  check("rescan after a corrupted length", stats.crcErrors == 2 && stats.frames == 4 &&
+        leds.getParams().brightness == 30);
+
+  // Oversized length byte
+  uint8_t oversized[] = { VIBELED_PROTOCOL_SYNC, VIBELED_PROTOCOL_MAX_PAYLOAD + 1 };
+  protocol.feed(oversized, 2);
+  protocol.feed(frames[0], 5);
+  stats = protocol.getStats();
+  check("length error", stats.lengthErrors == 1 && stats.frames == 5 &&
+        leds.getParams().brightness == 10);
+
+  // A partial frame is dropped after the timeout
+  protocol.feed(frames[1], 3);
+  hostAdvanceMicros((VIBELED_PROTOCOL_TIMEOUT + 1) * 1000UL);
+  protocol.feed(frames[2], 5);
+  stats = protocol.getStats();
+  check("timeout", stats.lengthErrors == 2 && stats.frames == 6 &&
+        leds.getParams().brightness == 30);
+}
+
+int main() {
+  commands();
+  clipping();
+  vm();
+  latency();
+  recovery();
+
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
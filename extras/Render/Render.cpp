@@ -0,0 +1,501 @@
+/*
+  Render.cpp - Headless renderer and preview tool for VibeLED effects.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Runs any effect through VibeLED::update() on a simulated clock, much
+  faster than real time, and writes the frames as an image strip (one row
+  per frame), a terminal preview or a raw RGB file. A job file renders many
+  independent effects/configurations on several threads.
+
+  Usage: Render [options]
+    -e NAME|ID    effect (default rainbow)
+    -n LEDS       number of LEDs (default 60)
+    -s MS         effect speed, ms per step (default 50)
+    -c RRGGBB     primary color (default ff8020)
+    -b LEVEL      brightness 0-255 (default 255)
+    -f FRAMES     frames to render (default 100)
+    -t MS         simulated time between update() calls (default 1)
+    -r SEED       random seed (default 1)
+    -1            single color LEDs instead of RGB
+    -o FILE       write frames: .ppm, .png or .raw (by extension)
+    -a            ANSI true color preview on stdout
+    -A            ASCII preview on stdout
+    -J FILE       job file: one set of the options above per line
+    -j THREADS    worker threads for a job file (default: all cores)
+    -T THREADS    render each frame in tiles on several threads
+                  (VibeLEDTileRenderer, for very large strips)
+    -P FILE       write the profile of all jobs (build with
+                  -DVIBELED_PROFILE; jobs then run on one thread)
+
+  Each job prints its render rate and an FNV-1a hash of all frames, which
+  can be kept as golden data and compared after changes.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "VibeLED.h"
+#include "VibeLEDTiles.h"
+#include "VibeLEDProfile.h"
+
+struct Job {
+  std::string effect;
+  uint16_t numLeds;
+  uint16_t speed;
+  Color color;
+  uint8_t brightness;
+  uint32_t frames;
+  uint16_t tick;
+  uint32_t seed;
+  bool single;
+  uint8_t tileThreads; // 0 = render with VibeLED::update() alone
+  std::string output;
+  char preview;       // 0, 'a' (ANSI) or 'A' (ASCII)
+  std::string line;   // Job file line, for reports
+
+  Job() :
+    effect("rainbow"),
+    numLeds(60),
+    speed(50),
+    color(255, 128, 32),
+    brightness(255),
+    frames(100),
+    tick(1),
+    seed(1),
+    single(false),
+    tileThreads(0),
+    preview(0) {}
+};
+
+// Frame sink: writes image rows as frames arrive
+
+class FrameWriter {
+  public:
+    virtual ~FrameWriter() {}
+    virtual void frame(const uint8_t* rgb, uint16_t numLeds) = 0;
+};
+
+// Binary PPM (P6); the frame count is known up front so it can stream
+class PpmWriter : public FrameWriter {
+  public:
+    PpmWriter(FILE* file, uint16_t width, uint32_t height) : _file(file) {
+      fprintf(_file, "P6\n%u %u\n255\n", width, height);
+    }
+    void frame(const uint8_t* rgb, uint16_t numLeds) { fwrite(rgb, 3, numLeds, _file); }
+
+  private:
+    FILE* _file;
+};
+
+// PNG with uncompressed (stored) deflate blocks, one IDAT chunk per row
+class PngWriter : public FrameWriter {
+  public:
+    PngWriter(FILE* file, uint16_t width, uint32_t height) : _file(file), _height(height), _row(0) {
+      static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+      fwrite(signature, 1, 8, _file);
+
+      uint8_t header[13];
+      _put32(header, width);
+      _put32(header + 4, height);
+      header[8] = 8;   // Bit depth
+      header[9] = 2;   // RGB
+      header[10] = 0;
+      header[11] = 0;
+      header[12] = 0;
+      _chunk("IHDR", header, 13);
+
+      _adlerA = 1;
+      _adlerB = 0;
+    }
+
+    void frame(const uint8_t* rgb, uint16_t numLeds) {
+      std::vector<uint8_t> data;
+      if (_row == 0) {
+        data.push_back(0x78);  // zlib header, no compression
+        data.push_back(0x01);
+      }
+
+      // Filter byte 0 + pixels, split into stored blocks of at most 65535 bytes
+      std::vector<uint8_t> raw(1 + numLeds * 3);
+      raw[0] = 0;
+      memcpy(&raw[1], rgb, numLeds * 3);
+      _adler(raw.data(), raw.size());
+
+      size_t offset = 0;
+      while (offset < raw.size()) {
+        size_t size = min(raw.size() - offset, (size_t)65535);
+        bool last = (_row + 1 == _height) && (offset + size == raw.size());
+        data.push_back(last ? 1 : 0);
+        data.push_back(size & 0xFF);
+        data.push_back(size >> 8);
+        data.push_back(~size & 0xFF);
+        data.push_back((~size >> 8) & 0xFF);
+        data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + size);
+        offset += size;
+      }
+
+      if (++_row == _height) {
+        uint8_t adler[4];
+        _put32(adler, (_adlerB << 16) | _adlerA);
+        data.insert(data.end(), adler, adler + 4);
+      }
+      _chunk("IDAT", data.data(), data.size());
+
+      if (_row == _height) _chunk("IEND", nullptr, 0);
+    }
+
+  private:
+    FILE* _file;
+    uint32_t _height;
+    uint32_t _row;
+    uint32_t _adlerA;
+    uint32_t _adlerB;
+
+    static void _put32(uint8_t* out, uint32_t value) {
+      out[0] = value >> 24;
+      out[1] = value >> 16;
+      out[2] = value >> 8;
+      out[3] = value;
+    }
+
+    static uint32_t _crc(uint32_t crc, const uint8_t* data, size_t length) {
+      for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t k = 0; k < 8; k++) {
+          crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+      }
+      return crc;
+    }
+
+    void _adler(const uint8_t* data, size_t length) {
+      for (size_t i = 0; i < length; i++) {
+        _adlerA = (_adlerA + data[i]) % 65521;
+        _adlerB = (_adlerB + _adlerA) % 65521;
+      }
+    }
+
+    void _chunk(const char* type, const uint8_t* data, size_t length) {
+      uint8_t size[4];
+      _put32(size, length);
+      fwrite(size, 1, 4, _file);
+      fwrite(type, 1, 4, _file);
+      if (length > 0) fwrite(data, 1, length, _file);
+
+      uint32_t crc = _crc(0xFFFFFFFF, (const uint8_t*)type, 4);
+      crc = _crc(crc, data, length) ^ 0xFFFFFFFF;
+      _put32(size, crc);
+      fwrite(size, 1, 4, _file);
+    }
+};
+
+// Raw RGB bytes, frame after frame
+class RawWriter : public FrameWriter {
+  public:
+    RawWriter(FILE* file) : _file(file) {}
+    void frame(const uint8_t* rgb, uint16_t numLeds) { fwrite(rgb, 3, numLeds, _file); }
+
+  private:
+    FILE* _file;
+};
+
+// Terminal preview, one line per frame
+class PreviewWriter : public FrameWriter {
+  public:
+    PreviewWriter(bool ansi) : _ansi(ansi) {}
+
+    void frame(const uint8_t* rgb, uint16_t numLeds) {
+      static const char shades[] = " .:-=+*#%@";
+      std::string line;
+      char cell[32];
+
+      for (uint16_t i = 0; i < numLeds; i++) {
+        const uint8_t* c = rgb + i * 3;
+        if (_ansi) {
+          snprintf(cell, sizeof(cell), "\x1b[48;2;%u;%u;%um ", c[0], c[1], c[2]);
+          line += cell;
+        } else {
+          uint16_t luma = (c[0] * 77 + c[1] * 150 + c[2] * 29) >> 8;
+          line += shades[luma * 9 / 255];
+        }
+      }
+      if (_ansi) line += "\x1b[0m";
+      line += '\n';
+      fwrite(line.data(), 1, line.size(), stdout);
+    }
+
+  private:
+    bool _ansi;
+};
+
+// Output driver that captures every frame VibeLED pushes
+class CaptureOutput : public VibeLEDOutput {
+  public:
+    CaptureOutput(uint16_t numLeds, FrameWriter* writer) :
+      frames(0), hash(2166136261u), _rgb(numLeds * 3), _writer(writer) {}
+
+    void begin(VibeLED&) {}
+
+    void show(VibeLED& leds) {
+      uint16_t numLeds = leds.getNumLeds();
+      bool rgb = (leds.getLEDType() == LED_TYPE_RGB);
+
+      for (uint16_t i = 0; i < numLeds; i++) {
+        Color color = rgb ? leds.getOutputColor(i) :
+                            (leds.getLEDState(i) ? Color(255, 255, 255) : Color(0, 0, 0));
+        _rgb[i * 3] = color.r;
+        _rgb[i * 3 + 1] = color.g;
+        _rgb[i * 3 + 2] = color.b;
+      }
+
+      for (uint8_t byte : _rgb) {
+        hash = (hash ^ byte) * 16777619u;
+      }
+      if (_writer != nullptr) _writer->frame(_rgb.data(), numLeds);
+      frames++;
+    }
+
+    uint32_t frames;
+    uint32_t hash;
+
+  private:
+    std::vector<uint8_t> _rgb;
+    FrameWriter* _writer;
+};
+
+static std::string profileFile;
+
+#ifdef VIBELED_PROFILE
+// Writes the profile dump to a file
+class FilePrint : public Print {
+  public:
+    FilePrint(FILE* file) : _file(file) {}
+    size_t write(uint8_t data) { return fputc(data, _file) == EOF ? 0 : 1; }
+
+  private:
+    FILE* _file;
+};
+#endif
+
+// Write the profile of all jobs rendered so far
+static bool writeProfile() {
+  if (profileFile.empty()) return true;
+#ifdef VIBELED_PROFILE
+  FILE* file = fopen(profileFile.c_str(), "wb");
+  if (file == nullptr) {
+    fprintf(stderr, "cannot open %s\n", profileFile.c_str());
+    return false;
+  }
+  FilePrint out(file);
+  VibeLEDProfile.dump(out);
+  fclose(file);
+  return true;
+#else
+  fprintf(stderr, "-P needs a build with -DVIBELED_PROFILE\n");
+  return false;
+#endif
+}
+
+static bool parseArgs(const std::vector<std::string>& args, Job& job, std::string& jobFile, int& threads) {
+  for (size_t i = 0; i < args.size(); i++) {
+    const std::string& arg = args[i];
+    if (arg.size() != 2 || arg[0] != '-') {
+      fprintf(stderr, "unknown argument '%s'\n", arg.c_str());
+      return false;
+    }
+
+    char option = arg[1];
+    if (option == '1') { job.single = true; continue; }
+    if (option == 'a' || option == 'A') { job.preview = option; continue; }
+
+    if (i + 1 >= args.size()) {
+      fprintf(stderr, "option %s needs a value\n", arg.c_str());
+      return false;
+    }
+    const std::string& value = args[++i];
+
+    switch (option) {
+      case 'e': job.effect = value; break;
+      case 'n': job.numLeds = constrain(atoi(value.c_str()), 1, 65535); break;
+      case 's': job.speed = constrain(atoi(value.c_str()), 1, 65535); break;
+      case 'b': job.brightness = constrain(atoi(value.c_str()), 0, 255); break;
+      case 'f': job.frames = strtoul(value.c_str(), nullptr, 10); break;
+      case 't': job.tick = constrain(atoi(value.c_str()), 1, 65535); break;
+      case 'T': job.tileThreads = constrain(atoi(value.c_str()), 0, 255); break;
+      case 'r': job.seed = strtoul(value.c_str(), nullptr, 10); break;
+      case 'o': job.output = value; break;
+      case 'J': jobFile = value; break;
+      case 'j': threads = atoi(value.c_str()); break;
+      case 'P': profileFile = value; break;
+      case 'c': {
+        uint32_t rgb = strtoul(value.c_str(), nullptr, 16);
+        job.color = Color(rgb >> 16, rgb >> 8, rgb);
+        break;
+      }
+      default:
+        fprintf(stderr, "unknown option %s\n", arg.c_str());
+        return false;
+    }
+  }
+  return true;
+}
+
+static std::vector<std::string> split(const std::string& line) {
+  std::vector<std::string> words;
+  size_t start = line.find_first_not_of(" \t");
+  while (start != std::string::npos) {
+    size_t end = line.find_first_of(" \t", start);
+    words.push_back(line.substr(start, end - start));
+    start = line.find_first_not_of(" \t", end);
+  }
+  return words;
+}
+
+static bool endsWith(const std::string& text, const char* suffix) {
+  size_t length = strlen(suffix);
+  return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+// Render one job; returns a one-line report
+static std::string render(const Job& job) {
+  // Each thread has its own simulated clock and random generator
+  hostSetMicros(0);
+  randomSeed(job.seed);
+
+  FILE* file = nullptr;
+  FrameWriter* writer = nullptr;
+
+  if (!job.output.empty()) {
+    file = fopen(job.output.c_str(), "wb");
+    if (file == nullptr) return "cannot open " + job.output;
+
+    if (endsWith(job.output, ".png")) {
+      writer = new PngWriter(file, job.numLeds, job.frames);
+    } else if (endsWith(job.output, ".raw")) {
+      writer = new RawWriter(file);
+    } else {
+      writer = new PpmWriter(file, job.numLeds, job.frames);
+    }
+  } else if (job.preview) {
+    writer = new PreviewWriter(job.preview == 'a');
+  }
+
+  VibeLED* leds = job.single ? new VibeLED(9, job.numLeds) : new VibeLED(9, 10, 11, job.numLeds);
+  CaptureOutput capture(job.numLeds, writer);
+  leds->begin();
+  leds->setOutput(&capture);  // After begin(), so the blank first frame is not captured
+
+  // Effect by name or number
+  int id = atoi(job.effect.c_str());
+  if (id > 0 || job.effect == "0") {
+    leds->setEffect((EffectType)id);
+  } else {
+    leds->setEffect(String(job.effect.c_str()));
+  }
+  EffectParams params = leds->getParams();
+  params.speed = job.speed;
+  params.brightness = job.brightness;
+  params.color1 = job.color;
+  leds->setEffect(leds->getEffect(), params);
+
+  VibeLEDTileRenderer* tiles = job.tileThreads ? new VibeLEDTileRenderer(*leds, job.tileThreads) : nullptr;
+
+  auto start = std::chrono::steady_clock::now();
+  unsigned long now = 0;
+  while (capture.frames < job.frames) {
+    now += job.tick;
+    hostSetMicros((uint64_t)now * 1000);
+    if (tiles != nullptr) {
+      tiles->update(now);
+    } else {
+      leds->update(now);
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  delete tiles;
+  delete leds;
+  delete writer;
+  if (file != nullptr) fclose(file);
+
+  char report[160];
+  snprintf(report, sizeof(report), "%-12s %6u LEDs %9u frames %10.0f frames/s %8.1fx real time  hash %08x",
+           job.effect.c_str(), job.numLeds, capture.frames, capture.frames / seconds,
+           (now / 1000.0) / seconds, capture.hash);
+  return report;
+}
+
+int main(int argc, char** argv) {
+  Job defaults;
+  std::string jobFile;
+  int threads = std::thread::hardware_concurrency();
+
+  if (!parseArgs(std::vector<std::string>(argv + 1, argv + argc), defaults, jobFile, threads)) {
+    return 1;
+  }
+
+  if (jobFile.empty()) {
+    std::string report = render(defaults);
+    fprintf(stderr, "%s\n", report.c_str());
+    return writeProfile() ? 0 : 1;
+  }
+
+  // Job file: each line overrides the command line options
+  FILE* file = fopen(jobFile.c_str(), "r");
+  if (file == nullptr) {
+    fprintf(stderr, "cannot open %s\n", jobFile.c_str());
+    return 1;
+  }
+
+  std::vector<Job> jobs;
+  char buffer[512];
+  while (fgets(buffer, sizeof(buffer), file)) {
+    std::string line(buffer);
+    line = line.substr(0, line.find_first_of("#\r\n"));
+    std::vector<std::string> words = split(line);
+    if (words.empty()) continue;
+
+    Job job = defaults;
+    std::string ignored;
+    int ignoredThreads = 0;
+    if (!parseArgs(words, job, ignored, ignoredThreads)) return 1;
+    job.preview = 0;  // Previews from several threads would interleave
+    job.line = line;
+    jobs.push_back(job);
+  }
+  fclose(file);
+
+  std::vector<std::string> reports(jobs.size());
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  threads = constrain(threads, 1, (int)max(jobs.size(), (size_t)1));
+  if (!profileFile.empty()) threads = 1;  // The profiler records from one thread
+
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; t++) {
+    workers.push_back(std::thread([&]() {
+      for (size_t i = next++; i < jobs.size(); i = next++) {
+        reports[i] = render(jobs[i]);
+      }
+    }));
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  uint64_t frames = 0;
+  for (size_t i = 0; i < jobs.size(); i++) {
+    printf("%s\n", reports[i].c_str());
+    frames += jobs[i].frames;
+  }
+  printf("\n%zu jobs, %llu frames in %.2f s on %d threads (%.0f frames/s)\n", jobs.size(),
+         (unsigned long long)frames, seconds, threads, frames / seconds);
+  return writeProfile() ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*
+  ShiftBench.cpp - Host timing bench for VibeLEDShiftOutput.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Drives VibeLEDShiftOutput on the simulated clock, with every pin write
+  charged a fixed time (hostSetPinCost()), and calls refresh() once per
+  simulated microsecond as a loop or a fast timer interrupt would. For
+  several chain lengths and bit depths it reports the time to shift out
+  one plane, the plane 0 slot, the refresh rate and ISR load measured by
+  getStats(), and the worst deviation of a plane's display time from its
+  ideal 2^n units. A plane longer than its slot cannot be shown for its
+  share of the cycle, so brightness levels come out wrong; the bench
+  predicts this from the write time and checks the simulation agrees.
+
+  The default write costs approximate a 16 MHz AVR: digitalWrite() (as
+  shiftOut() uses) and the direct port writes of the library's AVR path.
+
+  Usage: ShiftBench [refresh_hz] [ns_per_pin_write]
+*/
+
+#include <vector>
+
+#include "Arduino.h"
+#include "VibeLED.h"
+#include "VibeLEDShiftOutput.h"
+
+struct Profile {
+  const char* name;
+  uint32_t pinCost;  // Nanoseconds per pin write
+};
+
+const Profile profiles[] = {
+  { "digitalWrite", 3500 },
+  { "port write", 250 }
+};
+
+const uint16_t chains[] = { 1, 4, 16 };  // Registers in the chain
+const uint8_t depths[] = { 2, 4, 6, 8 };
+
+struct Result {
+  double writeTime;      // One plane shifted and latched (us)
+  uint32_t unit;         // Plane 0 slot (us)
+  uint16_t refreshRate;
+  uint16_t cpuLoad;      // Per mille
+  uint32_t worstError;   // Largest plane display time error (us)
+};
+
+static Result run(uint16_t registers, uint8_t depth, uint16_t hz, uint32_t pinCost) {
+  hostSetMicros(0);
+  hostSetPinCost(0);
+  VibeLED leds(9, registers * 8);
+  VibeLEDShiftOutput output(11, 13, 10, depth);
+  leds.setOutput(&output);
+  leds.begin();
+  output.setRefreshRate(hz);
+  leds.setEffect(EFFECT_STATIC, 100);
+  leds.refresh();
+
+  hostSetPinCost(pinCost);
+  output.resetStats();
+
+  // begin() latched plane 0 as the first plane write
+  Result result;
+  result.unit = 1000000UL / ((uint32_t)hz * ((1UL << depth) - 1));
+  result.worstError = 0;
+  uint32_t writes = 1;
+  uint32_t counted = 0;
+  uint64_t latch = hostMicros();
+  uint64_t end = hostMicros() + 1000000;
+
+  while (hostMicros() < end) {
+    output.refresh();
+    uint32_t planeWrites = output.getStats().planeWrites;
+    if (planeWrites != counted) {
+      // The plane latched before this one was shown until now
+      uint8_t plane = (writes - 1) % depth;
+      uint32_t hold = (uint32_t)(hostMicros() - latch);
+      uint32_t ideal = result.unit << plane;
+      uint32_t error = (hold > ideal) ? hold - ideal : ideal - hold;
+      if (writes > depth && error > result.worstError) result.worstError = error;
+      latch = hostMicros();
+      counted = planeWrites;
+      writes++;
+    }
+    hostAdvanceMicros(1);
+  }
+
+  ShiftOutputStats stats = output.getStats();
+  result.writeTime = stats.planeWrites ? (double)stats.busyMicros / stats.planeWrites : 0;
+  result.refreshRate = stats.refreshRate;
+  result.cpuLoad = stats.cpuLoad;
+  hostSetPinCost(0);
+  return result;
+}
+
+int main(int argc, char** argv) {
+  uint16_t hz = (argc > 1) ? atoi(argv[1]) : 200;
+  std::vector<Profile> selected(profiles, profiles + sizeof(profiles) / sizeof(profiles[0]));
+  if (argc > 2) {
+    selected.clear();
+    selected.push_back({ "custom", (uint32_t)atoi(argv[2]) });
+  }
+  int failures = 0;
+
+  printf("target %u Hz, refresh() polled every us\n", hz);
+  for (const Profile& profile : selected) {
+    printf("\n%s, %u ns per pin write\n", profile.name, profile.pinCost);
+    printf("%9s %6s %9s %9s %8s %8s %9s  %s\n", "registers", "depth", "write us", "slot 0 us",
+           "Hz", "ISR %", "error us", "planes");
+
+    for (uint16_t registers : chains) {
+      for (uint8_t depth : depths) {
+        Result result = run(registers, depth, hz, profile.pinCost);
+
+        // Timing is exact while a plane fits its slot (one poll of slack)
+        bool predicted = result.writeTime + 1 <= result.unit;
+        bool onTime = result.worstError <= 2;
+        bool ok = predicted == onTime;
+        if (!ok) failures++;
+
+        printf("%9u %6u %9.1f %9u %8u %8.1f %9u  %s%s\n", registers, depth, result.writeTime,
+               result.unit, result.refreshRate, result.cpuLoad / 10.0, result.worstError,
+               onTime ? "on time" : "slot 0 missed", ok ? "" : " (UNEXPECTED)");
+      }
+    }
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+/*
+  SnapshotTest.cpp - Checks and timing for VibeLED effect state snapshots.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  For every effect, runs a strip for a while, saves a snapshot to a file,
+  and resumes a fresh strip from it with begin(snapshot). Both strips then
+  render the same frames with the same random seed, and every frame must
+  match. A cold start (begin() and setEffect()) is rendered alongside to
+  show how long the effect takes to look the same again. Also checks that
+  damaged snapshots and snapshots of other strips are rejected, and times
+  saveSnapshot() and restoreSnapshot().
+
+  Usage: SnapshotTest [leds] [frames] [file]
+*/
+
+#include <vector>
+
+#include "HostTest.h"
+
+// Render frames and record their hashes
+static std::vector<uint32_t> play(VibeLED& leds, uint32_t frames) {
+  std::vector<uint32_t> hashes;
+  randomSeed(7);
+  for (uint32_t i = 0; i < frames; i++) {
+    leds.refresh();
+    hashes.push_back(hashFrame(leds));
+  }
+  return hashes;
+}
+
+int main(int argc, char** argv) {
+  uint16_t numLeds = (argc > 1) ? atoi(argv[1]) : 60;
+  uint32_t frames = (argc > 2) ? atoi(argv[2]) : 300;
+  const char* file = (argc > 3) ? argv[3] : "snapshot.bin";
+  int failures = 0;
+
+  printf("%u LEDs, %u frames before and after the snapshot\n\n", numLeds, frames);
+  printf("%-18s %6s %8s %11s  check\n", "effect", "bytes", "resumed", "cold equal");
+
+  for (const EffectTest& test : effectTests) {
+    hostSetMicros(0);
+    VibeLED original(9, 10, 11, numLeds);
+    original.begin();
+    setTestEffect(original, test.effect);
+    randomSeed(3);
+    for (uint32_t i = 0; i < frames; i++) original.refresh();
+
+    // Save through a file, as a sketch would through EEPROM or flash
+    std::vector<uint8_t> snapshot(original.getSnapshotSize());
+    uint32_t size = original.saveSnapshot(snapshot.data(), snapshot.size());
+    FILE* out = fopen(file, "wb");
+    fwrite(snapshot.data(), 1, size, out);
+    fclose(out);
+    std::vector<uint8_t> loaded(size);
+    FILE* in = fopen(file, "rb");
+    size_t read = fread(loaded.data(), 1, size, in);
+    fclose(in);
+
+    uint32_t shown = hashFrame(original);
+    std::vector<uint32_t> expected = play(original, frames);
+
+    VibeLED resumed(9, 10, 11, numLeds);
+    bool ok = read == size && resumed.begin(loaded.data(), read) && hashFrame(resumed) == shown;
+    ok = ok && play(resumed, frames) == expected;
+
+    VibeLED cold(9, 10, 11, numLeds);
+    cold.begin();
+    setTestEffect(cold, test.effect);
+    std::vector<uint32_t> coldFrames = play(cold, frames);
+    uint32_t equal = 0;
+    for (uint32_t i = 0; i < frames; i++) {
+      if (coldFrames[i] == expected[i]) equal++;
+    }
+
+    if (!ok) failures++;
+    printf("%-18s %6u %8s %10u%%  %s\n", test.name, size, ok ? "exact" : "differs",
+           equal * 100 / frames, ok ? "ok" : "FAIL");
+  }
+  remove(file);
+
+  // Damaged snapshots and snapshots of other strips change nothing
+  VibeLED leds(9, 10, 11, numLeds);
+  leds.begin();
+  setTestEffect(leds, EFFECT_FIRE);
+  for (uint32_t i = 0; i < 50; i++) leds.refresh();
+  std::vector<uint8_t> snapshot(leds.getSnapshotSize());
+  uint32_t size = leds.saveSnapshot(snapshot.data(), snapshot.size());
+
+  bool rejected = leds.saveSnapshot(snapshot.data(), size - 1) == 0;
+  VibeLED other(9, 10, 11, numLeds + 1);
+  other.begin();
+  rejected = rejected && !other.begin(snapshot.data(), size) && other.getEffect() == EFFECT_NONE;
+  VibeLED single(9, numLeds);
+  rejected = rejected && !single.restoreSnapshot(snapshot.data(), size);
+  VibeLED target(9, 10, 11, numLeds);
+  target.begin();
+  for (uint32_t i = 0; i < size && rejected; i += 7) {
+    std::vector<uint8_t> damaged(snapshot);
+    damaged[i] ^= 0x10;
+    rejected = !target.restoreSnapshot(damaged.data(), size) && target.getEffect() == EFFECT_NONE;
+  }
+  rejected = rejected && !target.restoreSnapshot(snapshot.data(), size - 1);
+  printf("\n%-18s %35s\n", "rejects bad data", rejected ? "ok" : "FAIL");
+  if (!rejected) failures++;
+
+  // Timing
+  const int repeats = 20000;
+  double start = nowNs();
+  for (int i = 0; i < repeats; i++) leds.saveSnapshot(snapshot.data(), size);
+  double save = (nowNs() - start) / repeats / 1000;
+  start = nowNs();
+  for (int i = 0; i < repeats; i++) target.restoreSnapshot(snapshot.data(), size);
+  double restore = (nowNs() - start) / repeats / 1000;
+  printf("%-18s %u bytes, save %.2f us, restore %.2f us\n", "fire snapshot", size, save, restore);
+
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
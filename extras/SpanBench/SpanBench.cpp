@@ -0,0 +1,261 @@
+/*
+  SpanBench.cpp - Benchmark and checks for the VibeLED span API.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Times each span operation (fillLEDs, copyLEDs, writeLEDs, fillGradient)
+  and the effects built on them (static, waterfall, color wipe) against
+  the same work done one LED at a time with setLED(). Every pair runs
+  plain, with the power limiter and in high precision mode, and the output
+  colors, output brightness and power estimate of both paths are compared,
+  and every span path must be at least as fast as the per-LED one.
+  Gradients are also checked against exact interpolation (within one
+  level), including the end points and multiple stops.
+
+  Usage: SpanBench [leds] [repeats]
+*/
+
+#include "HostTest.h"
+
+enum Mode { MODE_PLAIN, MODE_POWER, MODE_PRECISION };
+const char* modeNames[] = { "plain", "power", "16-bit" };
+
+static Color pattern(uint16_t i) {
+  return Color(i * 7, i * 13 + 50, 255 - i * 3);
+}
+
+// Fresh strip with a pattern, so copies and the power estimate have work to do
+static VibeLED* makeStrip(uint16_t numLeds, Mode mode) {
+  VibeLED* leds = new VibeLED(1, 2, 3, numLeds);
+  leds->setHighPrecision(mode == MODE_PRECISION);
+  leds->begin();
+  for (uint16_t i = 0; i < numLeds; i++) {
+    leds->setLED(i, pattern(i));
+  }
+  if (mode == MODE_POWER) leds->setPowerLimit(numLeds * 12);
+  return leds;
+}
+
+// Output colors, output brightness and the power estimate of the last
+// frame, pushed first unless render() already finished it
+static uint32_t fingerprint(VibeLED& leds, uint8_t* frame, bool rendered) {
+  if (!rendered) leds.show();
+  leds.encode(frame);
+  uint32_t hash = fnv(FNV_OFFSET, frame, leds.getNumLeds() * 3);
+  uint8_t brightness = leds.getOutputBrightness();
+  hash = fnv(hash, &brightness, 1);
+  uint32_t requested = leds.getPowerStats().requested;
+  return fnv(hash, (const uint8_t*)&requested, sizeof(requested));
+}
+
+// Exact gradient level for reference: from + (to - from) * i / span, rounded
+static uint8_t exact(uint8_t from, uint8_t to, uint16_t i, uint16_t span) {
+  if (span == 0) return from;
+  double level = (from * 257.0 + (to - from) * 257.0 * i / span) / 257.0;
+  return (uint8_t)(level + 0.5);
+}
+
+// One operation: the span call and the per-LED equivalent
+struct Operation {
+  const char* name;
+  void (*span)(VibeLED& leds, const uint8_t* rgb);
+  void (*perPixel)(VibeLED& leds, const uint8_t* rgb);
+  EffectType effect;            // Effect drawn by render() (EFFECT_NONE: plain calls)
+  void (*draw)(VibeLED& leds);  // The effect's frame drawn with setLED()
+};
+
+static void spanFill(VibeLED& leds, const uint8_t*) {
+  leds.fillLEDs(0, leds.getNumLeds() - 1, Color(40, 80, 120));
+}
+
+static void pixelFill(VibeLED& leds, const uint8_t*) {
+  for (uint16_t i = 0; i < leds.getNumLeds(); i++) leds.setLED(i, Color(40, 80, 120));
+}
+
+static void spanCopy(VibeLED& leds, const uint8_t*) {
+  leds.copyLEDs(1, 0, leds.getNumLeds() - 1);
+}
+
+static void pixelCopy(VibeLED& leds, const uint8_t*) {
+  for (uint16_t i = leds.getNumLeds() - 1; i > 0; i--) leds.setLED(i, leds.getLEDColor(i - 1));
+}
+
+static void spanWrite(VibeLED& leds, const uint8_t* rgb) {
+  leds.writeLEDs(0, rgb, leds.getNumLeds());
+}
+
+static void pixelWrite(VibeLED& leds, const uint8_t* rgb) {
+  for (uint16_t i = 0; i < leds.getNumLeds(); i++, rgb += 3) leds.setLED(i, Color(rgb[0], rgb[1], rgb[2]));
+}
+
+static void spanGradient(VibeLED& leds, const uint8_t*) {
+  leds.fillGradient(0, leds.getNumLeds() - 1, Color(255, 10, 0), Color(0, 90, 255));
+}
+
+static void pixelGradient(VibeLED& leds, const uint8_t*) {
+  uint16_t span = leds.getNumLeds() - 1;
+  for (uint16_t i = 0; i <= span; i++) {
+    leds.setLED(i, Color(255 - (uint32_t)255 * i / span, 10 + (uint32_t)80 * i / span, (uint32_t)255 * i / span));
+  }
+}
+
+// Effects through render() (a new frame on every call, nothing pushed). The
+// per-LED versions draw the same frames with setLED() from a custom effect,
+// so both paths finish their frames the same way.
+static unsigned long frameTime = 0;
+
+static void renderFrame(VibeLED& leds, const uint8_t*) {
+  frameTime += 1000;
+  leds.render(frameTime);
+}
+
+class PixelEffect : public VibeLEDEffect {
+  public:
+    void (*draw)(VibeLED& leds);
+
+    void render(VibeLED& leds, uint16_t, uint16_t, uint16_t, unsigned long) override {
+      draw(leds);
+    }
+};
+
+static PixelEffect pixelEffect;
+
+static void drawStatic(VibeLED& leds) {
+  for (uint16_t i = 0; i < leds.getNumLeds(); i++) leds.setLED(i, leds.getParams().color1);
+}
+
+static void drawWaterfall(VibeLED& leds) {
+  for (uint16_t i = leds.getNumLeds() - 1; i > 0; i--) leds.setLED(i, leds.getLEDColor(i - 1));
+  leds.setLED(0, random(100) < 20 ? leds.getParams().color1 : Color(0, 0, 0));
+}
+
+static void drawWipe(VibeLED& leds) {
+  // The first frame of the wipe (step 0) lights LED 0 only
+  leds.setLED(0, leds.getParams().color1);
+  for (uint16_t i = 1; i < leds.getNumLeds(); i++) leds.setLED(i, Color(0, 0, 0));
+}
+
+const Operation operations[] = {
+  { "fill", spanFill, pixelFill, EFFECT_NONE, nullptr },
+  { "copy (shift)", spanCopy, pixelCopy, EFFECT_NONE, nullptr },
+  { "write packed", spanWrite, pixelWrite, EFFECT_NONE, nullptr },
+  { "gradient", spanGradient, pixelGradient, EFFECT_NONE, nullptr },
+  { "static effect", renderFrame, renderFrame, EFFECT_STATIC, drawStatic },
+  { "waterfall", renderFrame, renderFrame, EFFECT_WATERFALL, drawWaterfall },
+  { "color wipe", renderFrame, renderFrame, EFFECT_COLOR_WIPE, drawWipe }
+};
+
+// Effects are selected before timing, as the built-in effect on the span
+// path and as a custom effect on the per-LED path; other operations leave
+// the effect off
+static void prepare(VibeLED& leds, const Operation& operation, bool span) {
+  if (operation.effect != EFFECT_NONE) {
+    leds.setEffect(operation.effect, 10, 200, 100, 50);
+    if (!span) {
+      pixelEffect.draw = operation.draw;
+      leds.setCustomEffect(&pixelEffect);
+    }
+  }
+  randomSeed(5);  // Same drops on both paths
+}
+
+// Time one path; returns ns per LED and the fingerprint after one run
+static double run(const Operation& operation, bool span, Mode mode, uint16_t numLeds,
+                  uint32_t repeats, const uint8_t* rgb, uint32_t& hash) {
+  uint8_t* frame = new uint8_t[numLeds * 3];
+
+  VibeLED* check = makeStrip(numLeds, mode);
+  prepare(*check, operation, span);
+  (span ? operation.span : operation.perPixel)(*check, rgb);
+  hash = fingerprint(*check, frame, operation.effect != EFFECT_NONE);
+  delete check;
+
+  // Best of five batches, so a stray interruption cannot fail the speed check
+  VibeLED* leds = makeStrip(numLeds, mode);
+  prepare(*leds, operation, span);
+  uint32_t batch = max(repeats / 5, (uint32_t)1);
+  double time = 0;
+  for (int b = 0; b < 5; b++) {
+    double start = nowNs();
+    for (uint32_t r = 0; r < batch; r++) {
+      (span ? operation.span : operation.perPixel)(*leds, rgb);
+    }
+    double batchTime = (nowNs() - start) / ((double)batch * numLeds);
+    if (b == 0 || batchTime < time) time = batchTime;
+  }
+  delete leds;
+
+  delete[] frame;
+  return time;
+}
+
+int main(int argc, char** argv) {
+  uint16_t numLeds = (argc > 1) ? atoi(argv[1]) : 1000;
+  uint32_t repeats = (argc > 2) ? atoi(argv[2]) : 2000;
+  int failures = 0;
+
+  uint8_t* rgb = new uint8_t[numLeds * 3];
+  for (uint16_t i = 0; i < numLeds; i++) {
+    Color color = pattern(i * 5 + 1);
+    rgb[i * 3] = color.r;
+    rgb[i * 3 + 1] = color.g;
+    rgb[i * 3 + 2] = color.b;
+  }
+
+  printf("%u LEDs, %u repeats, ns per LED\n\n", numLeds, repeats);
+  printf("%-14s %-7s %9s %9s %8s  check\n", "operation", "mode", "setLED", "span", "speedup");
+
+  for (const Operation& operation : operations) {
+    for (int mode = MODE_PLAIN; mode <= MODE_PRECISION; mode++) {
+      uint32_t pixelHash;
+      uint32_t spanHash;
+      double pixel = run(operation, false, (Mode)mode, numLeds, repeats, rgb, pixelHash);
+      double span = run(operation, true, (Mode)mode, numLeds, repeats, rgb, spanHash);
+
+      // The fixed-point gradient rounds to nearest; the per-LED reference
+      // truncates, so only the other operations must match exactly. A span
+      // path must never be slower than the per-LED one.
+      bool match = (operation.span == spanGradient) || pixelHash == spanHash;
+      bool faster = span <= pixel;
+      if (!match || !faster) failures++;
+      printf("%-14s %-7s %9.2f %9.2f %7.1fx  %s\n", operation.name, modeNames[mode], pixel, span,
+             pixel / span, !match ? "MISMATCH" : (faster ? "ok" : "SLOWER"));
+    }
+  }
+
+  // Gradients against exact interpolation, including the end points and
+  // multiple stops
+  bool gradientOk = true;
+  VibeLED leds(1, 2, 3, numLeds);
+  leds.begin();
+  Color from(255, 10, 0);
+  Color to(0, 90, 255);
+  for (uint16_t span = 0; span < numLeds; span = span * 3 + 1) {
+    leds.fillGradient(0, span, from, to);
+    for (uint16_t i = 0; i <= span; i++) {
+      Color color = leds.getLEDColor(i);
+      if (abs(color.r - exact(from.r, to.r, i, span)) > 1 ||
+          abs(color.g - exact(from.g, to.g, i, span)) > 1 ||
+          abs(color.b - exact(from.b, to.b, i, span)) > 1) {
+        gradientOk = false;
+      }
+    }
+    Color end = leds.getLEDColor(span);
+    if (span > 0 && (end.r != to.r || end.g != to.g || end.b != to.b)) gradientOk = false;
+  }
+
+  Color stops[3] = { Color(255, 0, 0), Color(0, 255, 0), Color(0, 0, 255) };
+  leds.fillGradient(0, numLeds - 1, stops, 3);
+  uint16_t middle = (numLeds - 1) / 2;
+  Color mid = leds.getLEDColor(middle);
+  Color last = leds.getLEDColor(numLeds - 1);
+  if (mid.g != 255 || last.b != 255 || leds.getLEDColor(0).r != 255) gradientOk = false;
+
+  printf("\n%-14s %48s\n", "gradient", gradientOk ? "ok" : "FAIL");
+  if (!gradientOk) failures++;
+
+  delete[] rgb;
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+/*
+  SyncSim.cpp - Host simulation of synchronized VibeLED playback.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Simulates N controllers whose clocks have random offsets and skew. The
+  master broadcasts sync messages with a fixed latency plus random jitter and
+  packet loss; every follower runs VibeLEDSync and renders with a shared
+  timebase. Followers stall now and then for up to a dozen frames, as a
+  sketch busy with something else would. Reports the phase error against the
+  master clock, whether any follower's shared time ran backwards, and how
+  many rendered frames are identical to the master's for a random effect
+  (sparkle), an effect that keeps state from step to step (meteor, whose
+  trail fades from the previous frame) and a per-pixel effect (rainbow).
+  Exits with status 1 if shared time ran backwards.
+
+  Usage: SyncSim [nodes] [skew_ppm] [jitter_us] [loss_percent] [seconds]
+*/
+
+#include <vector>
+
+#include "Arduino.h"
+#include "VibeLED.h"
+#include "VibeLEDSync.h"
+
+// The simulation calls VibeLEDSync::receive() directly with simulated times
+class NullTransport : public VibeLEDSyncTransport {
+  public:
+    void send(const uint8_t*, uint8_t) {}
+    uint8_t receive(uint8_t*, uint8_t) { return 0; }
+};
+
+struct SimEffect {
+  const char* name;
+  EffectType effect;
+};
+
+const SimEffect effects[] = {
+  { "sparkle", EFFECT_SPARKLE },
+  { "meteor", EFFECT_METEOR },
+  { "rainbow", EFFECT_RAINBOW }
+};
+const int numEffects = sizeof(effects) / sizeof(effects[0]);
+
+struct Node {
+  double offset;   // Local clock offset (microseconds)
+  double rate;     // Local clock rate (1 + skew)
+  VibeLEDSync* sync;
+  VibeLED* leds[numEffects];
+  uint64_t stallUntil;            // True time the current stall ends
+  uint64_t lastShared;
+  uint64_t backwards;             // Conversions that went back in shared time
+  std::vector<uint64_t> pending;  // True arrival times of in-flight messages
+  std::vector<uint64_t> payload;  // Master times carried by those messages
+  std::vector<uint8_t> sequence;  // Sequence numbers of those messages
+  double errorSum;
+  double errorMax;
+  uint64_t samples;
+
+  uint64_t local(uint64_t trueTime) { return (uint64_t)(offset + trueTime * rate); }
+};
+
+static double uniform() {
+  return random(1000000) / 1000000.0;
+}
+
+static bool sameFrame(VibeLED& a, VibeLED& b) {
+  for (uint16_t i = 0; i < a.getNumLeds(); i++) {
+    Color x = a.getLEDColor(i);
+    Color y = b.getLEDColor(i);
+    if (x.r != y.r || x.g != y.g || x.b != y.b) return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int numNodes = (argc > 1) ? atoi(argv[1]) : 20;
+  double skewPpm = (argc > 2) ? atof(argv[2]) : 100.0;
+  double jitter = (argc > 3) ? atof(argv[3]) : 2000.0;
+  double loss = (argc > 4) ? atof(argv[4]) : 5.0;
+  int seconds = (argc > 5) ? atoi(argv[5]) : 600;
+
+  const uint16_t latency = 500;            // Fixed transport delay (us)
+  const uint64_t interval = 1000000;       // Sync interval (us)
+  const uint64_t tick = 997;               // Simulation step (us), not aligned to frames
+  const double stallChance = 0.0005;       // Per step: a stall about every 2 s
+  const uint64_t maxStall = 250000;        // Up to 12 frames of 20 ms
+
+  // Ignore the first 30 s while the followers lock, or the first quarter of shorter runs
+  const uint64_t warmup = min((uint64_t)30000000, (uint64_t)seconds * 1000000 / 4);
+
+  randomSeed(12345);
+  NullTransport transport;
+
+  // Node 0 is the master; its local clock defines shared time
+  std::vector<Node> nodes(numNodes);
+  for (int i = 0; i < numNodes; i++) {
+    Node& node = nodes[i];
+    node.offset = (i == 0) ? 0 : uniform() * 3600e6;
+    node.rate = 1.0 + ((i == 0) ? 0 : (uniform() * 2 - 1) * skewPpm * 1e-6);
+    node.sync = new VibeLEDSync(transport, i == 0);
+    node.sync->setLatency(latency);
+    for (int e = 0; e < numEffects; e++) {
+      node.leds[e] = new VibeLED(9, 10, 11, 60);
+      node.leds[e]->begin();
+      node.leds[e]->setEffect(effects[e].effect, 20, Color(255, 160, 40));
+      node.leds[e]->setTimebase(0, 0xC0FFEE);
+    }
+    node.stallUntil = 0;
+    node.lastShared = 0;
+    node.backwards = 0;
+    node.errorSum = 0;
+    node.errorMax = 0;
+    node.samples = 0;
+  }
+
+  uint64_t frames = 0;
+  uint64_t identical[numEffects] = { 0 };
+  uint8_t sequence = 0;
+  uint64_t nextBroadcast = 0;
+
+  for (uint64_t t = 0; t < (uint64_t)seconds * 1000000; t += tick) {
+    // Master broadcast
+    if (t >= nextBroadcast) {
+      nextBroadcast += interval;
+      uint64_t masterTime = nodes[0].local(t);
+      for (int i = 1; i < numNodes; i++) {
+        if (uniform() * 100 < loss) continue;
+        nodes[i].pending.push_back(t + latency + (uint64_t)(uniform() * jitter));
+        nodes[i].payload.push_back(masterTime);
+        nodes[i].sequence.push_back(sequence);
+      }
+      sequence++;
+    }
+
+    uint64_t masterShared = nodes[0].local(t);
+    for (int e = 0; e < numEffects; e++) {
+      nodes[0].leds[e]->update((unsigned long)(masterShared / 1000));
+    }
+
+    for (int i = 1; i < numNodes; i++) {
+      Node& node = nodes[i];
+
+      // Deliver messages that have arrived (the simulation step bounds timestamp precision)
+      for (size_t m = 0; m < node.pending.size();) {
+        if (node.pending[m] <= t) {
+          uint8_t message[VIBELED_SYNC_MESSAGE_SIZE];
+          VibeLEDSync::encode(node.sequence[m], node.payload[m], message);
+          node.sync->receive(message, sizeof(message), node.local(node.pending[m]));
+          node.pending.erase(node.pending.begin() + m);
+          node.payload.erase(node.payload.begin() + m);
+          node.sequence.erase(node.sequence.begin() + m);
+        } else {
+          m++;
+        }
+      }
+
+      if (!node.sync->isLocked()) continue;
+
+      // A stalled sketch neither reads the clock nor renders
+      if (t < node.stallUntil) continue;
+      if (uniform() < stallChance) {
+        node.stallUntil = t + (uint64_t)(uniform() * maxStall);
+        continue;
+      }
+
+      uint64_t shared = node.sync->toShared(node.local(t));
+      if (shared < node.lastShared) node.backwards++;
+      node.lastShared = shared;
+      for (int e = 0; e < numEffects; e++) {
+        node.leds[e]->update((unsigned long)(shared / 1000));
+      }
+
+      if (t >= warmup) {
+        double error = fabs((double)(int64_t)(shared - masterShared));
+        node.errorSum += error;
+        if (error > node.errorMax) node.errorMax = error;
+        node.samples++;
+
+        frames++;
+        for (int e = 0; e < numEffects; e++) {
+          if (sameFrame(*node.leds[e], *nodes[0].leds[e])) identical[e]++;
+        }
+      }
+    }
+  }
+
+  double worst = 0;
+  double total = 0;
+  uint64_t samples = 0;
+  uint64_t backwards = 0;
+  printf("node  skew_ppm  est_ppm  mean_err_us  max_err_us\n");
+  for (int i = 1; i < numNodes; i++) {
+    Node& node = nodes[i];
+    SyncStats stats = node.sync->getStats();
+    printf("%4d  %8.1f  %7d  %11.1f  %10.1f\n", i, (node.rate - 1.0) * 1e6, (int)-stats.skew,
+           node.samples ? node.errorSum / node.samples : 0.0, node.errorMax);
+    if (node.errorMax > worst) worst = node.errorMax;
+    total += node.errorSum;
+    samples += node.samples;
+    backwards += node.backwards;
+  }
+
+  printf("\nnodes=%d skew=+-%.0fppm jitter=%.0fus loss=%.0f%% duration=%ds warmup=%.1fs\n", numNodes,
+         skewPpm, jitter, loss, seconds, warmup / 1e6);
+  if (samples == 0) {
+    printf("no samples after warmup\n");
+    return 1;
+  }
+  printf("phase error: mean %.1f us, max %.1f us\n", total / samples, worst);
+  printf("shared time ran backwards: %llu times\n", (unsigned long long)backwards);
+  printf("identical frames:");
+  for (int e = 0; e < numEffects; e++) {
+    printf("%s %s %.3f%%", e ? "," : "", effects[e].name, 100.0 * identical[e] / frames);
+  }
+  printf("\n");
+  return backwards ? 1 : 0;
+}
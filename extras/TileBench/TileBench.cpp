@@ -0,0 +1,118 @@
+/*
+  TileBench.cpp - Scaling benchmark for VibeLEDTileRenderer.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Renders each effect on a large strip with 1 to N threads and reports the
+  time per frame and the speedup over one thread. Every run is also
+  compared frame by frame with plain VibeLED rendering, including the
+  power estimate, so any difference between thread counts is reported.
+  Stateful effects (fire) are included to show the serial fallback.
+
+  Usage: TileBench [leds] [frames] [max_threads] [tile_size]
+*/
+
+#include <thread>
+
+#include "HostTest.h"
+#include "VibeLEDTiles.h"
+
+struct Config {
+  const char* name;
+  EffectType effect;
+  bool highPrecision;
+  bool powerLimit;
+  bool group;
+};
+
+const Config configs[] = {
+  { "wave", EFFECT_WAVE, false, false, false },
+  { "rainbow", EFFECT_RAINBOW, false, false, false },
+  { "breathe", EFFECT_BREATHE, false, false, false },
+  { "breathe/16", EFFECT_BREATHE, true, false, false },
+  { "marquee", EFFECT_MARQUEE, false, false, false },
+  { "twinkle", EFFECT_TWINKLE, false, false, false },
+  { "gradient/16", EFFECT_GRADIENT, true, false, false },
+  { "wave/power", EFFECT_WAVE, false, true, false },
+  { "rainbow/group", EFFECT_RAINBOW, false, false, true },
+  { "fire", EFFECT_FIRE, false, false, false }
+};
+
+static void setup(VibeLED& leds, const Config& config) {
+  uint16_t numLeds = leds.getNumLeds();
+
+  leds.setHighPrecision(config.highPrecision);
+  leds.begin();
+  leds.setEffect(config.effect, 20, 255, 120, 40);
+  leds.setTimebase(0, 7);
+  if (config.powerLimit) leds.setPowerLimit(numLeds * 10);
+  if (config.group) leds.setGroup(numLeds / 7, numLeds - numLeds / 5);
+}
+
+// Render all frames and return the time per frame in nanoseconds. 0 threads
+// renders with VibeLED alone (the reference).
+static double run(const Config& config, uint16_t numLeds, uint32_t frames, uint8_t threads,
+                  uint16_t tileSize, uint32_t& hash) {
+  VibeLED leds(1, 2, 3, numLeds);
+  setup(leds, config);
+  VibeLEDTileRenderer tiles(leds, max(threads, 1), tileSize);
+
+  uint8_t* frame = new uint8_t[numLeds * 3];
+  double renderTime = 0;
+  hash = FNV_OFFSET;
+
+  for (uint32_t f = 1; f <= frames; f++) {
+    double start = nowNs();
+    if (threads == 0) {
+      leds.render(f * 20);
+    } else {
+      tiles.render(f * 20);
+    }
+    renderTime += nowNs() - start;
+
+    leds.encode(frame);
+    hash = fnv(hash, frame, numLeds * 3);
+    uint8_t brightness = leds.getOutputBrightness();
+    hash = fnv(hash, &brightness, 1);
+  }
+
+  delete[] frame;
+  return renderTime / frames;
+}
+
+int main(int argc, char** argv) {
+  uint16_t numLeds = (argc > 1) ? atoi(argv[1]) : 60000;
+  uint32_t frames = (argc > 2) ? atoi(argv[2]) : 200;
+  unsigned cores = std::thread::hardware_concurrency();
+  uint8_t maxThreads = (argc > 3) ? atoi(argv[3]) : max(cores, 4u);
+  uint16_t tileSize = (argc > 4) ? atoi(argv[4]) : VIBELED_TILE_SIZE;
+  int failures = 0;
+
+  printf("%u LEDs, %u frames, tiles of %u LEDs, %u cores\n\n", numLeds, frames, tileSize, cores);
+  printf("%-14s %8s", "effect", "plain_us");
+  for (uint8_t t = 1; t <= maxThreads; t++) printf("  %2ut_us speedup", t);
+  printf("  check\n");
+
+  for (const Config& config : configs) {
+    uint32_t expected;
+    double plain = run(config, numLeds, frames, 0, tileSize, expected);
+    printf("%-14s %8.1f", config.name, plain / 1000);
+
+    double single = 0;
+    bool ok = true;
+    for (uint8_t t = 1; t <= maxThreads; t++) {
+      uint32_t hash;
+      double time = run(config, numLeds, frames, t, tileSize, hash);
+      if (t == 1) single = time;
+      if (hash != expected) ok = false;
+      printf("  %6.1f %6.2fx", time / 1000, single / time);
+    }
+
+    if (!ok) failures++;
+    printf("  %s\n", ok ? "ok" : "MISMATCH");
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "all frames match");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+/*
+  VMBench.cpp - Compares VibeLEDVM programs with the native effect kernels.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Renders the same number of frames with each native effect and with the
+  equivalent program from extras/vmasm/examples, and reports the time per
+  frame and the slowdown. Programs that reproduce a native effect exactly
+  are also checked frame by frame. Then checks that the verifier rejects
+  jumps into operands, stack underflow and overflow, bad PARAM/LOAD/STORE
+  operands, truncated operands and programs over the frame cost limit, and
+  that a program of VIBELED_VM_MAX_PROGRAM bytes reports its full cost
+  (build with -DVIBELED_VM_MAX_PROGRAM=1024 to check long programs).
+
+  Usage: VMBench [leds] [frames]
+*/
+
+#include <vector>
+
+#include "HostTest.h"
+#include "VibeLEDVM.h"
+
+// Assembled with: vmasm.py examples/<name>.vmasm -n <name>Program
+const uint8_t staticProgram[7] = {
+  0x07, 0x00, 0x07, 0x01, 0x07, 0x02, 0x36
+};
+const uint8_t chaseProgram[22] = {
+  0x03, 0x05, 0x04, 0x14, 0x1E, 0x21, 0x08, 0x07, 0x00, 0x07, 0x01, 0x07,
+  0x02, 0x36, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x36
+};
+const uint8_t rainbowProgram[14] = {
+  0x03, 0x01, 0xFF, 0x12, 0x04, 0x13, 0x05, 0x10, 0x01, 0xFF, 0x01, 0xFF,
+  0x33, 0x36
+};
+const uint8_t waveProgram[28] = {
+  0x05, 0x01, 0x04, 0x12, 0x03, 0x01, 0x14, 0x12, 0x10, 0x30, 0x09, 0x00,
+  0x07, 0x00, 0x08, 0x00, 0x32, 0x07, 0x01, 0x08, 0x00, 0x32, 0x07, 0x02,
+  0x08, 0x00, 0x32, 0x36
+};
+const uint8_t sparkleProgram[33] = {
+  0x31, 0x01, 0x1A, 0x1C, 0x21, 0x08, 0x07, 0x00, 0x07, 0x01, 0x07, 0x02,
+  0x36, 0x00, 0x35, 0x09, 0x02, 0x09, 0x01, 0x01, 0xCC, 0x32, 0x08, 0x01,
+  0x01, 0xCC, 0x32, 0x08, 0x02, 0x01, 0xCC, 0x32, 0x36
+};
+
+struct Benchmark {
+  const char* name;
+  EffectType effect;
+  const uint8_t* program;
+  uint16_t length;
+  bool exact;  // Program reproduces the native effect bit for bit
+};
+
+const Benchmark benchmarks[] = {
+  { "static", EFFECT_STATIC, staticProgram, sizeof(staticProgram), true },
+  { "chase", EFFECT_CHASE, chaseProgram, sizeof(chaseProgram), true },
+  { "rainbow", EFFECT_RAINBOW, rainbowProgram, sizeof(rainbowProgram), true },
+  { "wave", EFFECT_WAVE, waveProgram, sizeof(waveProgram), false },
+  { "sparkle", EFFECT_SPARKLE, sparkleProgram, sizeof(sparkleProgram), false }
+};
+
+// Render frames and return the time per frame in nanoseconds
+static double run(VibeLED& leds, int frames) {
+  double start = nowNs();
+  for (int f = 0; f < frames; f++) {
+    leds.refresh(f);
+  }
+  return (nowNs() - start) / frames;
+}
+
+static int check(const char* name, bool ok) {
+  printf("%-44s %s\n", name, ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
+
+// Verify a program for a strip of numLeds and compare the result
+static int expect(const char* name, const std::vector<uint8_t>& code, VMError expected,
+                  uint16_t numLeds = 60) {
+  VibeLED leds(9, 10, 11, numLeds);
+  VibeLEDVM vm(leds);
+  return check(name, vm.verify(code.data(), code.size()) == expected);
+}
+
+// Programs the verifier must reject, and the limits it must accept
+static int verifier() {
+  int failures = 0;
+
+  // JMP skips one byte and lands on the operand of the PUSH8 behind it
+  failures += expect("jump into an operand", { OP_JMP, 1, OP_PUSH8, OP_STEP, OP_DROP }, VM_ERR_JUMP);
+  failures += expect("jump past the end", { OP_JMP, 2, OP_STEP }, VM_ERR_JUMP);
+  failures += expect("unknown opcode", { OP_STEP, 0xEE }, VM_ERR_OPCODE);
+
+  failures += expect("stack underflow", { OP_PUSH8, 1, OP_ADD }, VM_ERR_STACK);
+  failures += expect("stack underflow at OUT", { OP_INDEX, OP_INDEX, OP_OUT }, VM_ERR_STACK);
+  std::vector<uint8_t> deep(VIBELED_VM_STACK, OP_INDEX);
+  failures += expect("full stack accepted", deep, VM_OK);
+  deep.push_back(OP_INDEX);
+  failures += expect("stack overflow", deep, VM_ERR_STACK);
+  // JZ joins a path with one more value on the stack
+  failures += expect("stack mismatch where paths join",
+                     { OP_INDEX, OP_JZ, 1, OP_INDEX, OP_END }, VM_ERR_STACK);
+
+  failures += expect("PARAM past the last parameter", { OP_PARAM, PARAM_COUNT, OP_DROP },
+                     VM_ERR_OPERAND);
+  failures += expect("LOAD past the last variable", { OP_LOAD, VIBELED_VM_VARS, OP_DROP },
+                     VM_ERR_OPERAND);
+  failures += expect("STORE past the last variable", { OP_INDEX, OP_STORE, VIBELED_VM_VARS },
+                     VM_ERR_OPERAND);
+
+  failures += expect("truncated PUSH16", { OP_PUSH16, 0x01 }, VM_ERR_LENGTH);
+  failures += expect("truncated PUSH8", { OP_PUSH8 }, VM_ERR_LENGTH);
+  failures += expect("empty program", {}, VM_ERR_LENGTH);
+
+  // 100 instructions per LED: 300 LEDs fit VIBELED_VM_MAX_FRAME_OPS, 400 do not
+  std::vector<uint8_t> costly;
+  for (int i = 0; i < 50; i++) {
+    costly.push_back(OP_INDEX);
+    costly.push_back(OP_DROP);
+  }
+  failures += expect("cost limit met", costly, VM_OK, VIBELED_VM_MAX_FRAME_OPS / 100);
+  failures += expect("cost limit overrun", costly, VM_ERR_COST, VIBELED_VM_MAX_FRAME_OPS / 100 + 1);
+
+  // The longest program allowed, one instruction per byte
+  std::vector<uint8_t> longest;
+  for (int i = 0; i < VIBELED_VM_MAX_PROGRAM / 2; i++) {
+    longest.push_back(OP_INDEX);
+    longest.push_back(OP_DROP);
+  }
+  VibeLED leds(9, 10, 11, 1);
+  VibeLEDVM vm(leds);
+  uint16_t cost = 0;
+  VMError error = vm.verify(longest.data(), longest.size(), &cost);
+  failures += check("cost of the longest program", error == VM_OK && cost == longest.size());
+  longest.push_back(OP_END);
+  failures += expect("program over VIBELED_VM_MAX_PROGRAM", longest, VM_ERR_LENGTH, 1);
+
+  return failures;
+}
+
+int main(int argc, char** argv) {
+  int numLeds = (argc > 1) ? atoi(argv[1]) : 300;
+  int frames = (argc > 2) ? atoi(argv[2]) : 2000;
+  int failures = 0;
+
+  printf("%d LEDs, %d frames\n\n", numLeds, frames);
+  printf("effect    native_us  vm_us  ratio  cost  check\n");
+
+  for (const Benchmark& bench : benchmarks) {
+    VibeLED native(9, 10, 11, numLeds);
+    VibeLED interpreted(9, 10, 11, numLeds);
+    VibeLEDVM vm(interpreted);
+
+    native.begin();
+    interpreted.begin();
+    native.setEffect(bench.effect, 10, Color(255, 120, 30));
+    interpreted.setEffect(bench.effect, 10, Color(255, 120, 30));
+
+    VMError error = vm.load(bench.program, bench.length);
+    if (error != VM_OK) {
+      printf("%-8s  program rejected (error %d)\n", bench.name, error);
+      failures++;
+      continue;
+    }
+    vm.start();
+
+    // Correctness: identical frames for the exact ports
+    const char* check = "-";
+    if (bench.exact) {
+      check = "ok";
+      for (int f = 0; f < 300 && strcmp(check, "ok") == 0; f++) {
+        native.refresh(f);
+        interpreted.refresh(f);
+        for (int i = 0; i < numLeds; i++) {
+          Color a = native.getLEDColor(i);
+          Color b = interpreted.getLEDColor(i);
+          if (a.r != b.r || a.g != b.g || a.b != b.b) {
+            check = "MISMATCH";
+            failures++;
+            break;
+          }
+        }
+      }
+    }
+
+    double nativeNs = run(native, frames);
+    double vmNs = run(interpreted, frames);
+    printf("%-8s  %9.1f  %5.1f  %5.1fx  %4u  %s\n", bench.name, nativeNs / 1000, vmNs / 1000,
+           vmNs / nativeNs, vm.getStats().cost, check);
+  }
+
+  printf("\nverifier (VIBELED_VM_MAX_PROGRAM %d)\n", VIBELED_VM_MAX_PROGRAM);
+  failures += verifier();
+
+  printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+/*
+  Arduino.cpp - Minimal Arduino core for building VibeLED on a desktop host.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+*/
+
+#include "Arduino.h"
+
+static thread_local uint64_t hostClock = 0;
+static thread_local uint32_t hostRandom = 1;
+static thread_local uint32_t hostWrites = 0;
+static thread_local uint8_t hostPins[256];
+static thread_local uint32_t hostPinCost = 0;
+static thread_local uint32_t hostPinNanos = 0;
+
+// Time (simulated)
+unsigned long millis() { return (unsigned long)(hostClock / 1000); }
+unsigned long micros() { return (unsigned long)hostClock; }
+void delay(unsigned long ms) { hostClock += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { hostClock += us; }
+void hostSetMicros(uint64_t us) { hostClock = us; }
+void hostAdvanceMicros(uint64_t us) { hostClock += us; }
+uint64_t hostMicros() { return hostClock; }
+
+// Pins (recorded)
+static void hostChargePin() {
+  hostPinNanos += hostPinCost;
+  hostClock += hostPinNanos / 1000;
+  hostPinNanos %= 1000;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t value) { hostPins[pin] = value; hostWrites++; hostChargePin(); }
+int digitalRead(uint8_t pin) { return hostPins[pin]; }
+void analogWrite(uint8_t pin, int value) { hostPins[pin] = (uint8_t)value; hostWrites++; hostChargePin(); }
+int analogRead(uint8_t) { return 512; }
+uint32_t hostPinWrites() { return hostWrites; }
+void hostSetPinCost(uint32_t nanoseconds) { hostPinCost = nanoseconds; hostPinNanos = 0; }
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t value) {
+  for (uint8_t i = 0; i < 8; i++) {
+    uint8_t bit = (bitOrder == LSBFIRST) ? (value >> i) & 1 : (value >> (7 - i)) & 1;
+    digitalWrite(dataPin, bit);
+    digitalWrite(clockPin, HIGH);
+    digitalWrite(clockPin, LOW);
+  }
+}
+
+// Math (xorshift32, deterministic for a given seed)
+long random(long howBig) {
+  if (howBig <= 0) return 0;
+  hostRandom ^= hostRandom << 13;
+  hostRandom ^= hostRandom >> 17;
+  hostRandom ^= hostRandom << 5;
+  return (long)(hostRandom % (uint32_t)howBig);
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) return howSmall;
+  return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) hostRandom = (uint32_t)seed;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
@@ -0,0 +1,137 @@
+/*
+  Arduino.h - Minimal Arduino core for building VibeLED on a desktop host.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Only what the library uses is provided. Time is simulated and advanced
+  explicitly with hostSetMicros()/hostAdvanceMicros(); the clock and the
+  random number generator are per thread, so independent jobs can run in
+  parallel. Pin writes are recorded so tools can inspect them, and can be
+  charged simulated time with hostSetPinCost().
+*/
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+// Program memory is ordinary memory on the host
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcasecmp_P strcasecmp
+
+// Same macro semantics as the AVR core (mixed argument types are allowed)
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define noInterrupts()
+#define interrupts()
+
+// Time (simulated)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void hostSetMicros(uint64_t us);
+void hostAdvanceMicros(uint64_t us);
+uint64_t hostMicros();
+
+// Pins (recorded)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+int analogRead(uint8_t pin);
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t value);
+uint32_t hostPinWrites();
+void hostSetPinCost(uint32_t nanoseconds);  // Clock advance per digitalWrite()/analogWrite()
+
+// Math
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t data) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+      for (size_t i = 0; i < size; i++) write(buffer[i]);
+      return size;
+    }
+    size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t print(long value) { char text[24]; snprintf(text, sizeof(text), "%ld", value); return print(text); }
+    size_t println(const char* text) { return print(text) + print("\n"); }
+    size_t println(long value) { return print(value) + print("\n"); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+class String {
+  public:
+    String(const char* text = "") {
+      _length = strlen(text);
+      _text = (char*)malloc(_length + 1);
+      memcpy(_text, text, _length + 1);
+    }
+    String(const String& other) : String(other._text) {}
+    ~String() { free(_text); }
+    String& operator=(const String& other) {
+      if (this != &other) {
+        free(_text);
+        _length = other._length;
+        _text = (char*)malloc(_length + 1);
+        memcpy(_text, other._text, _length + 1);
+      }
+      return *this;
+    }
+    bool equalsIgnoreCase(const String& other) const { return strcasecmp(_text, other._text) == 0; }
+    const char* c_str() const { return _text; }
+    unsigned int length() const { return _length; }
+
+  private:
+    char* _text;
+    size_t _length;
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*
+  HostTest.h - Shared helpers for the VibeLED host tools.
+  Created by SKR Electronics Lab, 2025.
+  Released under the MIT License.
+  https://github.com/skr-electronics-lab
+
+  Frame hashing, wall clock timing and the tools' common effect setup.
+  Include it before Arduino.h, whose min() and max() macros would break
+  the standard headers it needs.
+*/
+
+#ifndef HostTest_h
+#define HostTest_h
+
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "VibeLED.h"
+
+const uint32_t FNV_OFFSET = 2166136261UL;
+
+// FNV-1a hash of data, continuing from hash (FNV_OFFSET to start)
+inline uint32_t fnv(uint32_t hash, const uint8_t* data, uint32_t length) {
+  for (uint32_t i = 0; i < length; i++) {
+    hash = (hash ^ data[i]) * 16777619UL;
+  }
+  return hash;
+}
+
+// Hash of the strip's encoded output frame
+inline uint32_t hashFrame(VibeLED& leds) {
+  std::vector<uint8_t> frame(leds.getNumLeds() * leds.getBytesPerLed());
+  leds.encode(frame.data());
+  return fnv(FNV_OFFSET, frame.data(), frame.size());
+}
+
+// Wall clock time in nanoseconds (for benchmarks; the simulated clock does not move)
+inline double nowNs() {
+  return std::chrono::duration<double, std::nano>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct EffectTest {
+  const char* name;
+  EffectType effect;
+};
+
+// Effects with state, randomness and timing of every kind
+const EffectTest effectTests[] = {
+  { "static", EFFECT_STATIC }, { "breathe", EFFECT_BREATHE }, { "fade_in", EFFECT_FADE_IN },
+  { "knight_rider", EFFECT_KNIGHT_RIDER }, { "meteor", EFFECT_METEOR }, { "fire", EFFECT_FIRE },
+  { "waterfall", EFFECT_WATERFALL }, { "stack", EFFECT_STACK }, { "rainbow", EFFECT_RAINBOW },
+  { "sparkle", EFFECT_SPARKLE }, { "bounce", EFFECT_BOUNCE }, { "color_wipe", EFFECT_COLOR_WIPE },
+  { "snake", EFFECT_SNAKE }, { "twinkle", EFFECT_TWINKLE },
+  { "fire_flicker_soft", EFFECT_FIRE_FLICKER_SOFT }, { "gradient", EFFECT_GRADIENT }
+};
+
+// Set an effect with the tools' common parameters (20 ms steps, orange)
+inline void setTestEffect(VibeLED& leds, EffectType effect) {
+  EffectParams params;
+  params.speed = 20;
+  params.color1 = Color(255, 120, 30);
+  leds.setEffect(effect, params);
+}
+
+#endif
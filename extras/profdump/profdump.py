@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""
+profdump.py - Decoder for VibeLEDProfile dumps.
+Created by SKR Electronics Lab, 2025.
+Released under the MIT License.
+https://github.com/skr-electronics-lab
+
+Reads the binary output of VibeLEDProfile.dump() and prints the frame and
+allocation counters and, for every effect, the render (_updateEffect())
+and output (_applyStates()) times in microseconds: count, min, average,
+p99 (estimated from the log2 histogram) and max. The input may be a raw
+serial capture; every valid dump found in it is decoded.
+
+Usage:
+    profdump.py capture.bin                  table for every dump
+    profdump.py capture.bin --histogram      also print the buckets
+    profdump.py capture.bin --header VibeLED.h
+                                             effect names from this header
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+MAGIC = b"VLPF"
+VERSION = 1
+OTHER = 0xFF
+
+
+class DumpError(Exception):
+    pass
+
+
+def effect_names(header):
+    """EffectType values from VibeLED.h: id -> lower case name"""
+    names = {}
+    if header and os.path.exists(header):
+        with open(header) as f:
+            for name, value in re.findall(r"EFFECT_(\w+)\s*=\s*(\d+)", f.read()):
+                names[int(value)] = name.lower()
+    names[OTHER] = "(other)"
+    return names
+
+
+class Reader:
+    def __init__(self, data, offset):
+        self.data = data
+        self.offset = offset
+
+    def read(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.offset + size > len(self.data):
+            raise DumpError("truncated dump")
+        values = struct.unpack_from(fmt, self.data, self.offset)
+        self.offset += size
+        return values
+
+
+def read_section(reader, buckets):
+    count, low, high, total_low, total_high = reader.read("<5I")
+    histogram = list(reader.read("<%dH" % buckets))
+    return {"count": count, "min": low, "max": high,
+            "total": total_low | (total_high << 32), "buckets": histogram}
+
+
+def parse(data, offset):
+    """Parse one dump starting at the magic; returns (dump, end offset)"""
+    reader = Reader(data, offset + len(MAGIC))
+    version, buckets, slots, ticks_per_us = reader.read("<BBBH")
+    if version != VERSION:
+        raise DumpError("unsupported version %d" % version)
+
+    counters = dict(zip(("frames", "late_frames", "skipped_pushes", "allocations",
+                         "allocated_bytes", "frame_allocations"), reader.read("<6I")))
+    effects = []
+    for _ in range(slots):
+        effect = reader.read("<B")[0]
+        render = read_section(reader, buckets)
+        output = read_section(reader, buckets)
+        effects.append((effect, render, output))
+
+    end = reader.offset
+    checksum = reader.read("<H")[0]
+    if checksum != sum(data[offset + len(MAGIC):end]) & 0xFFFF:
+        raise DumpError("checksum mismatch")
+
+    dump = {"ticks_per_us": max(ticks_per_us, 1), "counters": counters, "effects": effects}
+    return dump, reader.offset
+
+
+def percentile(section, fraction):
+    """Estimate a percentile in ticks by interpolating inside its bucket"""
+    histogram = section["buckets"]
+    total = sum(histogram)
+    if total == 0:
+        return 0
+    target = fraction * total
+    seen = 0
+    for bucket, count in enumerate(histogram):
+        if count and seen + count >= target:
+            low = 0 if bucket == 0 else 1 << (bucket - 1)
+            high = section["max"] if bucket == len(histogram) - 1 else (1 << bucket) - 1
+            value = low + (high - low) * (target - seen) / count
+            return min(max(value, section["min"]), section["max"])
+        seen += count
+    return section["max"]
+
+
+def report(dump, names, histogram):
+    scale = float(dump["ticks_per_us"])
+    counters = dump["counters"]
+    print("frames %(frames)d, late %(late_frames)d, skipped pushes %(skipped_pushes)d" % counters)
+    print("allocations %(allocations)d (%(allocated_bytes)d bytes), "
+          "%(frame_allocations)d after the first frame" % counters)
+    print("%d ticks per microsecond\n" % dump["ticks_per_us"])
+
+    print("%-20s %-7s %9s %10s %10s %10s %10s" % ("effect", "path", "count", "min_us", "avg_us",
+                                                   "p99_us", "max_us"))
+    for effect, render, output in dump["effects"]:
+        name = names.get(effect, "effect %d" % effect)
+        for path, section in (("render", render), ("output", output)):
+            if section["count"] == 0:
+                continue
+            average = section["total"] / float(section["count"])
+            print("%-20s %-7s %9d %10.2f %10.2f %10.2f %10.2f" % (
+                name, path, section["count"], section["min"] / scale, average / scale,
+                percentile(section, 0.99) / scale, section["max"] / scale))
+            if histogram:
+                for bucket, count in enumerate(section["buckets"]):
+                    if count:
+                        high = (1 << bucket) / scale
+                        print("%31s < %10.2f us %9d" % ("", high, count))
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Decode VibeLEDProfile dumps")
+    parser.add_argument("input", help="binary dump or serial capture ('-' for stdin)")
+    parser.add_argument("--header", default=os.path.join(here, "..", "..", "VibeLED.h"),
+                        help="VibeLED.h for effect names")
+    parser.add_argument("--histogram", action="store_true", help="print the buckets too")
+    options = parser.parse_args()
+
+    if options.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(options.input, "rb") as f:
+            data = f.read()
+
+    names = effect_names(options.header)
+    found = 0
+    offset = data.find(MAGIC)
+    while offset >= 0:
+        try:
+            dump, end = parse(data, offset)
+        except DumpError as error:
+            print("skipping dump at byte %d: %s" % (offset, error), file=sys.stderr)
+            offset = data.find(MAGIC, offset + 1)
+            continue
+        if found:
+            print()
+        report(dump, names, options.histogram)
+        found += 1
+        offset = data.find(MAGIC, end)
+
+    if not found:
+        sys.exit("no profile dump found in %s" % options.input)
+
+
+if __name__ == "__main__":
+    main()
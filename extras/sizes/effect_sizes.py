@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+effect_sizes.py - Flash and RAM cost of each built-in effect.
+Created by SKR Electronics Lab, 2025.
+Released under the MIT License.
+https://github.com/skr-electronics-lab
+
+Builds a small sketch once with no effects selected (VIBELED_SELECT_EFFECTS
+alone), once for every effect on its own and once with all effects, and
+prints each build's flash and RAM use and its difference to the empty
+build. The effect list is read from VibeLEDConfig.h.
+
+The host build uses the desktop Arduino core in extras/host, g++ with
+section garbage collection and `size`: text is reported as flash and
+data + bss as RAM. The cross build compiles the same sketch for a real
+board with arduino-cli and reports what the Arduino IDE prints ("Sketch
+uses" and "Global variables use"). Run from anywhere; paths are relative
+to this script.
+
+Usage:
+    effect_sizes.py                                   host build
+    effect_sizes.py --fqbn arduino:avr:uno            cross build
+    effect_sizes.py --fqbn esp32:esp32:esp32 --only fire,twinkle
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.normpath(os.path.join(HERE, "..", ".."))
+
+SKETCH = r"""
+#include "VibeLED.h"
+
+VibeLED leds(9, 10, 11, 30);
+
+void setup() {
+  leds.begin();
+  leds.setEffect(EFFECT_NAME);
+}
+
+void loop() {
+  leds.update();
+}
+"""
+
+HOST_MAIN = r"""
+int main() {
+  setup();
+  for (int i = 0; i < 100; i++) {
+    hostAdvanceMicros(10000);
+    loop();
+  }
+  return 0;
+}
+"""
+
+
+def effects():
+    """Effect names enabled by default in VibeLEDConfig.h"""
+    with open(os.path.join(ROOT, "VibeLEDConfig.h")) as f:
+        text = f.read()
+    block = text[text.index("#ifndef VIBELED_SELECT_EFFECTS"):]
+    block = block[:block.index("#endif")]
+    return [name.lower() for name in re.findall(r"#define VIBELED_USE_(\w+) 1", block)]
+
+
+def defines(selection):
+    flags = ["-DVIBELED_SELECT_EFFECTS"]
+    flags += ["-DVIBELED_USE_%s" % name.upper() for name in selection]
+    return flags
+
+
+def sketch(name):
+    return SKETCH.replace("EFFECT_NAME", '"%s"' % name)
+
+
+def host_size(selection, name, work):
+    """(flash, ram) of the host build"""
+    source = os.path.join(work, "main.cpp")
+    binary = os.path.join(work, "main")
+    with open(source, "w") as f:
+        f.write('#include "Arduino.h"\n' + sketch(name) + HOST_MAIN)
+
+    command = ["g++", "-std=c++11", "-Os", "-ffunction-sections", "-fdata-sections",
+               "-Wl,--gc-sections", "-I" + os.path.join(ROOT, "extras", "host"), "-I" + ROOT]
+    command += defines(selection)
+    command += [source, os.path.join(ROOT, "extras", "host", "Arduino.cpp"),
+                os.path.join(ROOT, "VibeLED.cpp"), os.path.join(ROOT, "VibeLEDNoise.cpp"),
+                "-o", binary]
+    subprocess.check_call(command)
+
+    output = subprocess.check_output(["size", binary]).decode()
+    text, data, bss = [int(value) for value in output.splitlines()[1].split()[:3]]
+    return text, data + bss
+
+
+def cross_size(selection, name, work, fqbn):
+    """(flash, ram) as reported by arduino-cli"""
+    folder = os.path.join(work, "EffectSize")
+    os.makedirs(folder, exist_ok=True)
+    with open(os.path.join(folder, "EffectSize.ino"), "w") as f:
+        f.write(sketch(name))
+
+    flags = " ".join(defines(selection))
+    command = ["arduino-cli", "compile", "--fqbn", fqbn, "--library", ROOT,
+               "--build-property", "compiler.cpp.extra_flags=" + flags,
+               "--build-property", "compiler.c.extra_flags=" + flags, folder]
+    output = subprocess.check_output(command, stderr=subprocess.STDOUT).decode()
+
+    flash = re.search(r"Sketch uses (\d+) bytes", output)
+    ram = re.search(r"Global variables use (\d+) bytes", output)
+    if not flash:
+        sys.exit("unexpected arduino-cli output:\n" + output)
+    return int(flash.group(1)), int(ram.group(1)) if ram else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flash and RAM cost of each VibeLED effect")
+    parser.add_argument("--fqbn", help="cross build for this board with arduino-cli")
+    parser.add_argument("--only", help="comma separated effects to measure")
+    options = parser.parse_args()
+
+    names = effects()
+    measured = options.only.split(",") if options.only else names
+    for name in measured:
+        if name not in names:
+            sys.exit("unknown effect '%s'" % name)
+
+    if options.fqbn and not shutil.which("arduino-cli"):
+        sys.exit("arduino-cli not found")
+
+    work = tempfile.mkdtemp(prefix="vibeled_sizes_")
+    try:
+        def size(selection, name):
+            if options.fqbn:
+                return cross_size(selection, name, work, options.fqbn)
+            return host_size(selection, name, work)
+
+        print("%s build\n" % (options.fqbn or "host"))
+        print("%-20s %9s %9s %9s %9s" % ("effect", "flash", "ram", "+flash", "+ram"))
+        base = size([], "none")
+        print("%-20s %9d %9d %9s %9s" % ("(none)", base[0], base[1], "", ""))
+        for name in measured:
+            flash, ram = size([name], name)
+            print("%-20s %9d %9d %+9d %+9d" % (name, flash, ram, flash - base[0], ram - base[1]))
+        flash, ram = size(names, "none")
+        print("%-20s %9d %9d %+9d %+9d" % ("(all)", flash, ram, flash - base[0], ram - base[1]))
+    finally:
+        shutil.rmtree(work)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""
+vmasm.py - Assembler for VibeLEDVM effect programs.
+Created by SKR Electronics Lab, 2025.
+Released under the MIT License.
+https://github.com/skr-electronics-lab
+
+Source format: one instruction per line, ';' starts a comment, 'name:'
+defines a label. Jumps take a label and may only jump forward.
+
+    ; rainbow: hue = index * 256 / count + step
+    index
+    push 256
+    mul
+    count
+    div
+    step
+    add
+    push 255    ; saturation
+    push 255    ; value
+    hsv
+    out
+
+'push' picks the 8 or 16-bit form; 'param' takes a VMParam name
+(color1_r ... option2, speed) or a number.
+
+Usage:
+    vmasm.py rainbow.vmasm                   C array on stdout
+    vmasm.py rainbow.vmasm -f hex            hex bytes
+    vmasm.py rainbow.vmasm -f frames -o up   protocol frames (CMD_VM_WRITE
+                                             chunks + CMD_VM_COMMIT) to send
+                                             over the control link
+"""
+
+import argparse
+import re
+import sys
+
+# Must match VMOpcode in VibeLEDVM.h: name -> (opcode, operand bytes)
+OPCODES = {
+    "end": (0x00, 0), "push8": (0x01, 1), "push16": (0x02, 2),
+    "index": (0x03, 0), "count": (0x04, 0), "step": (0x05, 0), "time": (0x06, 0),
+    "param": (0x07, 1), "load": (0x08, 1), "store": (0x09, 1),
+    "dup": (0x0A, 0), "drop": (0x0B, 0), "swap": (0x0C, 0), "over": (0x0D, 0),
+    "add": (0x10, 0), "sub": (0x11, 0), "mul": (0x12, 0), "div": (0x13, 0),
+    "mod": (0x14, 0), "and": (0x15, 0), "or": (0x16, 0), "xor": (0x17, 0),
+    "shl": (0x18, 0), "shr": (0x19, 0), "min": (0x1A, 0), "max": (0x1B, 0),
+    "lt": (0x1C, 0), "gt": (0x1D, 0), "eq": (0x1E, 0), "not": (0x1F, 0),
+    "jmp": (0x20, 1), "jz": (0x21, 1),
+    "sin8": (0x30, 0), "random8": (0x31, 0), "scale8": (0x32, 0), "hsv": (0x33, 0),
+    "blend": (0x34, 0), "get": (0x35, 0), "out": (0x36, 0),
+}
+
+# Must match VMParam in VibeLEDVM.h
+PARAMS = {
+    "color1_r": 0, "color1_g": 1, "color1_b": 2,
+    "color2_r": 3, "color2_g": 4, "color2_b": 5,
+    "option1": 6, "option2": 7, "speed": 8,
+}
+
+# Protocol constants (VibeLEDProtocol.h)
+SYNC = 0xA5
+CMD_VM_WRITE = 0x0B
+CMD_VM_COMMIT = 0x0C
+MAX_CHUNK = 62  # VIBELED_PROTOCOL_MAX_PAYLOAD minus the offset
+
+
+class AsmError(Exception):
+    pass
+
+
+def parse_number(text, line):
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise AsmError("line %d: bad number '%s'" % (line, text))
+
+
+def assemble(source):
+    # First pass: sizes and label addresses
+    items = []
+    labels = {}
+    address = 0
+
+    for line_number, raw in enumerate(source.splitlines(), 1):
+        text = raw.split(";", 1)[0].strip().lower()
+        if not text:
+            continue
+
+        match = re.match(r"^([a-z_][a-z0-9_]*):\s*(.*)$", text)
+        if match:
+            if match.group(1) in labels:
+                raise AsmError("line %d: duplicate label '%s'" % (line_number, match.group(1)))
+            labels[match.group(1)] = address
+            text = match.group(2)
+            if not text:
+                continue
+
+        parts = text.split()
+        name, args = parts[0], parts[1:]
+
+        if name == "push":
+            if len(args) != 1:
+                raise AsmError("line %d: push takes one value" % line_number)
+            value = parse_number(args[0], line_number)
+            if 0 <= value <= 255:
+                name = "push8"
+            elif -32768 <= value <= 32767:
+                name = "push16"
+            else:
+                raise AsmError("line %d: value out of range (-32768..32767)" % line_number)
+
+        if name not in OPCODES:
+            raise AsmError("line %d: unknown instruction '%s'" % (line_number, name))
+
+        opcode, size = OPCODES[name]
+        if len(args) != (1 if size else 0):
+            raise AsmError("line %d: '%s' takes %d operand(s)" % (line_number, name, 1 if size else 0))
+
+        items.append((line_number, address, name, opcode, size, args))
+        address += 1 + size
+
+    # Second pass: encode
+    code = bytearray()
+    for line_number, address, name, opcode, size, args in items:
+        code.append(opcode)
+        if size == 0:
+            continue
+
+        arg = args[0]
+        if name in ("jmp", "jz"):
+            if arg not in labels:
+                raise AsmError("line %d: unknown label '%s'" % (line_number, arg))
+            offset = labels[arg] - (address + 2)
+            if offset < 0:
+                raise AsmError("line %d: jumps must go forward" % line_number)
+            if offset > 255:
+                raise AsmError("line %d: jump too far" % line_number)
+            code.append(offset)
+        elif name == "param":
+            value = PARAMS[arg] if arg in PARAMS else parse_number(arg, line_number)
+            code.append(value & 0xFF)
+        elif name == "push16":
+            value = parse_number(arg, line_number) & 0xFFFF
+            code += bytes((value & 0xFF, value >> 8))
+        else:
+            value = parse_number(arg, line_number)
+            if not 0 <= value <= 255:
+                raise AsmError("line %d: operand out of range (0..255)" % line_number)
+            code.append(value)
+
+    return bytes(code)
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame(command, payload):
+    body = bytes((len(payload), command)) + payload
+    return bytes((SYNC,)) + body + bytes((crc8(body),))
+
+
+def upload_frames(code):
+    out = bytearray()
+    for offset in range(0, len(code), MAX_CHUNK):
+        chunk = code[offset:offset + MAX_CHUNK]
+        out += frame(CMD_VM_WRITE, bytes((offset & 0xFF, offset >> 8)) + chunk)
+    out += frame(CMD_VM_COMMIT, bytes((len(code) & 0xFF, len(code) >> 8)))
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Assemble a VibeLEDVM effect program")
+    parser.add_argument("source")
+    parser.add_argument("-f", "--format", choices=("c", "hex", "bin", "frames"), default="c")
+    parser.add_argument("-n", "--name", default="program", help="C array name")
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    options = parser.parse_args()
+
+    with open(options.source) as f:
+        try:
+            code = assemble(f.read())
+        except AsmError as error:
+            sys.exit("%s: %s" % (options.source, error))
+
+    if options.format == "c":
+        lines = ["const uint8_t %s[%d] = {" % (options.name, len(code))]
+        for i in range(0, len(code), 12):
+            lines.append("  " + ", ".join("0x%02X" % b for b in code[i:i + 12]) + ",")
+        lines[-1] = lines[-1].rstrip(",")
+        lines.append("};")
+        data = ("\n".join(lines) + "\n").encode()
+    elif options.format == "hex":
+        data = (" ".join("%02X" % b for b in code) + "\n").encode()
+    elif options.format == "bin":
+        data = code
+    else:
+        data = upload_frames(code)
+
+    if options.output:
+        with open(options.output, "wb") as f:
+            f.write(data)
+    else:
+        sys.stdout.buffer.write(data)
+
+    sys.stderr.write("%d bytes\n" % len(code))
+
+
+if __name__ == "__main__":
+    main()